@@ -0,0 +1,82 @@
+#include "arena.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+static size_t round_up(size_t v, size_t align)
+{
+    return (v + align - 1) & ~(align - 1);
+}
+
+int arena_init(Arena* a, size_t bytes, int pages)
+{
+    memset(a, 0, sizeof(*a));
+    size_t size = round_up(bytes ? bytes : 1, ARENA_HUGE_PAGE);
+    void* map = MAP_FAILED;
+    size_t map_size = size;
+    a->pages = ARENA_PAGES_NORMAL;
+
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    if (pages == ARENA_PAGES_HUGETLB)
+    {
+        // hugetlb mappings come back aligned to the huge page size
+        map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (map != MAP_FAILED)
+            a->pages = ARENA_PAGES_HUGETLB;
+        else
+            pages = ARENA_PAGES_THP;
+    }
+#endif
+    if (map == MAP_FAILED)
+    {
+        // one extra huge page of slack so the arena can start on a 2 MB boundary
+        map_size = size + (pages != ARENA_PAGES_NORMAL ? ARENA_HUGE_PAGE : 0);
+        map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (map == MAP_FAILED)
+            return 0;
+    }
+    a->map = map;
+    a->map_size = map_size;
+    a->base = (unsigned char*)round_up((uintptr_t)map, pages != ARENA_PAGES_NORMAL ? ARENA_HUGE_PAGE : 1);
+    a->size = size;
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (pages == ARENA_PAGES_THP && madvise(a->base, a->size, MADV_HUGEPAGE) == 0)
+        a->pages = ARENA_PAGES_THP;
+#endif
+    return 1;
+}
+
+void* arena_alloc(Arena* a, size_t bytes, size_t align)
+{
+    size_t at = round_up(a->used, align ? align : 1);
+    if (!a->base || at + bytes > a->size)
+        return NULL;
+    a->used = at + bytes;
+    return a->base + at;
+}
+
+void arena_free(Arena* a)
+{
+    if (a->map)
+        munmap(a->map, a->map_size);
+    memset(a, 0, sizeof(*a));
+}
+
+const char* arena_pages_name(int pages)
+{
+    switch (pages)
+    {
+    case ARENA_PAGES_THP:
+        return "thp";
+    case ARENA_PAGES_HUGETLB:
+        return "hugetlb";
+    default:
+        return "normal";
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stddef.h>
+
+// One anonymous mapping carved by a bump pointer.
+// Everything sized by the population lives in a single arena, so resizing the
+// population maps a fresh arena and unmaps the old one whole: no heap holes.
+// Pages are zero on first touch, like calloc.
+//
+// Page modes (Linux; elsewhere the arena always uses normal pages):
+//   ARENA_PAGES_THP      madvise(MADV_HUGEPAGE), the kernel backs 2 MB ranges
+//                        with huge pages when it can
+//   ARENA_PAGES_HUGETLB  MAP_HUGETLB from the reserved pool (vm.nr_hugepages),
+//                        falls back to THP when the pool is too small
+
+#define ARENA_PAGES_NORMAL  0
+#define ARENA_PAGES_THP     1
+#define ARENA_PAGES_HUGETLB 2
+
+#define ARENA_HUGE_PAGE ((size_t)2 << 20)
+
+typedef struct
+{
+    unsigned char* base;
+    size_t         size;
+    size_t         used;
+    int            pages; // mode actually obtained
+    void*          map;   // mapping as returned by mmap (base is aligned inside it)
+    size_t         map_size;
+} Arena;
+
+int   arena_init(Arena* a, size_t bytes, int pages);
+void* arena_alloc(Arena* a, size_t bytes, size_t align); // NULL when the arena is full
+void  arena_free(Arena* a);
+const char* arena_pages_name(int pages);
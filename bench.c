@@ -0,0 +1,222 @@
+#include "bench.h"
+#include "novelty.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int cmp_double(const void* a, const void* b)
+{
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// nearest rank on sorted values
+static double percentile(const double* v, int n, double pct)
+{
+    int k = (int)ceil(pct * n) - 1;
+    return v[k < 0 ? 0 : (k >= n ? n - 1 : k)];
+}
+
+static void stats(double* v, int n, BenchStats* out)
+{
+    memset(out, 0, sizeof(*out));
+    if (n < 1)
+        return;
+    qsort(v, (size_t)n, sizeof(double), cmp_double);
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i)
+        sum += v[i];
+    out->min = v[0];
+    out->p25 = percentile(v, n, 0.25);
+    out->median = percentile(v, n, 0.5);
+    out->p75 = percentile(v, n, 0.75);
+    out->max = v[n - 1];
+    out->mean = sum / n;
+}
+
+void bench_default_config(const GAContext* ga, BenchConfig* cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->seeds = 10;
+    cfg->first_seed = 1;
+    cfg->population = ga->population_size;
+    cfg->max_generations = 200;
+    cfg->target = ga->eval_duration * 0.5f; // upright half of the episode, as tune
+    cfg->dt = 1.f / 120.f;
+}
+
+// everything a run inherits from the interactive configuration
+static void copy_settings(const GAContext* ga, GAContext* run)
+{
+    ga_set_env(run, ga->track_left, ga->track_width, ga->pivot_y, ga->length, ga->base_k, ga->base_d, ga->gravity,
+               ga->damping, ga->max_speed_factor, ga->max_base_speed, ga->upright_threshold);
+    run->eval_duration = ga->eval_duration;
+    run->reward = ga->reward;
+    run->allow_remove_nodes = ga->allow_remove_nodes;
+    run->scheduler = ga->scheduler;
+    run->pin_threads = ga->pin_threads;
+    run->elite_fraction = ga->elite_fraction;
+    run->mutation_sigma = ga->mutation_sigma;
+    run->mutation_prob = ga->mutation_prob;
+    run->reward_bonus = ga->reward_bonus;
+    run->reward_drop = ga->reward_drop;
+    run->reward_effort = ga->reward_effort;
+    run->refine_elites = ga->refine_elites;
+    run->refine_iterations = ga->refine_iterations;
+    run->refine_step = ga->refine_step;
+    if (ga->novelty_weight > 0.f)
+        ga_set_novelty(run, ga->novelty_weight, ga->novelty ? ga->novelty->k : NOVELTY_K); // fresh archive per run
+    ga_set_control_period(run, ga->control_period);
+}
+
+int bench_run(const GAContext* ga, const BenchConfig* cfg, BenchResult* out)
+{
+    if (!out)
+        return 0;
+    memset(out, 0, sizeof(*out));
+    if (!ga || !cfg || cfg->seeds < 1 || cfg->population < 1 || cfg->max_generations < 1 || cfg->dt <= 0.f)
+        return 0;
+    out->run = calloc((size_t)cfg->seeds, sizeof(BenchRun));
+    double* v = malloc((size_t)cfg->seeds * sizeof(double));
+    if (!out->run || !v)
+    {
+        free(v);
+        bench_free(out);
+        return 0;
+    }
+    int steps = (int)ceilf(ga->eval_duration / cfg->dt);
+    if (steps < 1)
+        steps = 1;
+
+    double t_start = now_sec();
+    for (int s = 0; s < cfg->seeds; ++s)
+    {
+        BenchRun* row = &out->run[s];
+        row->seed = cfg->first_seed + (unsigned)s;
+
+        GAContext run;
+        ga_init(&run, cfg->population);
+        if (!run.population)
+        {
+            free(v);
+            bench_free(out);
+            return 0;
+        }
+        copy_settings(ga, &run);
+        ga_set_huge_pages(&run, ga->huge_pages);
+        ga_seed_thread(row->seed);
+        for (int i = 0; i < run.population_size; ++i)
+            ga_random_genome(&run.population[i]);
+        ga_set_eval_mode(&run, ga->eval_mode);
+
+        double t0 = now_sec();
+        ga_start(&run);
+        while (run.generation < cfg->max_generations && !(run.has_champion && run.champion_fitness >= cfg->target))
+            ga_run_generation(&run, cfg->dt);
+        row->wall_seconds = now_sec() - t0;
+        row->generations = run.generation;
+        row->solved = run.has_champion && run.champion_fitness >= cfg->target;
+        row->champion = run.champion_fitness;
+        row->agent_steps = (unsigned long long)row->generations * (unsigned long long)run.population_size
+                         * (unsigned long long)steps;
+        out->runs++;
+        ga_free(&run);
+        printf("[BENCH] seed %u: %s after %d generations, %.2fs, champion %.3f\n", row->seed,
+               row->solved ? "solved" : "unsolved", row->generations, row->wall_seconds, row->champion);
+        fflush(stdout);
+    }
+    out->seconds = now_sec() - t_start;
+
+    int n = 0;
+    for (int s = 0; s < out->runs; ++s)
+        if (out->run[s].solved)
+            v[n++] = out->run[s].wall_seconds;
+    out->solved = n;
+    stats(v, n, &out->wall_seconds);
+    n = 0;
+    for (int s = 0; s < out->runs; ++s)
+        if (out->run[s].solved)
+            v[n++] = (double)out->run[s].generations;
+    stats(v, n, &out->generations);
+    n = 0;
+    for (int s = 0; s < out->runs; ++s)
+        if (out->run[s].solved)
+            v[n++] = (double)out->run[s].agent_steps;
+    stats(v, n, &out->agent_steps);
+    free(v);
+    return 1;
+}
+
+static void print_stats(const char* name, const BenchStats* st)
+{
+    printf("[BENCH] %-12s min=%.4g p25=%.4g median=%.4g p75=%.4g max=%.4g mean=%.4g\n", name, st->min, st->p25,
+           st->median, st->p75, st->max, st->mean);
+}
+
+void bench_print(const BenchConfig* cfg, const BenchResult* r)
+{
+    printf("[BENCH] %d/%d seeds reached %.2f within %d generations (%d genomes), %.2fs total\n", r->solved, r->runs,
+           cfg->target, cfg->max_generations, cfg->population, r->seconds);
+    if (r->solved)
+    {
+        print_stats("wall_s", &r->wall_seconds);
+        print_stats("generations", &r->generations);
+        print_stats("agent_steps", &r->agent_steps);
+    }
+    fflush(stdout);
+}
+
+static void write_stat_row(FILE* f, const char* name, int solved, double gens, double steps, double wall)
+{
+    fprintf(f, "%s,%d,%.1f,%.0f,%.4f,\n", name, solved, gens, steps, wall);
+}
+
+int bench_write_csv(const BenchResult* r, const BenchConfig* cfg, const char* path)
+{
+    if (!r || !cfg || !path || !r->run)
+        return 0;
+    FILE* f = fopen(path, "w");
+    if (!f)
+        return 0;
+    fprintf(f, "# time to solution seeds=%d first_seed=%u population=%d target=%g max_generations=%d dt=%g "
+               "threads=%d compiler=\"%s\"\n",
+            r->runs, cfg->first_seed, cfg->population, cfg->target, cfg->max_generations, cfg->dt, GA_THREAD_COUNT,
+            __VERSION__);
+    fprintf(f, "seed,solved,generations,agent_steps,wall_seconds,champion\n");
+    for (int s = 0; s < r->runs; ++s)
+    {
+        const BenchRun* row = &r->run[s];
+        fprintf(f, "%u,%d,%d,%llu,%.4f,%.4f\n", row->seed, row->solved, row->generations, row->agent_steps,
+                row->wall_seconds, row->champion);
+    }
+    const BenchStats* st[3] = {&r->generations, &r->agent_steps, &r->wall_seconds};
+    if (r->solved)
+    {
+        write_stat_row(f, "min", r->solved, st[0]->min, st[1]->min, st[2]->min);
+        write_stat_row(f, "p25", r->solved, st[0]->p25, st[1]->p25, st[2]->p25);
+        write_stat_row(f, "median", r->solved, st[0]->median, st[1]->median, st[2]->median);
+        write_stat_row(f, "p75", r->solved, st[0]->p75, st[1]->p75, st[2]->p75);
+        write_stat_row(f, "max", r->solved, st[0]->max, st[1]->max, st[2]->max);
+        write_stat_row(f, "mean", r->solved, st[0]->mean, st[1]->mean, st[2]->mean);
+    }
+    fclose(f);
+    return 1;
+}
+
+void bench_free(BenchResult* r)
+{
+    if (!r)
+        return;
+    free(r->run);
+    memset(r, 0, sizeof(*r));
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ga.h"
+
+// Time to solution: one configuration (the GAContext given, at `population`)
+// trained from `seeds` consecutive seeds, one run after the other, each with
+// the whole worker pool. A run stops when champion_fitness reaches `target`
+// or after `max_generations`; unsolved runs are reported but kept out of the
+// time-to-solution distribution.
+
+typedef struct
+{
+    int      seeds;
+    unsigned first_seed;
+    int      population;
+    int      max_generations;
+    float    target;
+    float    dt;
+} BenchConfig;
+
+typedef struct
+{
+    unsigned           seed;
+    int                solved;
+    int                generations;  // run until solved (or the cap)
+    unsigned long long agent_steps;  // physics steps of all rollouts of those generations
+    double             wall_seconds;
+    float              champion;
+} BenchRun;
+
+// over the solved runs
+typedef struct
+{
+    double min, p25, median, p75, max, mean;
+} BenchStats;
+
+typedef struct
+{
+    int        runs;
+    BenchRun*  run;
+    int        solved;
+    BenchStats wall_seconds;
+    BenchStats generations;
+    BenchStats agent_steps;
+    double     seconds;
+} BenchResult;
+
+void bench_default_config(const GAContext* ga, BenchConfig* cfg);
+int  bench_run(const GAContext* ga, const BenchConfig* cfg, BenchResult* out);
+void bench_print(const BenchConfig* cfg, const BenchResult* r);
+// one row per seed, then one row per statistic with seed = the statistic's name
+int  bench_write_csv(const BenchResult* r, const BenchConfig* cfg, const char* path);
+void bench_free(BenchResult* r);
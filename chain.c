@@ -0,0 +1,378 @@
+#include "chain.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int chain_obs_dim(int links)
+{
+    return 1 + 3 * links;
+}
+
+ChainBatch* chain_create(const GAContext* ga, int links, int count)
+{
+    if (!ga || links < 1 || links > CHAIN_MAX_LINKS || count < 1)
+        return NULL;
+    ChainBatch* c = calloc(1, sizeof(ChainBatch));
+    if (!c)
+        return NULL;
+    c->links = links;
+    c->count = count;
+    c->padded = (count + CHAIN_LANES - 1) / CHAIN_LANES * CHAIN_LANES;
+    c->track_left = ga->track_left;
+    c->track_width = ga->track_width;
+    c->base_k = ga->base_k;
+    c->base_d = ga->base_d;
+    c->gravity = ga->gravity;
+    c->damping = ga->damping;
+    c->max_speed_factor = ga->max_speed_factor;
+    c->max_base_speed = ga->max_base_speed;
+    c->link_length = ga->length / (float)links;
+    c->link_mass = 1.f / (float)links;
+
+    size_t n = (size_t)c->padded;
+    if (posix_memalign(&c->block, 64, n * (4 + 2 * (size_t)links) * sizeof(float)) != 0)
+    {
+        free(c);
+        return NULL;
+    }
+    float* f = (float*)c->block;
+    c->slider = f;
+    c->pivot_x = f + n;
+    c->pivot_v = f + 2 * n;
+    c->fitness = f + 3 * n;
+    c->phi = f + 4 * n;
+    c->omega = f + (4 + (size_t)links) * n;
+    chain_reset(c);
+    return c;
+}
+
+void chain_free(ChainBatch* c)
+{
+    if (!c)
+        return;
+    free(c->block);
+    free(c);
+}
+
+void chain_reset(ChainBatch* c)
+{
+    if (!c)
+        return;
+    for (int i = 0; i < c->padded; ++i)
+    {
+        c->slider[i] = 0.5f;
+        c->pivot_x[i] = c->track_left + c->track_width * 0.5f;
+        c->pivot_v[i] = 0.f;
+        c->fitness[i] = 0.f;
+    }
+    for (int k = 0; k < c->links; ++k)
+    {
+        float* phi = &c->phi[(size_t)k * c->padded];
+        float* omega = &c->omega[(size_t)k * c->padded];
+        for (int i = 0; i < c->padded; ++i)
+        {
+            phi[i] = -0.7f;
+            omega[i] = 0.f;
+        }
+    }
+}
+
+void chain_step(ChainBatch* c, const float* control, float dt)
+{
+    if (!c)
+        return;
+    const int N = c->links;
+    const size_t n = (size_t)c->padded;
+    const float len = c->link_length;
+    const float m = c->link_mass;
+    const float torque = c->damping * m * len * len; // per unit of relative rate
+
+    for (int first = 0; first < c->padded; first += CHAIN_LANES)
+    {
+        float acc[CHAIN_LANES];
+        for (int l = 0; l < CHAIN_LANES; ++l)
+        {
+            int i = first + l;
+            float u = (control && i < c->count) ? control[i] : 0.f;
+            float slider = c->slider[i] + (u * dt) / c->track_width;
+            slider = slider < 0.f ? 0.f : (slider > 1.f ? 1.f : slider);
+            c->slider[i] = slider;
+
+            float dx = c->track_left + c->track_width * slider - c->pivot_x[i];
+            float pivot_acc = c->base_k * dx - c->base_d * c->pivot_v[i];
+            float pv = c->pivot_v[i] + pivot_acc * dt;
+            float px = c->pivot_x[i] + pv * dt;
+            if (px < c->track_left)
+            {
+                px = c->track_left;
+                pv = 0.f;
+            }
+            if (px > c->track_left + c->track_width)
+            {
+                px = c->track_left + c->track_width;
+                pv = 0.f;
+            }
+            c->pivot_x[i] = px;
+            c->pivot_v[i] = pv;
+            acc[l] = pivot_acc;
+        }
+
+        // tip inwards: articulated mass M and bias b of the links outside joint k,
+        // e = d(joint k+1)/d(phi_k), kappa its centripetal acceleration
+        float Mxx[CHAIN_LANES] = {0}, Mxy[CHAIN_LANES] = {0}, Myy[CHAIN_LANES] = {0};
+        float bx[CHAIN_LANES] = {0}, by[CHAIN_LANES] = {0}, tau_out[CHAIN_LANES] = {0};
+        float ex[CHAIN_MAX_LINKS][CHAIN_LANES], ey[CHAIN_MAX_LINKS][CHAIN_LANES];
+        float kx[CHAIN_MAX_LINKS][CHAIN_LANES], ky[CHAIN_MAX_LINKS][CHAIN_LANES];
+        float kex[CHAIN_MAX_LINKS][CHAIN_LANES], key[CHAIN_MAX_LINKS][CHAIN_LANES];
+        float inv_d[CHAIN_MAX_LINKS][CHAIN_LANES], res[CHAIN_MAX_LINKS][CHAIN_LANES];
+        for (int k = N - 1; k >= 0; --k)
+        {
+            const float* phi = &c->phi[k * n + first];
+            const float* w = &c->omega[k * n + first];
+            const float* w_in = k > 0 ? &c->omega[(k - 1) * n + first] : NULL;
+            for (int l = 0; l < CHAIN_LANES; ++l)
+            {
+                float s = sinf(phi[l]), co = cosf(phi[l]);
+                float e_x = len * co, e_y = -len * s;
+                float k_x = -w[l] * w[l] * len * s, k_y = -w[l] * w[l] * len * co;
+                float Kxx = m + Mxx[l], Kxy = Mxy[l], Kyy = m + Myy[l];
+                float tau = -torque * (w[l] - (w_in ? w_in[l] : 0.f));
+                float Kex = Kxx * e_x + Kxy * e_y;
+                float Key = Kxy * e_x + Kyy * e_y;
+                float inv = 1.f / (e_x * Kex + e_y * Key);
+                // K kappa + b - m g
+                float fx = Kxx * k_x + Kxy * k_y + bx[l];
+                float fy = Kxy * k_x + Kyy * k_y + by[l] - m * c->gravity;
+                float r = tau - tau_out[l] - (e_x * fx + e_y * fy);
+                Mxx[l] = Kxx - Kex * Kex * inv;
+                Mxy[l] = Kxy - Kex * Key * inv;
+                Myy[l] = Kyy - Key * Key * inv;
+                bx[l] = fx + Kex * r * inv;
+                by[l] = fy + Key * r * inv;
+                tau_out[l] = tau;
+                ex[k][l] = e_x;
+                ey[k][l] = e_y;
+                kx[k][l] = k_x;
+                ky[k][l] = k_y;
+                kex[k][l] = Kex;
+                key[k][l] = Key;
+                inv_d[k][l] = inv;
+                res[k][l] = r;
+            }
+        }
+
+        // base outwards: phi_k'' from the acceleration of joint k, then integrate
+        // as step_agent does
+        float ax[CHAIN_LANES], ay[CHAIN_LANES] = {0};
+        memcpy(ax, acc, sizeof(ax));
+        for (int k = 0; k < N; ++k)
+        {
+            float* phi = &c->phi[k * n + first];
+            float* w = &c->omega[k * n + first];
+            for (int l = 0; l < CHAIN_LANES; ++l)
+            {
+                float phi_dd = (res[k][l] - kex[k][l] * ax[l] - key[k][l] * ay[l]) * inv_d[k][l];
+                ax[l] += phi_dd * ex[k][l] + kx[k][l];
+                ay[l] += phi_dd * ey[k][l] + ky[k][l];
+                float omega = w[l] + phi_dd * dt;
+                if (omega > c->max_speed_factor)
+                    omega = c->max_speed_factor;
+                if (omega < -c->max_speed_factor)
+                    omega = -c->max_speed_factor;
+                w[l] = omega;
+                phi[l] += omega * dt;
+            }
+        }
+    }
+}
+
+void chain_observe(const ChainBatch* c, int i, float* obs)
+{
+    obs[0] = c->slider[i] * 2.f - 1.f;
+    for (int k = 0; k < c->links; ++k)
+    {
+        float phi = c->phi[(size_t)k * c->padded + i];
+        obs[1 + 3 * k] = sinf(phi);
+        obs[2 + 3 * k] = cosf(phi);
+        obs[3 + 3 * k] = c->omega[(size_t)k * c->padded + i];
+    }
+}
+
+float chain_tip_height(const ChainBatch* c, int i)
+{
+    float y = 0.f;
+    for (int k = 0; k < c->links; ++k)
+        y += cosf(c->phi[(size_t)k * c->padded + i]);
+    return 0.5f * (1.f - y / (float)c->links);
+}
+
+float chain_energy(const ChainBatch* c, int i)
+{
+    float vx = 0.f, vy = 0.f, y = 0.f, e = 0.f;
+    for (int k = 0; k < c->links; ++k)
+    {
+        float phi = c->phi[(size_t)k * c->padded + i];
+        float w = c->omega[(size_t)k * c->padded + i];
+        vx += w * c->link_length * cosf(phi);
+        vy -= w * c->link_length * sinf(phi);
+        y += c->link_length * cosf(phi); // screen y, down
+        e += c->link_mass * (0.5f * (vx * vx + vy * vy) - c->gravity * y);
+    }
+    return e;
+}
+
+static float chain_frand(unsigned* s)
+{
+    unsigned x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return (float)(x >> 8) * (2.f / 16777216.f) - 1.f;
+}
+
+void chain_random_net(ChainNet* n, int inputs, int hidden, unsigned* rng)
+{
+    memset(n, 0, sizeof(*n));
+    n->inputs = inputs < CHAIN_MAX_INPUTS ? inputs : CHAIN_MAX_INPUTS;
+    n->hidden = hidden < GA_MAX_HIDDEN ? hidden : GA_MAX_HIDDEN;
+    for (int i = 0; i < n->hidden; ++i)
+    {
+        for (int j = 0; j < n->inputs; ++j)
+            n->w_in[i][j] = chain_frand(rng);
+        n->b_h[i] = chain_frand(rng);
+        n->w_out[i] = chain_frand(rng);
+    }
+    for (int j = 0; j < n->inputs; ++j)
+        n->w_direct[j] = chain_frand(rng);
+    n->b_out = chain_frand(rng);
+}
+
+// eval_network (ga.c) with a variable input count
+float chain_net_eval(const ChainNet* n, const float* in)
+{
+    float h[GA_MAX_HIDDEN];
+    for (int i = 0; i < n->hidden; ++i)
+    {
+        float sum = n->b_h[i];
+        for (int j = 0; j < n->inputs; ++j)
+            sum += n->w_in[i][j] * in[j];
+        h[i] = tanhf(sum);
+    }
+    float out = n->b_out;
+    for (int j = 0; j < n->inputs; ++j)
+        out += n->w_direct[j] * in[j];
+    for (int i = 0; i < n->hidden; ++i)
+        out += n->w_out[i] * h[i];
+    return tanhf(out);
+}
+
+void chain_rollout(ChainBatch* c, const ChainNet* nets, float dt, int steps, float* fitness)
+{
+    if (!c || !nets)
+        return;
+    float* control = calloc((size_t)c->count, sizeof(float));
+    if (!control)
+        return;
+    chain_reset(c);
+    float obs[CHAIN_MAX_INPUTS];
+    for (int s = 0; s < steps; ++s)
+    {
+        for (int i = 0; i < c->count; ++i)
+        {
+            chain_observe(c, i, obs);
+            control[i] = chain_net_eval(&nets[i], obs) * c->max_base_speed;
+        }
+        chain_step(c, control, dt);
+        for (int i = 0; i < c->count; ++i)
+        {
+            float h = chain_tip_height(c, i);
+            c->fitness[i] += dt * h * h;
+        }
+    }
+    if (fitness)
+        memcpy(fitness, c->fitness, (size_t)c->count * sizeof(float));
+    free(control);
+}
+
+// passive chain from the start state; symplectic Euler keeps the energy error bounded
+static float energy_drift(const GAContext* ga, int links)
+{
+    ChainBatch* c = chain_create(ga, links, 1);
+    if (!c)
+        return -1.f;
+    c->damping = 0.f;
+    c->max_speed_factor = 1e9f;
+    float e0 = chain_energy(c, 0);
+    float worst = 0.f;
+    for (int s = 0; s < 2000; ++s)
+    {
+        chain_step(c, NULL, 1e-3f);
+        float d = fabsf(chain_energy(c, 0) - e0);
+        worst = d > worst ? d : worst;
+    }
+    chain_free(c);
+    return worst / (ga->gravity * ga->length);
+}
+
+int chain_bench(const GAContext* ga, int max_links, int count, int steps, ChainBench* out)
+{
+    if (!ga || !out || max_links < 1 || max_links > CHAIN_MAX_LINKS || count < 1 || steps < 1)
+        return 0;
+    const float dt = 1.f / 120.f;
+    ChainNet* nets = malloc((size_t)count * sizeof(ChainNet));
+    float* fitness = malloc((size_t)count * sizeof(float));
+    float* control = malloc((size_t)count * sizeof(float));
+    if (!nets || !fitness || !control)
+    {
+        free(nets);
+        free(fitness);
+        free(control);
+        return 0;
+    }
+    for (int k = 1; k <= max_links; ++k)
+    {
+        ChainBench* b = &out[k - 1];
+        memset(b, 0, sizeof(*b));
+        b->links = k;
+        b->inputs = chain_obs_dim(k);
+        ChainBatch* c = chain_create(ga, k, count);
+        if (!c)
+            continue;
+
+        // physics alone, under a fixed random command per env
+        unsigned rng = 0x9E3779B9u;
+        for (int i = 0; i < count; ++i)
+            control[i] = chain_frand(&rng) * c->max_base_speed;
+        double t0 = now_sec();
+        for (int s = 0; s < steps; ++s)
+            chain_step(c, control, dt);
+        double t = now_sec() - t0;
+        double env_steps = (double)count * steps;
+        b->env_steps_per_sec = (float)(env_steps / t);
+        b->ns_per_env_step = (float)(t * 1e9 / env_steps);
+        b->ns_per_link_step = b->ns_per_env_step / (float)k;
+        b->energy_drift = energy_drift(ga, k);
+
+        for (int i = 0; i < count; ++i)
+            chain_random_net(&nets[i], b->inputs, 4, &rng);
+        chain_rollout(c, nets, dt, steps, fitness);
+        b->best_fitness = fitness[0];
+        for (int i = 1; i < count; ++i)
+            b->best_fitness = fitness[i] > b->best_fitness ? fitness[i] : b->best_fitness;
+        chain_free(c);
+    }
+    free(nets);
+    free(fitness);
+    free(control);
+    return 1;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "ga.h"
+
+// Batched N-link cart-pendulum: the base and slider of the single pendulum,
+// carrying a chain of `links` rigid massless links with a point mass at the end
+// of each, joined by pin joints. Link i has absolute angle phi_i (0: hanging,
+// same convention as theta) and joint damping on the relative rate. The GA's
+// pendulum is split into equal links (length / links, mass 1 / links), so one
+// link is exactly the single pendulum.
+//
+// Joint accelerations come from an articulated-body recursion, O(links):
+// a pin joint passes a force and no moment, so the links from i outwards act
+// on joint i as F_i = M_i a_i + b_i (2x2 articulated mass, bias), built from
+// the tip inwards; a second pass from the base outwards turns the base
+// acceleration into every phi_i'' and the acceleration of the next joint.
+// State is SoA, [links][padded] for the angles, stepped CHAIN_LANES envs at a
+// time with the lane loop innermost.
+//
+// Observation: position in [-1, 1], then sin phi_i, cos phi_i, phi_i' for each
+// link, chain_obs_dim(links) floats; for one link it is the GA's network input.
+
+#define CHAIN_MAX_LINKS  8
+#define CHAIN_LANES      8
+#define CHAIN_MAX_INPUTS (1 + 3 * CHAIN_MAX_LINKS)
+
+typedef struct
+{
+    int    links;
+    int    count;
+    int    padded;        // count rounded up to CHAIN_LANES
+
+    // physics, from the GA
+    float  track_left;
+    float  track_width;
+    float  base_k;
+    float  base_d;
+    float  gravity;
+    float  damping;       // per unit of relative joint rate, as the single pendulum's omega term
+    float  max_speed_factor;
+    float  max_base_speed;
+    float  link_length;
+    float  link_mass;
+
+    float* slider;        // [padded]
+    float* pivot_x;
+    float* pivot_v;
+    float* phi;           // [links][padded]
+    float* omega;         // [links][padded]
+    float* fitness;       // [padded]
+    void*  block;
+} ChainBatch;
+
+// dense policy whose input size follows the chain's state
+typedef struct
+{
+    int   inputs;
+    int   hidden;
+    float w_in[GA_MAX_HIDDEN][CHAIN_MAX_INPUTS];
+    float b_h[GA_MAX_HIDDEN];
+    float w_out[GA_MAX_HIDDEN];
+    float w_direct[CHAIN_MAX_INPUTS];
+    float b_out;
+} ChainNet;
+
+int         chain_obs_dim(int links);
+ChainBatch* chain_create(const GAContext* ga, int links, int count);
+void        chain_free(ChainBatch* c);
+// every env at the GA's start state, the chain straight at theta = -0.7
+void        chain_reset(ChainBatch* c);
+// one physics step; control[count]: base velocity (px/s), NULL: none
+void        chain_step(ChainBatch* c, const float* control, float dt);
+void        chain_observe(const ChainBatch* c, int i, float* obs);
+// tip height above the hanging position, 0 hanging, 1 straight up
+float       chain_tip_height(const ChainBatch* c, int i);
+// kinetic + potential energy of the links, in the base's frame
+float       chain_energy(const ChainBatch* c, int i);
+
+void        chain_random_net(ChainNet* n, int inputs, int hidden, unsigned* rng);
+float       chain_net_eval(const ChainNet* n, const float* in);
+// env i driven by nets[i] from the start state for `steps`; fitness[i] is the
+// integral of the squared tip height
+void        chain_rollout(ChainBatch* c, const ChainNet* nets, float dt, int steps, float* fitness);
+
+// cost per step against link count, on `count` envs driven by random nets
+typedef struct
+{
+    int   links;
+    int   inputs;
+    float env_steps_per_sec;
+    float ns_per_env_step;
+    float ns_per_link_step;
+    float energy_drift;   // passive chain, no damping: max |E - E0| / (m g L) over 2 s at dt 1 ms
+    float best_fitness;
+} ChainBench;
+
+// fills out[0 .. max_links - 1]
+int         chain_bench(const GAContext* ga, int max_links, int count, int steps, ChainBench* out);
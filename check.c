@@ -0,0 +1,667 @@
+#include "check.h"
+#include "half.h"
+#include "physics.h"
+#include "quant.h"
+#include "reward.h"
+#include "sweep.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CHECK_PARALLEL 0
+#define CHECK_STATES   1
+#define CHECK_LANES    2
+#define CHECK_INT8     3
+#define CHECK_FP16     4
+#define CHECK_BF16     5
+
+#define CHECK_FIELDS 9
+
+// every field a step carries over to the next, the held command included
+static const char* const field_names[CHECK_FIELDS] = {"theta", "omega", "pivot_x", "pivot_v", "slider",
+                                                      "above",  "control", "hold", "fitness"};
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// own generator: the cases only depend on cfg->seed
+static float check_frand(unsigned* s, float lo, float hi)
+{
+    unsigned x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return lo + (hi - lo) * (float)(x >> 8) * (1.f / 16777216.f);
+}
+
+static void random_genome(unsigned* s, Genome* g)
+{
+    memset(g, 0, sizeof(*g));
+    g->hidden = (int)check_frand(s, 0.f, (float)GA_MAX_HIDDEN + 0.999f);
+    // some genomes with large weights, to exercise saturated tanh
+    float range = check_frand(s, 0.f, 1.f) < 0.25f ? 6.f : 2.f;
+    // and some where omega, the one input beyond [-1, 1], carries the largest
+    // weight of every row by far: int8 scales follow the largest weight, these
+    // keep the other inputs on a few levels unless the scales allow for it
+    float other = check_frand(s, 0.f, 1.f) < 0.25f ? range * 0.125f : range;
+    for (int i = 0; i < g->hidden; ++i)
+    {
+        for (int j = 0; j < GA_INPUTS; ++j)
+            g->w_in[i][j] = check_frand(s, -other, other);
+        g->w_in[i][3] = check_frand(s, -range, range);
+        g->b_h[i] = check_frand(s, -range, range);
+        g->w_out[i] = check_frand(s, -range, range);
+    }
+    for (int j = 0; j < GA_INPUTS; ++j)
+        g->w_direct[j] = check_frand(s, -other, other);
+    g->w_direct[3] = check_frand(s, -range, range);
+    g->b_out = check_frand(s, -range, range);
+}
+
+static void random_start(unsigned* s, const GAContext* ga, GAAgent* a)
+{
+    memset(a, 0, sizeof(*a));
+    a->slider_value = check_frand(s, 0.f, 1.f);
+    a->pivot_x = ga->track_left + ga->track_width * check_frand(s, 0.f, 1.f);
+    a->pivot_v = check_frand(s, -0.3f, 0.3f) * ga->max_base_speed;
+    a->theta = check_frand(s, -3.14159265f, 3.14159265f);
+    a->omega = check_frand(s, -1.f, 1.f) * ga->max_speed_factor;
+    // part way through a held command
+    a->hold = (int)check_frand(s, 0.f, (float)ga->control_period - 0.001f);
+    a->last_control = check_frand(s, -1.f, 1.f) * ga->max_base_speed;
+}
+
+// The reference: one step written out plainly, with branches and libm, apart
+// from physics.h and the kernels built on it. Only the reward functions
+// (reward.h) and the float network (ga_eval_network) are shared.
+static void reference_step(const GAContext* ga, const Genome* g, GAAgent* a, float dt)
+{
+    float control;
+    if (a->hold > 0)
+    {
+        control = a->last_control;
+        a->hold--;
+    }
+    else
+    {
+        float in[GA_INPUTS];
+        in[0] = a->slider_value * 2.f - 1.f;
+        in[1] = sinf(a->theta);
+        in[2] = cosf(a->theta);
+        in[3] = a->omega;
+        control = ga_eval_network(g, in) * ga->max_base_speed;
+        a->last_control = control;
+        a->hold = ga->control_period - 1;
+    }
+
+    a->slider_value += (control * dt) / ga->track_width;
+    if (a->slider_value < 0.f)
+        a->slider_value = 0.f;
+    if (a->slider_value > 1.f)
+        a->slider_value = 1.f;
+
+    float pivot_target_x = ga->track_left + ga->track_width * a->slider_value;
+    float dx = pivot_target_x - a->pivot_x;
+    float pivot_acc = ga->base_k * dx - ga->base_d * a->pivot_v;
+    a->pivot_v += pivot_acc * dt;
+    a->pivot_x += a->pivot_v * dt;
+    if (a->pivot_x < ga->track_left)
+    {
+        a->pivot_x = ga->track_left;
+        a->pivot_v = 0.f;
+    }
+    if (a->pivot_x > ga->track_left + ga->track_width)
+    {
+        a->pivot_x = ga->track_left + ga->track_width;
+        a->pivot_v = 0.f;
+    }
+
+    float theta_dd = -(ga->gravity / ga->length) * sinf(a->theta)
+                     - (pivot_acc / ga->length) * cosf(a->theta)
+                     - ga->damping * a->omega;
+    a->omega += theta_dd * dt;
+    if (a->omega > ga->max_speed_factor)
+        a->omega = ga->max_speed_factor;
+    if (a->omega < -ga->max_speed_factor)
+        a->omega = -ga->max_speed_factor;
+    a->theta += a->omega * dt;
+
+    switch (ga->reward)
+    {
+#define CHECK_REWARD_CASE(id, fn, name)                                                                         \
+        case GA_REWARD_##id:                                                                                    \
+            a->fitness = reward_##fn(ga, a->fitness, &a->above_time, a->theta, cosf(a->theta), a->omega,       \
+                                     a->pivot_x, a->pivot_v, control, dt);                                      \
+            break;
+        GA_REWARD_LIST(CHECK_REWARD_CASE)
+#undef CHECK_REWARD_CASE
+    }
+}
+
+// states[s]: the state after step s
+static float reference_rollout(const GAContext* ga, const Genome* g, const GAAgent* start, float dt, int steps,
+                               GAAgent* states)
+{
+    GAAgent a = *start;
+    for (int s = 0; s < steps; ++s)
+    {
+        reference_step(ga, g, &a, dt);
+        states[s] = a;
+    }
+    return a.fitness;
+}
+
+// the held command in network output units, [-1, 1]
+static void agent_fields(const GAContext* ga, const GAAgent* a, float out[CHECK_FIELDS])
+{
+    out[0] = a->theta;
+    out[1] = a->omega;
+    out[2] = a->pivot_x;
+    out[3] = a->pivot_v;
+    out[4] = a->slider_value;
+    out[5] = a->above_time;
+    out[6] = a->last_control / ga->max_base_speed;
+    out[7] = (float)a->hold;
+    out[8] = a->fitness;
+}
+
+static long ulp_distance(float a, float b)
+{
+    if (a == b)
+        return 0;
+    if (isnan(a) || isnan(b))
+        return 0x7fffffffL;
+    int32_t ia, ib;
+    memcpy(&ia, &a, sizeof(ia));
+    memcpy(&ib, &b, sizeof(ib));
+    // map to a monotonic integer line
+    if (ia < 0)
+        ia = (int32_t)0x80000000 - ia;
+    if (ib < 0)
+        ib = (int32_t)0x80000000 - ib;
+    long d = (long)ia - (long)ib;
+    return d < 0 ? -d : d;
+}
+
+// relative error, absolute below magnitude 1
+static float rel_error(float ref, float got)
+{
+    float scale = fabsf(ref) > 1.f ? fabsf(ref) : 1.f;
+    float e = fabsf(got - ref) / scale;
+    return isnan(e) ? INFINITY : e;
+}
+
+static void note_divergence(CheckVariant* v, int c, int step, const char* field, float ref, float got)
+{
+    if (v->div_case >= 0)
+        return;
+    v->div_case = c;
+    v->div_step = step;
+    v->div_field = field;
+    v->div_ref = ref;
+    v->div_got = got;
+}
+
+// exact variant: every field within ulp or rel; returns 1 when the case passes
+static int compare_exact(const CheckConfig* cfg, CheckVariant* v, int c, int step, const float ref[CHECK_FIELDS],
+                         const float got[CHECK_FIELDS], int first_field, int last_field)
+{
+    int ok = 1;
+    for (int f = first_field; f <= last_field; ++f)
+    {
+        long u = ulp_distance(ref[f], got[f]);
+        float r = rel_error(ref[f], got[f]);
+        if (u > v->max_ulp)
+            v->max_ulp = u;
+        if (r > v->max_rel)
+            v->max_rel = r;
+        if (u > cfg->ulp && r > cfg->rel)
+        {
+            note_divergence(v, c, step, field_names[f], ref[f], got[f]);
+            ok = 0;
+        }
+    }
+    return ok;
+}
+
+// bounded variant: every field within rel (absolute below magnitude 1)
+static int compare_bound(CheckVariant* v, int c, int step, const float ref[CHECK_FIELDS],
+                         const float got[CHECK_FIELDS], float rel)
+{
+    int ok = 1;
+    for (int f = 0; f < CHECK_FIELDS; ++f)
+    {
+        float r = rel_error(ref[f], got[f]);
+        if (r > v->max_rel)
+            v->max_rel = r;
+        if (r > rel)
+        {
+            note_divergence(v, c, step, field_names[f], ref[f], got[f]);
+            ok = 0;
+        }
+    }
+    return ok;
+}
+
+void check_default_config(const GAContext* ga, CheckConfig* cfg)
+{
+    cfg->cases = 200;
+    cfg->dt = 1.f / 120.f;
+    cfg->steps = (int)ceilf(ga->eval_duration / cfg->dt);
+    cfg->seed = 1;
+    cfg->ulp = 4;
+    cfg->rel = 1e-5f;
+    // a step that rounds the slider target one ulp of the track coordinate
+    // away reaches pivot_v as base_k * dt * ulp through the base spring (the
+    // target minus pivot_x cancels); 2x margin, the other fields stay within a
+    // few ulp and the command within 1e-5 of its output range. Lanes: sin/cos
+    // within 2 ulp of libm and tanh within 1e-7 do that; the steps that end
+    // with cos theta next to upright_threshold are not compared.
+    float right = ga->track_left + ga->track_width;
+    float track_ulp = nextafterf(right, INFINITY) - right;
+    float target_rel = 2.f * ga->base_k * cfg->dt * track_ulp;
+    cfg->lane_rel = fmaxf(cfg->rel, target_rel);
+#if defined(__FP_FAST_FMAF)
+    // with FMA the compiler contracts a * b + c where the kernels and the
+    // reference differ in shape, so the exact variants round like the lanes
+    cfg->rel = cfg->lane_rel;
+#endif
+    // selection ranks genomes by fitness: on average a reduced kernel has to
+    // score within 2% of what a rollout can reach, or it ranks them differently
+    cfg->gap_tol = 0.02f;
+}
+
+// Output error bounds of the reduced networks for one input, from their
+// quantization steps. tanh is 1-Lipschitz, so an error in a pre-activation
+// passes through at most as large; each row's error is the sum over its
+// terms of (weight error * input) + (weight * input error).
+#define CHECK_FLOAT_EPS 2.4e-7f // a few float roundings per row, and tanhf
+
+// fp16 / bf16: every weight rounded to nearest, relative step u (2^-11,
+// 2^-8) plus the fp16 subnormal step; arithmetic in float
+static float half_bound(const Genome* g, int format, const float in[GA_INPUTS])
+{
+    float u = (format == HALF_FP16 ? 0x1p-11f : 0x1p-8f) + CHECK_FLOAT_EPS;
+    float tiny = format == HALF_FP16 ? 0x1p-25f : 0.f;
+    float dz_out = u * fabsf(g->b_out) + tiny;
+    for (int j = 0; j < GA_INPUTS; ++j)
+        dz_out += (u * fabsf(g->w_direct[j]) + tiny) * fabsf(in[j]);
+    for (int i = 0; i < g->hidden; ++i)
+    {
+        float dz = u * fabsf(g->b_h[i]) + tiny;
+        for (int j = 0; j < GA_INPUTS; ++j)
+            dz += (u * fabsf(g->w_in[i][j]) + tiny) * fabsf(in[j]);
+        float dh = fminf(dz, 2.f) + CHECK_FLOAT_EPS;
+        // |tanh| <= 1, and the weight itself is off by up to u
+        dz_out += u * fabsf(g->w_out[i]) + tiny + (1.f + u) * fabsf(g->w_out[i]) * dh;
+    }
+    return fminf(dz_out, 2.f) + CHECK_FLOAT_EPS;
+}
+
+// int8 (quant.h): a row computes z = kappa * (b_q + sum w_q * x_q), kappa its
+// tanh table multiplier read back as a scale, so a weight counts as
+// kappa * act_scale * w_q: half a step from the float weight, plus what the
+// rounding of the multiplier (rho) does to the whole row. Inputs and hidden
+// outputs are off by half an activation step; the table by half an entry, its
+// Q15 rounding and the saturation past QUANT_TANH_RANGE.
+static float int8_row_error(float kappa, float act, int32_t mul, float b, int32_t bq, const int8_t* wq,
+                            const float* x, const float* dx, int n)
+{
+    float rho = (mul > 1 ? 0.5f / (float)(mul - 1) : 1.f) + 0x1p-22f;
+    float step = kappa * act;
+    float dz = kappa * (0.5f + 0x1p-23f * fabsf((float)bq)) + rho * fabsf(b);
+    for (int j = 0; j < n; ++j)
+    {
+        float aw = fabsf((float)wq[j]);
+        float dw = step * (0.5f + 0x1p-17f + rho * (1.f + rho) * (aw + 0.5f));
+        dz += dw * fabsf(x[j]) + step * aw * dx[j];
+    }
+    return dz;
+}
+
+// The steps the bounds assume: every stored weight within half a step of the
+// float one. These return the worst error over its allowance, above 1 is a fault.
+static float weight_error(float w, float stored, float allow)
+{
+    float e = fabsf(stored - w) / allow;
+    return isnan(e) ? INFINITY : e;
+}
+
+static float half_weight_error(const Genome* g, int format)
+{
+    uint16_t rec[HALF_MAX + HALF_SLACK] = {0};
+    Genome back;
+    half_pack(g, rec, format);
+    half_unpack(rec, &back, format);
+    float u = format == HALF_FP16 ? 0x1p-11f : 0x1p-8f;
+    float tiny = format == HALF_FP16 ? 0x1p-25f : 0x1p-134f;
+    float worst = weight_error(g->b_out, back.b_out, u * fabsf(g->b_out) + tiny);
+    for (int j = 0; j < GA_INPUTS; ++j)
+        worst = fmaxf(worst, weight_error(g->w_direct[j], back.w_direct[j], u * fabsf(g->w_direct[j]) + tiny));
+    for (int i = 0; i < g->hidden; ++i)
+    {
+        for (int j = 0; j < GA_INPUTS; ++j)
+            worst = fmaxf(worst, weight_error(g->w_in[i][j], back.w_in[i][j], u * fabsf(g->w_in[i][j]) + tiny));
+        worst = fmaxf(worst, weight_error(g->b_h[i], back.b_h[i], u * fabsf(g->b_h[i]) + tiny));
+        worst = fmaxf(worst, weight_error(g->w_out[i], back.w_out[i], u * fabsf(g->w_out[i]) + tiny));
+    }
+    return worst;
+}
+
+// int8: a weight counts as kappa * act_scale * w_q (int8_row_error)
+static float int8_row_weight_error(float kappa, float act, int32_t mul, const int8_t* wq, const float* w, int n)
+{
+    float rho = (mul > 1 ? 0.5f / (float)(mul - 1) : 1.f) + 0x1p-22f;
+    float step = kappa * act;
+    float worst = 0.f;
+    for (int j = 0; j < n; ++j)
+        worst = fmaxf(worst, weight_error(w[j], step * (float)wq[j], step * (0.5f + 0x1p-17f) + rho * fabsf(w[j])));
+    return worst;
+}
+
+static float int8_weight_error(const Genome* g, const QGenome* q)
+{
+    const float half = (float)(QUANT_TANH_LUT_SIZE / 2);
+    float worst = 0.f;
+    for (int i = 0; i < q->hidden; ++i)
+    {
+        float kappa = (float)q->h_mul[i] * QUANT_TANH_RANGE / (16777216.f * half);
+        float e = int8_row_weight_error(kappa, q->act_scale, q->h_mul[i], q->w_in[i], g->w_in[i], GA_INPUTS);
+        worst = fmaxf(worst, e);
+    }
+    int8_t wq[GA_INPUTS + GA_MAX_HIDDEN];
+    float w[GA_INPUTS + GA_MAX_HIDDEN];
+    memcpy(wq, q->w_direct, GA_INPUTS);
+    memcpy(wq + GA_INPUTS, q->w_out, (size_t)q->hidden);
+    memcpy(w, g->w_direct, sizeof(g->w_direct));
+    memcpy(w + GA_INPUTS, g->w_out, (size_t)q->hidden * sizeof(float));
+    float kappa = (float)q->o_mul * QUANT_TANH_RANGE / (16777216.f * half);
+    return fmaxf(worst, int8_row_weight_error(kappa, q->act_scale, q->o_mul, wq, w, GA_INPUTS + q->hidden));
+}
+
+static float int8_bound(const Genome* g, const QGenome* q, const float in[GA_INPUTS])
+{
+    const float half = (float)(QUANT_TANH_LUT_SIZE / 2);
+    const float lut_err = 0.5f * QUANT_TANH_RANGE / half + 0.5f / 32767.f + (1.f - tanhf(QUANT_TANH_RANGE))
+                          + CHECK_FLOAT_EPS;
+    float act = q->act_scale;
+    float dx_in = 0.51f / act; // rounding of in * act_scale, which is itself rounded
+    // act_mul is 65536 / range to the nearest integer
+    float requant = 0.5f * (32767.f / act) / 65536.f + 0x1p-22f + 0.5f / act;
+
+    float x[GA_INPUTS + GA_MAX_HIDDEN], dx[GA_INPUTS + GA_MAX_HIDDEN];
+    for (int j = 0; j < GA_INPUTS; ++j)
+    {
+        x[j] = in[j];
+        dx[j] = dx_in;
+    }
+    for (int i = 0; i < q->hidden; ++i)
+    {
+        float kappa = (float)q->h_mul[i] * QUANT_TANH_RANGE / (16777216.f * half);
+        float z = g->b_h[i];
+        for (int j = 0; j < GA_INPUTS; ++j)
+            z += g->w_in[i][j] * in[j];
+        float dz = int8_row_error(kappa, act, q->h_mul[i], g->b_h[i], q->b_h[i], q->w_in[i], in, dx, GA_INPUTS);
+        x[GA_INPUTS + i] = tanhf(z);
+        dx[GA_INPUTS + i] = fminf(dz, 2.f) + lut_err + requant;
+    }
+
+    int8_t wq[GA_INPUTS + GA_MAX_HIDDEN];
+    memcpy(wq, q->w_direct, GA_INPUTS);
+    memcpy(wq + GA_INPUTS, q->w_out, (size_t)q->hidden);
+    float kappa = (float)q->o_mul * QUANT_TANH_RANGE / (16777216.f * half);
+    float dz = int8_row_error(kappa, act, q->o_mul, g->b_out, q->b_out, wq, x, dx, GA_INPUTS + q->hidden);
+    return fminf(dz, 2.f) + lut_err;
+}
+
+// the training path: the population pass of a private context with the
+// physics of `ga`, one agent per case
+static int parallel_fitness(const GAContext* ga, const Genome* genomes, const GAAgent* starts, int n, float dt,
+                            int steps, GAAgent* ends)
+{
+    GAContext par;
+    ga_init(&par, n);
+    if (!par.population)
+        return 0;
+    ga_set_env(&par, ga->track_left, ga->track_width, ga->pivot_y, ga->length, ga->base_k, ga->base_d, ga->gravity,
+               ga->damping, ga->max_speed_factor, ga->max_base_speed, ga->upright_threshold);
+    par.control_period = ga->control_period;
+    par.reward = ga->reward;
+    par.reward_bonus = ga->reward_bonus;
+    par.reward_drop = ga->reward_drop;
+    par.reward_effort = ga->reward_effort;
+    par.scheduler = ga->scheduler;
+    memcpy(par.population, genomes, (size_t)n * sizeof(Genome));
+    memcpy(par.agents, starts, (size_t)n * sizeof(GAAgent));
+    ga_eval_population(&par, dt, steps);
+    for (int c = 0; c < n; ++c)
+    {
+        ends[c] = par.agents[c];
+        ends[c].fitness = par.population[c].fitness;
+    }
+    ga_free(&par);
+    return 1;
+}
+
+int check_run(GAContext* ga, const CheckConfig* cfg, CheckReport* out)
+{
+    static const char* const names[CHECK_VARIANTS] = {"parallel", "states", "lanes", "int8", "fp16", "bf16"};
+    memset(out, 0, sizeof(*out));
+    for (int k = 0; k < CHECK_VARIANTS; ++k)
+    {
+        out->variant[k].name = names[k];
+        out->variant[k].exact = k <= CHECK_STATES;
+        out->variant[k].div_case = -1;
+    }
+    if (!ga || !cfg || cfg->cases < 1 || cfg->steps < 1 || cfg->dt <= 0.f)
+        return 0;
+
+    int n = cfg->cases;
+    int steps = cfg->steps;
+    Genome* genomes = malloc((size_t)n * sizeof(Genome));
+    GAAgent* starts = malloc((size_t)n * sizeof(GAAgent));
+    GAAgent* ends = malloc((size_t)n * sizeof(GAAgent));
+    GAAgent* traj = malloc((size_t)(steps + 1) * sizeof(GAAgent)); // start, then the reference
+    GAAgent* got = malloc((size_t)steps * sizeof(GAAgent));
+    if (!genomes || !starts || !ends || !traj || !got)
+    {
+        free(genomes);
+        free(starts);
+        free(ends);
+        free(traj);
+        free(got);
+        return 0;
+    }
+    unsigned s = cfg->seed ? cfg->seed : 1u;
+    for (int c = 0; c < n; ++c)
+    {
+        random_genome(&s, &genomes[c]);
+        random_start(&s, ga, &starts[c]);
+    }
+
+    // the most a rollout can score: upright with the full bonus every step
+    float fit_range = (float)steps * cfg->dt * (1.f + ga->reward_bonus);
+    double t0 = now_sec();
+    int have_parallel = parallel_fitness(ga, genomes, starts, n, cfg->dt, steps, ends);
+    for (int c = 0; c < n; ++c)
+    {
+        const Genome* g = &genomes[c];
+        GAAgent* ref = traj + 1;
+        traj[0] = starts[c];
+        float ref_fit = reference_rollout(ga, g, &starts[c], cfg->dt, steps, ref);
+        float fr[CHECK_FIELDS], fg[CHECK_FIELDS];
+
+        // step by step rollout (replay, trajectory export): every state against
+        // one reference step from the state before it, so a rounding difference
+        // is judged where it happens and not after the pendulum amplified it
+        CheckVariant* v = &out->variant[CHECK_STATES];
+        v->cases++;
+        ga_rollout_from(ga, g, &starts[c], GA_EVAL_FLOAT, cfg->dt, steps, got);
+        for (int st = 0; st < steps; ++st)
+        {
+            GAAgent want = st ? got[st - 1] : starts[c];
+            reference_step(ga, g, &want, cfg->dt);
+            agent_fields(ga, &want, fr);
+            agent_fields(ga, &got[st], fg);
+            if (!compare_exact(cfg, v, c, st, fr, fg, 0, CHECK_FIELDS - 1))
+            {
+                v->failed++;
+                break;
+            }
+        }
+
+        // training path: end state and fitness of every genome against the
+        // trajectory checked above
+        v = &out->variant[CHECK_PARALLEL];
+        agent_fields(ga, &got[steps - 1], fr);
+        v->cases++;
+        if (!have_parallel)
+        {
+            v->failed++;
+        }
+        else
+        {
+            agent_fields(ga, &ends[c], fg);
+            if (!compare_exact(cfg, v, c, steps - 1, fr, fg, 0, CHECK_FIELDS - 1))
+                v->failed++;
+        }
+
+        // lanes (vmath.h): one step from every reference state, so the bound
+        // holds the error of a step and not the chaotic drift of a rollout.
+        // SWEEP_LANES consecutive states per batch fill every lane with its
+        // own state and hold count, only some of them due for the network
+        v = &out->variant[CHECK_LANES];
+        v->cases++;
+        for (int st = 0; st < steps; st += SWEEP_LANES)
+        {
+            int count = steps - st < SWEEP_LANES ? steps - st : SWEEP_LANES;
+            float lane_fit[SWEEP_LANES];
+            sweep_rollout_states(ga, g, &traj[st], count, cfg->dt, 1, lane_fit, got);
+            int ok = 1;
+            for (int l = 0; l < count && ok; ++l)
+            {
+                // the lane's cos may fall on the other side of the threshold
+                // and rightly flip the reward
+                if (fabsf(cosf(ref[st + l].theta) - ga->upright_threshold) < 8.f * FLT_EPSILON)
+                    continue;
+                agent_fields(ga, &ref[st + l], fr);
+                agent_fields(ga, &got[l], fg);
+                ok = compare_bound(v, c, st + l, fr, fg, cfg->lane_rel);
+            }
+            if (!ok)
+            {
+                v->failed++;
+                break;
+            }
+        }
+
+        // reduced precision: network output along the reference trajectory
+        QGenome q;
+        uint16_t h16[HALF_MAX + HALF_SLACK] = {0};
+        uint16_t hb16[HALF_MAX + HALF_SLACK] = {0};
+        quant_genome(g, &q, ga->max_speed_factor);
+        half_pack(g, h16, HALF_FP16);
+        half_pack(g, hb16, HALF_BF16);
+        int bad[3] = {0, 0, 0};
+        float werr[3] = {int8_weight_error(g, &q), half_weight_error(g, HALF_FP16), half_weight_error(g, HALF_BF16)};
+        for (int k = 0; k < 3; ++k)
+        {
+            if (werr[k] > 1.f)
+            {
+                bad[k] = 1;
+                note_divergence(&out->variant[CHECK_INT8 + k], c, 0, "weights", 1.f, werr[k]);
+            }
+        }
+        for (int st = 0; st < steps; ++st)
+        {
+            float in[GA_INPUTS];
+            const GAAgent* at = &traj[st];
+            physics_inputs(at->slider_value, at->theta, at->omega, in, PHYSICS_LIBM);
+            float want = ga_eval_network(g, in);
+            float net[3] = {
+                quant_eval_network(&q, in),
+                half_eval_network(h16, HALF_FP16, in),
+                half_eval_network(hb16, HALF_BF16, in),
+            };
+            float bound[3] = {
+                int8_bound(g, &q, in),
+                half_bound(g, HALF_FP16, in),
+                half_bound(g, HALF_BF16, in),
+            };
+            for (int k = 0; k < 3; ++k)
+            {
+                CheckVariant* rv = &out->variant[CHECK_INT8 + k];
+                float e = fabsf(net[k] - want);
+                e = isnan(e) ? INFINITY : e;
+                if (e / bound[k] > rv->max_rel)
+                    rv->max_rel = e / bound[k];
+                if (e > bound[k] && !bad[k])
+                {
+                    bad[k] = 1;
+                    note_divergence(rv, c, st, "output", want, net[k]);
+                }
+            }
+        }
+        static const int modes[3] = {GA_EVAL_INT8, GA_EVAL_FP16, GA_EVAL_BF16};
+        for (int k = 0; k < 3; ++k)
+        {
+            CheckVariant* rv = &out->variant[CHECK_INT8 + k];
+            rv->cases++;
+            rv->failed += bad[k];
+            float fit = ga_rollout_from(ga, g, &starts[c], modes[k], cfg->dt, steps, NULL);
+            rv->fitness_gap += fabsf(fit - ref_fit) / fit_range / (float)n;
+        }
+    }
+    out->seconds = now_sec() - t0;
+
+    free(genomes);
+    free(starts);
+    free(ends);
+    free(traj);
+    free(got);
+    int ok = 1;
+    for (int k = 0; k < CHECK_VARIANTS; ++k)
+    {
+        CheckVariant* v = &out->variant[k];
+        v->gap_failed = k >= CHECK_INT8 && !(v->fitness_gap <= cfg->gap_tol);
+        ok &= v->failed == 0 && !v->gap_failed;
+    }
+    return ok;
+}
+
+void check_print(const CheckConfig* cfg, const CheckReport* r)
+{
+    printf("[CHECK] %d cases x %d steps, dt=%.5f, seed=%u; exact: %d ulp or rel %.1e; lanes: rel %.1e; "
+           "reduced: output within its bound, fitness gap %.3f\n",
+           cfg->cases, cfg->steps, cfg->dt, cfg->seed, cfg->ulp, cfg->rel, cfg->lane_rel, cfg->gap_tol);
+    printf("[CHECK] %-8s %6s %6s %10s %10s %9s  first divergence\n", "kernel", "cases", "failed", "max_ulp",
+           "max_err", "fit_gap");
+    for (int k = 0; k < CHECK_VARIANTS; ++k)
+    {
+        const CheckVariant* v = &r->variant[k];
+        char ulp[16] = "-", gap[16] = "-", div[96];
+        if (v->exact)
+            snprintf(ulp, sizeof(ulp), "%ld", v->max_ulp);
+        else if (k >= CHECK_INT8)
+            snprintf(gap, sizeof(gap), "%.4f", v->fitness_gap);
+        if (v->div_case < 0 && v->gap_failed)
+            snprintf(div, sizeof(div), "fitness gap above %.3f", cfg->gap_tol);
+        else if (v->div_case < 0)
+            snprintf(div, sizeof(div), "none");
+        else
+            snprintf(div, sizeof(div), "case %d step %d %s ref=%.9g got=%.9g", v->div_case, v->div_step,
+                     v->div_field, v->div_ref, v->div_got);
+        printf("[CHECK] %-8s %6d %6d %10s %10.3g %9s  %s\n", v->name, v->cases, v->failed, ulp, v->max_rel, gap, div);
+    }
+    printf("[CHECK] %.2fs\n", r->seconds);
+    fflush(stdout);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ga.h"
+
+// Differential check of the optimized kernels against a scalar float
+// reference, a plain branchy step on libm in check.c that shares only the
+// reward functions and ga_eval_network with the code under test.
+// Random genomes and start states (mid-hold included) go through every variant:
+//   parallel  population pass on the worker threads (the training path):
+//             end state and fitness of every genome
+//   states    ga_rollout_from with states: every step of the trajectory
+//   lanes     SoA lane kernel of the robustness sweep (vmath.h, not libm)
+//   int8 / fp16 / bf16  reduced-precision networks
+// Exact variants pass within `ulp` units in the last place or `rel` relative
+// error per field. Lanes take one step from every reference state, SWEEP_LANES
+// distinct states per batch, and pass within `lane_rel`.
+// Reduced-precision trajectories drift apart by design (the pendulum is
+// chaotic), so those variants are judged on the network output along the
+// reference trajectory, against an error bound derived per input from the
+// quantization steps (check.c), and on the mean fitness gap of their rollouts
+// (`gap_tol`).
+
+#define CHECK_VARIANTS 6
+
+typedef struct
+{
+    int      cases;
+    int      steps;
+    float    dt;
+    unsigned seed;
+    int      ulp;
+    float    rel;
+    float    lane_rel;       // lanes against the reference, one step
+    float    gap_tol;        // reduced: largest mean fitness gap
+} CheckConfig;
+
+typedef struct
+{
+    const char* name;
+    int   exact;
+    int   cases;
+    int   failed;
+    long  max_ulp;        // exact variants
+    float max_rel;        // worst field; reduced: worst output error / its bound
+    float fitness_gap;    // reduced: mean over the cases of |fitness - reference|,
+                          // over the most a rollout can score (upright, full bonus)
+    int   gap_failed;     // reduced: fitness_gap above gap_tol
+    // first divergence
+    int   div_case;       // -1: none
+    int   div_step;
+    const char* div_field;
+    float div_ref;
+    float div_got;
+} CheckVariant;
+
+typedef struct
+{
+    CheckVariant variant[CHECK_VARIANTS];
+    double       seconds;
+} CheckReport;
+
+void check_default_config(const GAContext* ga, CheckConfig* cfg);
+// returns 1 when every variant is within tolerance
+int  check_run(GAContext* ga, const CheckConfig* cfg, CheckReport* out);
+void check_print(const CheckConfig* cfg, const CheckReport* r);
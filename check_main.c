@@ -0,0 +1,63 @@
+#include "check.h"
+#include "ga.h"
+#include "reward.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Headless differential check (check.h) without the window, for ctest:
+//   pendule_check [N] [--check-seed S] [--check-steps N] [--check-ulp U] [--check-rel R]
+//                 [--control-period P] [--reward NAME]
+// The flags are those of `pendule --check`. Exits non-zero on divergence.
+int main(int argc, char** argv)
+{
+    GAContext ga;
+    ga_init(&ga, 1);
+    if (!ga.population)
+    {
+        fprintf(stderr, "cannot allocate the GA context\n");
+        return EXIT_FAILURE;
+    }
+    // the pendulum of the GUI (pendulum_init in a 1400x1050 window)
+    ga_set_env(&ga, 250.f, 900.f, 525.f, 200.f, 100.f, 12.f, 981.f, 0.06f, 12.f, 600.f, -0.98f);
+
+    int period = 1;
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (strcmp(argv[i], "--control-period") == 0)
+            period = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--reward") == 0 && !ga_set_reward(&ga, argv[i + 1]))
+        {
+            fprintf(stderr, "unknown reward '%s', available:", argv[i + 1]);
+            for (int r = 0; r < GA_REWARD_COUNT; ++r)
+                fprintf(stderr, " %s", reward_name(r));
+            fprintf(stderr, "\n");
+            ga_free(&ga);
+            return EXIT_FAILURE;
+        }
+    }
+    ga_set_control_period(&ga, period);
+
+    CheckConfig cfg;
+    check_default_config(&ga, &cfg);
+    if (argc > 1 && atoi(argv[1]) > 0)
+        cfg.cases = atoi(argv[1]);
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (strcmp(argv[i], "--check-seed") == 0)
+            cfg.seed = (unsigned)strtoul(argv[i + 1], NULL, 10);
+        if (strcmp(argv[i], "--check-steps") == 0)
+            cfg.steps = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--check-ulp") == 0)
+            cfg.ulp = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--check-rel") == 0)
+            cfg.rel = strtof(argv[i + 1], NULL);
+    }
+
+    CheckReport report;
+    int ok = check_run(&ga, &cfg, &report);
+    check_print(&cfg, &report);
+    ga_free(&ga);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,245 @@
+#include "control.h"
+#include "physics.h"
+#include "trace.h"
+
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+static unsigned long long now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+static void sleep_until_ns(unsigned long long target)
+{
+    unsigned long long now = now_ns();
+    if (target <= now)
+        return;
+    unsigned long long left = target - now;
+    struct timespec ts;
+    ts.tv_sec = (time_t)(left / 1000000000ull);
+    ts.tv_nsec = (long)(left % 1000000000ull);
+    nanosleep(&ts, NULL);
+}
+
+static int hist_bucket(unsigned long long ns)
+{
+    if (ns < 8)
+        return (int)ns;
+    int msb = 63 - __builtin_clzll(ns);
+    int sub = (int)((ns >> (msb - 3)) & 7);
+    int idx = (msb - 2) * 8 + sub;
+    return idx < CONTROL_HIST_BUCKETS ? idx : CONTROL_HIST_BUCKETS - 1;
+}
+
+static unsigned long long hist_bucket_upper(int idx)
+{
+    if (idx < 8)
+        return (unsigned long long)idx + 1;
+    int msb = idx / 8 + 2;
+    int sub = idx % 8;
+    return (unsigned long long)(9 + sub) << (msb - 3);
+}
+
+void control_hist_reset(ControlHistogram* h)
+{
+    if (!h)
+        return;
+    memset(h, 0, sizeof(*h));
+}
+
+void control_hist_add(ControlHistogram* h, unsigned long long ns)
+{
+    if (!h)
+        return;
+    h->counts[hist_bucket(ns)]++;
+    h->total++;
+    if (ns > h->max_ns)
+        h->max_ns = ns;
+}
+
+float control_hist_percentile_us(const ControlHistogram* h, float pct)
+{
+    if (!h || h->total == 0)
+        return 0.f;
+    unsigned long long rank = (unsigned long long)ceilf((pct / 100.f) * (float)h->total);
+    if (rank < 1)
+        rank = 1;
+    unsigned long long seen = 0;
+    for (int i = 0; i < CONTROL_HIST_BUCKETS; ++i)
+    {
+        seen += h->counts[i];
+        if (seen >= rank)
+        {
+            unsigned long long upper = hist_bucket_upper(i);
+            if (upper > h->max_ns)
+                upper = h->max_ns;
+            return (float)upper / 1000.f;
+        }
+    }
+    return (float)h->max_ns / 1000.f;
+}
+
+static void* control_thread(void* arg)
+{
+    ChampionControl* c = (ChampionControl*)arg;
+    const unsigned long long period = (unsigned long long)(1e9 * (double)c->step);
+    unsigned long long next = now_ns();
+    trace_bind(TRACE_TRACK_CONTROL, "control");
+
+    while (!atomic_load(&c->stop))
+    {
+        next += period;
+        sleep_until_ns(next);
+        unsigned long long woke = now_ns();
+        unsigned long long tr = trace_begin();
+
+        // same inputs as ga_step_agent sees during training
+        float inputs[GA_INPUTS];
+        float state[ENV_STATE];
+        control_lock(c);
+        Pendulum* p = c->pendulum;
+        physics_inputs(p->slider_value, p->theta, p->omega, inputs, PHYSICS_LIBM);
+        state[0] = p->slider_value;
+        state[1] = p->pivot.x - p->track_left;
+        state[2] = p->pivot_vel_x;
+        state[3] = p->theta;
+        state[4] = p->omega;
+        float max_speed = p->max_base_speed;
+        control_unlock(c);
+
+        unsigned long long t0 = now_ns();
+        float out = c->planner ? mppi_plan(c->planner, state) : ga_eval_network(&c->policy, inputs);
+        unsigned long long t1 = now_ns();
+
+        // the command is applied to the very state it was computed from
+        control_lock(c);
+        pendulum_set_base_velocity(c->pendulum, out * max_speed);
+        pendulum_update(c->pendulum, c->step);
+        control_unlock(c);
+
+        pthread_mutex_lock(&c->stats_lock);
+        control_hist_add(&c->jitter, woke > next ? woke - next : 0);
+        control_hist_add(&c->latency, t1 - t0);
+        c->ticks++;
+        // a full period late: drop the missed ticks instead of bursting to
+        // catch up (the pendulum then runs slower than real time)
+        if (now_ns() > next + period)
+        {
+            c->overruns++;
+            next = now_ns();
+        }
+        pthread_mutex_unlock(&c->stats_lock);
+        trace_end(tr, "tick", -1);
+    }
+    return NULL;
+}
+
+void control_init(ChampionControl* c, Pendulum* p, float step)
+{
+    if (!c)
+        return;
+    memset(c, 0, sizeof(*c));
+    c->pendulum = p;
+    c->step = step > 0.f ? step : 1.f / MPPI_RATE_HZ;
+    pthread_mutex_init(&c->lock, NULL);
+    pthread_mutex_init(&c->stats_lock, NULL);
+}
+
+static int start_thread(ChampionControl* c)
+{
+    atomic_store(&c->stop, 0);
+
+    pthread_mutex_lock(&c->stats_lock);
+    control_hist_reset(&c->jitter);
+    control_hist_reset(&c->latency);
+    c->ticks = 0;
+    c->overruns = 0;
+    pthread_mutex_unlock(&c->stats_lock);
+
+    control_lock(c);
+    pendulum_set_external_control(c->pendulum, 1);
+    control_unlock(c);
+
+    if (pthread_create(&c->thread, NULL, control_thread, c) != 0)
+    {
+        control_lock(c);
+        pendulum_set_external_control(c->pendulum, 0);
+        control_unlock(c);
+        return 0;
+    }
+    c->active = 1;
+    return 1;
+}
+
+int control_start(ChampionControl* c, const Genome* policy)
+{
+    if (!c || !c->pendulum || !policy || c->active)
+        return 0;
+    c->policy = *policy;
+    c->planner = NULL;
+    return start_thread(c);
+}
+
+int control_start_planner(ChampionControl* c, Mppi* planner)
+{
+    if (!c || !c->pendulum || !planner || c->active)
+        return 0;
+    c->planner = planner;
+    mppi_reset(planner);
+    return start_thread(c);
+}
+
+void control_stop(ChampionControl* c)
+{
+    if (!c || !c->active)
+        return;
+    atomic_store(&c->stop, 1);
+    pthread_join(c->thread, NULL);
+    c->active = 0;
+
+    control_lock(c);
+    pendulum_set_external_control(c->pendulum, 0);
+    control_unlock(c);
+}
+
+void control_lock(ChampionControl* c)
+{
+    if (c)
+        pthread_mutex_lock(&c->lock);
+}
+
+void control_unlock(ChampionControl* c)
+{
+    if (c)
+        pthread_mutex_unlock(&c->lock);
+}
+
+void control_get_stats(ChampionControl* c, ControlStats* out)
+{
+    if (!c || !out)
+        return;
+    pthread_mutex_lock(&c->stats_lock);
+    out->rate_hz = 1.f / c->step;
+    out->ticks = c->ticks;
+    out->overruns = c->overruns;
+    out->jitter_p50_us = control_hist_percentile_us(&c->jitter, 50.f);
+    out->jitter_p99_us = control_hist_percentile_us(&c->jitter, 99.f);
+    out->jitter_max_us = (float)c->jitter.max_ns / 1000.f;
+    out->infer_p50_us = control_hist_percentile_us(&c->latency, 50.f);
+    out->infer_p99_us = control_hist_percentile_us(&c->latency, 99.f);
+    out->infer_max_us = (float)c->latency.max_ns / 1000.f;
+    pthread_mutex_unlock(&c->stats_lock);
+}
+
+void control_destroy(ChampionControl* c)
+{
+    if (!c)
+        return;
+    control_stop(c);
+    pthread_mutex_destroy(&c->lock);
+    pthread_mutex_destroy(&c->stats_lock);
+}
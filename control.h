@@ -0,0 +1,70 @@
+#pragma once
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "ga.h"
+#include "mppi.h"
+#include "pendulum.h"
+
+#define CONTROL_HIST_BUCKETS    256
+
+// log-linear histogram of durations in nanoseconds (8 sub-buckets per octave)
+typedef struct
+{
+    unsigned long long counts[CONTROL_HIST_BUCKETS];
+    unsigned long long total;
+    unsigned long long max_ns;
+} ControlHistogram;
+
+typedef struct
+{
+    float              rate_hz;
+    unsigned long long ticks;
+    unsigned long long overruns;
+    float              jitter_p50_us;
+    float              jitter_p99_us;
+    float              jitter_max_us;
+    float              infer_p50_us;
+    float              infer_p99_us;
+    float              infer_max_us;
+} ControlStats;
+
+// Drives the interactive Pendulum from a genome (or an MPPI planner) on a
+// dedicated thread that also steps its physics: each tick evaluates the
+// current state and advances the pendulum by one fixed step, so the policy
+// never acts on a stale state and the tick rate is the physics rate.
+// The main thread must hold control_lock() while it touches the pendulum
+// (events, drawing) and must not update it while control is active.
+typedef struct
+{
+    Pendulum*          pendulum;
+    Genome             policy;
+    Mppi*              planner;  // non-NULL: sampling MPC instead of the policy
+    float              step;     // physics step (s), one per tick
+    int                active;
+    atomic_int         stop;
+
+    pthread_t          thread;
+    pthread_mutex_t    lock;
+    pthread_mutex_t    stats_lock;
+
+    ControlHistogram   jitter;
+    ControlHistogram   latency;
+    unsigned long long ticks;
+    unsigned long long overruns;
+} ChampionControl;
+
+void  control_init(ChampionControl* c, Pendulum* p, float step);
+int   control_start(ChampionControl* c, const Genome* policy);
+// the planner stays owned by the caller and must outlive control_stop()
+int   control_start_planner(ChampionControl* c, Mppi* planner);
+void  control_stop(ChampionControl* c);
+void  control_lock(ChampionControl* c);
+void  control_unlock(ChampionControl* c);
+void  control_get_stats(ChampionControl* c, ControlStats* out);
+void  control_destroy(ChampionControl* c);
+
+void  control_hist_reset(ControlHistogram* h);
+void  control_hist_add(ControlHistogram* h, unsigned long long ns);
+float control_hist_percentile_us(const ControlHistogram* h, float pct);
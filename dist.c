@@ -0,0 +1,807 @@
+#ifdef __linux__
+#define _GNU_SOURCE // struct ucred
+#endif
+#include "dist.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+extern char** environ;
+
+#define DIST_GENOME_MAX_BYTES (1 + 4 * (5 + 6 * GA_MAX_HIDDEN))
+#define DIST_MAX_RESULT_BYTES (4u * 65535u) // u16 count of f32
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// explicit little-endian encoding, independent of the host
+static uint8_t* put_u16(uint8_t* p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static uint8_t* put_u32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
+
+static uint8_t* put_f32(uint8_t* p, float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, sizeof(v));
+    return put_u32(p, v);
+}
+
+static uint16_t get_u16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static float get_f32(const uint8_t* p)
+{
+    uint32_t v = get_u32(p);
+    float f;
+    memcpy(&f, &v, sizeof(f));
+    return f;
+}
+
+static uint8_t* put_header(uint8_t* p, int type, int count, uint32_t round, uint32_t batch, uint32_t bytes)
+{
+    *p++ = (uint8_t)type;
+    *p++ = 0;
+    p = put_u16(p, (uint16_t)count);
+    p = put_u32(p, round);
+    p = put_u32(p, batch);
+    return put_u32(p, bytes);
+}
+
+static int send_all(int fd, const uint8_t* buf, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = send(fd, buf, len, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return 0;
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 1;
+}
+
+static int recv_all(int fd, uint8_t* buf, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = recv(fd, buf, len, 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return 0;
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 1;
+}
+
+// "host:port" is TCP, anything else a Unix socket path
+static int addr_is_tcp(const char* addr, char* host, size_t host_len, char* port, size_t port_len)
+{
+    const char* colon = strrchr(addr, ':');
+    if (!colon || strchr(addr, '/'))
+        return 0;
+    size_t hl = (size_t)(colon - addr);
+    if (hl >= host_len || strlen(colon + 1) >= port_len)
+        return 0;
+    memcpy(host, addr, hl);
+    host[hl] = '\0';
+    strcpy(port, colon + 1);
+    return 1;
+}
+
+static int open_socket(const char* addr, int listening)
+{
+    char host[64], port[16];
+    if (addr_is_tcp(addr, host, sizeof(host), port, sizeof(port)))
+    {
+        struct addrinfo hints, *res = NULL;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = listening ? AI_PASSIVE : 0;
+        if (getaddrinfo(host[0] ? host : NULL, port, &hints, &res) != 0)
+            return -1;
+        int fd = -1;
+        for (struct addrinfo* ai = res; ai; ai = ai->ai_next)
+        {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd < 0)
+                continue;
+            int one = 1;
+            if (listening)
+                setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            else
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            int ok = listening ? (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 && listen(fd, DIST_MAX_WORKERS) == 0)
+                               : (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0);
+            if (ok)
+                break;
+            close(fd);
+            fd = -1;
+        }
+        freeaddrinfo(res);
+        return fd;
+    }
+
+    struct sockaddr_un sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sun_family = AF_UNIX;
+    if (strlen(addr) >= sizeof(sa.sun_path))
+        return -1;
+    strcpy(sa.sun_path, addr);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    if (listening)
+    {
+        unlink(addr);
+        if (bind(fd, (struct sockaddr*)&sa, sizeof(sa)) != 0 || listen(fd, DIST_MAX_WORKERS) != 0)
+        {
+            close(fd);
+            return -1;
+        }
+    }
+    else if (connect(fd, (struct sockaddr*)&sa, sizeof(sa)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+DistPool* dist_open(const char* addr)
+{
+    signal(SIGPIPE, SIG_IGN);
+    DistPool* pool = calloc(1, sizeof(DistPool));
+    if (!pool)
+        return NULL;
+    if (addr && addr[0])
+        snprintf(pool->addr, sizeof(pool->addr), "%s", addr);
+    else
+        snprintf(pool->addr, sizeof(pool->addr), "/tmp/pendule-%d.sock", (int)getpid());
+    pool->listen_fd = open_socket(pool->addr, 1);
+    if (pool->listen_fd < 0)
+    {
+        free(pool);
+        return NULL;
+    }
+    fcntl(pool->listen_fd, F_SETFL, fcntl(pool->listen_fd, F_GETFL) | O_NONBLOCK);
+    pool->batch_size = DIST_BATCH_DEFAULT;
+    pool->depth = DIST_DEPTH_DEFAULT;
+    pool->timeout = DIST_TIMEOUT_SEC;
+    return pool;
+}
+
+int dist_spawn_local(DistPool* pool, const char* exe, int count)
+{
+    if (!pool || !exe)
+        return 0;
+    int spawned = 0;
+    for (int i = 0; i < count && pool->spawned_count < DIST_MAX_WORKERS; ++i)
+    {
+        char* args[] = {(char*)exe, "--worker", pool->addr, NULL};
+        pid_t pid;
+        if (posix_spawn(&pid, exe, NULL, NULL, args, environ) != 0)
+            break;
+        pool->spawned[pool->spawned_count++] = pid;
+        spawned++;
+    }
+    return spawned;
+}
+
+// pid of a worker this pool spawned, from the kernel's credentials of the
+// Unix socket peer; 0 for TCP peers, which may be on another host, and for
+// anything not in spawned[]. The pid in HELLO is the peer's word and never used
+static pid_t spawned_peer(const DistPool* pool, int fd)
+{
+#ifdef SO_PEERCRED
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0 || cred.pid <= 0)
+        return 0;
+    for (int i = 0; i < pool->spawned_count; ++i)
+    {
+        if (pool->spawned[i] == cred.pid)
+            return cred.pid;
+    }
+#else
+    (void)pool;
+    (void)fd;
+#endif
+    return 0;
+}
+
+static void accept_pending(DistPool* pool)
+{
+    for (;;)
+    {
+        int fd = accept(pool->listen_fd, NULL, NULL);
+        if (fd < 0)
+            return;
+        int slot = -1;
+        for (int i = 0; i < pool->worker_count; ++i)
+        {
+            if (!pool->workers[i].alive)
+            {
+                slot = i;
+                break;
+            }
+        }
+        if (slot < 0 && pool->worker_count < DIST_MAX_WORKERS)
+            slot = pool->worker_count++;
+        if (slot < 0)
+        {
+            close(fd);
+            continue;
+        }
+        // blocking sends with a bound, so a stuck worker cannot stall the master
+        struct timeval tv = {2, 0};
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        DistWorker* w = &pool->workers[slot];
+        free(w->rbuf);
+        memset(w, 0, sizeof(*w));
+        w->fd = fd;
+        w->pid = spawned_peer(pool, fd);
+        w->alive = 1;
+    }
+}
+
+int dist_alive_workers(const DistPool* pool)
+{
+    if (!pool)
+        return 0;
+    int n = 0;
+    for (int i = 0; i < pool->worker_count; ++i)
+        n += pool->workers[i].alive;
+    return n;
+}
+
+int dist_wait_workers(DistPool* pool, int count, double timeout_sec)
+{
+    if (!pool)
+        return 0;
+    double end = now_sec() + timeout_sec;
+    while (dist_alive_workers(pool) < count && now_sec() < end)
+    {
+        struct pollfd pfd = {pool->listen_fd, POLLIN, 0};
+        poll(&pfd, 1, 20);
+        accept_pending(pool);
+    }
+    return dist_alive_workers(pool);
+}
+
+static void worker_lost(DistPool* pool, int index)
+{
+    DistWorker* w = &pool->workers[index];
+    if (!w->alive)
+        return;
+    close(w->fd);
+    w->alive = 0;
+    w->inflight = 0;
+    // our own unreaped child: its pid cannot have been reused yet
+    if (w->pid > 0)
+    {
+        kill(w->pid, SIGKILL);
+        waitpid(w->pid, NULL, WNOHANG);
+        w->pid = 0;
+    }
+    pool->lost_workers++;
+    for (int b = 0; b < pool->batch_cap; ++b)
+    {
+        if (pool->batches[b].worker == index && !pool->batches[b].done)
+        {
+            pool->batches[b].worker = -1;
+            pool->last_redispatched++;
+        }
+    }
+}
+
+static int send_env(DistPool* pool, int index, const GAContext* ga, float dt, int steps)
+{
+    uint8_t buf[DIST_HEADER_BYTES + 4 * DIST_ENV_FIELDS];
+    const float env[DIST_ENV_FIELDS] = {
+        ga->track_left, ga->track_width, ga->pivot_y, ga->length, ga->base_k, ga->base_d,
+        ga->gravity, ga->damping, ga->max_speed_factor, ga->max_base_speed, ga->upright_threshold,
+        ga->eval_duration, dt, (float)steps, (float)ga->reward,
+        ga->reward_bonus, ga->reward_drop, ga->reward_effort, (float)ga->control_period
+    };
+    uint8_t* p = put_header(buf, DIST_MSG_ENV, DIST_ENV_FIELDS, pool->round, 0, 4 * DIST_ENV_FIELDS);
+    for (int i = 0; i < DIST_ENV_FIELDS; ++i)
+        p = put_f32(p, env[i]);
+    return send_all(pool->workers[index].fd, buf, sizeof(buf));
+}
+
+static uint8_t* put_genome(uint8_t* p, const Genome* g)
+{
+    *p++ = (uint8_t)g->hidden;
+    p = put_f32(p, g->b_out);
+    for (int j = 0; j < GA_INPUTS; ++j)
+        p = put_f32(p, g->w_direct[j]);
+    for (int i = 0; i < g->hidden; ++i)
+    {
+        for (int j = 0; j < GA_INPUTS; ++j)
+            p = put_f32(p, g->w_in[i][j]);
+        p = put_f32(p, g->b_h[i]);
+        p = put_f32(p, g->w_out[i]);
+    }
+    return p;
+}
+
+static const uint8_t* get_genome(const uint8_t* p, const uint8_t* end, Genome* g)
+{
+    memset(g, 0, sizeof(*g));
+    if (p >= end)
+        return NULL;
+    g->hidden = *p++;
+    if (g->hidden > GA_MAX_HIDDEN || end - p < 4 * (5 + 6 * g->hidden))
+        return NULL;
+    g->b_out = get_f32(p);
+    p += 4;
+    for (int j = 0; j < GA_INPUTS; ++j, p += 4)
+        g->w_direct[j] = get_f32(p);
+    for (int i = 0; i < g->hidden; ++i)
+    {
+        for (int j = 0; j < GA_INPUTS; ++j, p += 4)
+            g->w_in[i][j] = get_f32(p);
+        g->b_h[i] = get_f32(p);
+        g->w_out[i] = get_f32(p + 4);
+        p += 8;
+    }
+    return p;
+}
+
+static int send_batch(DistPool* pool, int index, int b, const GAContext* ga, uint8_t* buf)
+{
+    const DistBatch* batch = &pool->batches[b];
+    uint8_t* p = buf + DIST_HEADER_BYTES;
+    for (int i = 0; i < batch->count; ++i)
+        p = put_genome(p, &ga->population[batch->start + i]);
+    uint32_t bytes = (uint32_t)(p - buf - DIST_HEADER_BYTES);
+    put_header(buf, DIST_MSG_BATCH, batch->count, pool->round, (uint32_t)b, bytes);
+    return send_all(pool->workers[index].fd, buf, (size_t)(p - buf));
+}
+
+// drain whatever the worker sent; returns 0 if the connection is gone
+static int read_worker(DistPool* pool, int index, GAContext* ga, int batch_count, int* remaining)
+{
+    DistWorker* w = &pool->workers[index];
+    for (;;)
+    {
+        // one full frame at most per call, the rest waits in the socket
+        if (w->rlen >= DIST_HEADER_BYTES + DIST_MAX_RESULT_BYTES)
+            break;
+        if (w->rcap - w->rlen < 4096)
+        {
+            size_t cap = w->rcap ? w->rcap * 2 : 16384;
+            uint8_t* nb = realloc(w->rbuf, cap);
+            if (!nb)
+                return 0;
+            w->rbuf = nb;
+            w->rcap = cap;
+        }
+        ssize_t n = recv(w->fd, w->rbuf + w->rlen, w->rcap - w->rlen, MSG_DONTWAIT);
+        if (n == 0)
+            return 0;
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            return 0;
+        }
+        w->rlen += (size_t)n;
+    }
+
+    size_t at = 0;
+    while (w->rlen - at >= DIST_HEADER_BYTES)
+    {
+        const uint8_t* h = w->rbuf + at;
+        int type = h[0];
+        int count = get_u16(h + 2);
+        uint32_t round = get_u32(h + 4);
+        uint32_t b = get_u32(h + 8);
+        uint32_t bytes = get_u32(h + 12);
+        // a worker only sends HELLO and RESULT frames; anything larger is a
+        // broken or hostile peer, dropped before rbuf grows to fit it
+        if (bytes > DIST_MAX_RESULT_BYTES)
+            return 0;
+        if (w->rlen - at < DIST_HEADER_BYTES + (size_t)bytes)
+            break;
+        const uint8_t* payload = h + DIST_HEADER_BYTES;
+        if (type == DIST_MSG_RESULT && round == pool->round && b < (uint32_t)batch_count)
+        {
+            DistBatch* batch = &pool->batches[b];
+            if (batch->worker == index)
+                w->inflight--;
+            // late answer for a re-dispatched batch is still good, first one wins
+            if (!batch->done && count == batch->count && bytes == 4u * (uint32_t)count)
+            {
+                for (int i = 0; i < count; ++i)
+                    ga->population[batch->start + i].fitness = get_f32(payload + 4 * i);
+                batch->done = 1;
+                (*remaining)--;
+                w->evals += (unsigned long long)count;
+            }
+        }
+        at += DIST_HEADER_BYTES + bytes;
+    }
+    memmove(w->rbuf, w->rbuf + at, w->rlen - at);
+    w->rlen -= at;
+    return 1;
+}
+
+// One generation of fitness: every genome of the population is evaluated exactly
+// once (from the standard start state, float weights) and written back.
+int dist_evaluate(DistPool* pool, GAContext* ga, float dt)
+{
+    if (!pool || !ga || !ga->population || ga->population_size < 1)
+        return 0;
+    if (dt <= 0.f)
+        dt = 1.f / 120.f;
+    int steps = (int)ceilf(ga->eval_duration / dt);
+    if (steps < 1)
+        steps = 1;
+    int n = ga->population_size;
+    int bs = pool->batch_size > 0 ? pool->batch_size : DIST_BATCH_DEFAULT;
+    if (bs > 65535)
+        bs = 65535;
+    int batch_count = (n + bs - 1) / bs;
+    if (batch_count > pool->batch_cap)
+    {
+        DistBatch* nb = realloc(pool->batches, (size_t)batch_count * sizeof(DistBatch));
+        if (!nb)
+            return 0;
+        pool->batches = nb;
+        pool->batch_cap = batch_count;
+    }
+    for (int b = 0; b < batch_count; ++b)
+    {
+        pool->batches[b].start = b * bs;
+        pool->batches[b].count = (b + 1) * bs <= n ? bs : n - b * bs;
+        pool->batches[b].worker = -1;
+        pool->batches[b].done = 0;
+        pool->batches[b].deadline = 0.0;
+    }
+    for (int b = batch_count; b < pool->batch_cap; ++b)
+    {
+        pool->batches[b].worker = -1;
+        pool->batches[b].done = 1;
+    }
+    uint8_t* sendbuf = malloc(DIST_HEADER_BYTES + (size_t)bs * DIST_GENOME_MAX_BYTES);
+    if (!sendbuf)
+        return 0;
+
+    pool->round++;
+    pool->last_redispatched = 0;
+    pool->last_local = 0;
+    for (int i = 0; i < pool->worker_count; ++i)
+        pool->workers[i].inflight = 0;
+    int remaining = batch_count;
+    double t0 = now_sec();
+    int used = 0;
+    struct pollfd pfds[DIST_MAX_WORKERS + 1];
+    int pidx[DIST_MAX_WORKERS + 1];
+
+    while (remaining > 0)
+    {
+        accept_pending(pool);
+
+        // fill every live worker's pipeline
+        int next = 0;
+        for (int i = 0; i < pool->worker_count; ++i)
+        {
+            DistWorker* w = &pool->workers[i];
+            if (w->alive && w->env_round != pool->round)
+            {
+                if (!send_env(pool, i, ga, dt, steps))
+                {
+                    worker_lost(pool, i);
+                    continue;
+                }
+                w->env_round = pool->round;
+            }
+            while (w->alive && w->inflight < pool->depth)
+            {
+                while (next < batch_count && (pool->batches[next].done || pool->batches[next].worker >= 0))
+                    next++;
+                if (next >= batch_count)
+                    break;
+                if (!send_batch(pool, i, next, ga, sendbuf))
+                {
+                    worker_lost(pool, i);
+                    next = 0;
+                    break;
+                }
+                pool->batches[next].worker = i;
+                pool->batches[next].deadline = now_sec() + pool->timeout;
+                w->inflight++;
+            }
+        }
+
+        int alive = dist_alive_workers(pool);
+        if (alive > used)
+            used = alive;
+        if (alive == 0)
+        {
+            // nobody left: finish in-process so the generation still completes
+            for (int b = 0; b < batch_count; ++b)
+            {
+                DistBatch* batch = &pool->batches[b];
+                if (batch->done)
+                    continue;
+                for (int i = 0; i < batch->count; ++i)
+                {
+                    Genome* g = &ga->population[batch->start + i];
+                    g->fitness = ga_rollout(ga, g, dt, steps, NULL);
+                }
+                batch->done = 1;
+                pool->last_local += batch->count;
+                remaining--;
+            }
+            break;
+        }
+
+        int nfds = 0;
+        pfds[nfds] = (struct pollfd){pool->listen_fd, POLLIN, 0};
+        pidx[nfds++] = -1;
+        for (int i = 0; i < pool->worker_count; ++i)
+        {
+            if (!pool->workers[i].alive)
+                continue;
+            pfds[nfds] = (struct pollfd){pool->workers[i].fd, POLLIN, 0};
+            pidx[nfds++] = i;
+        }
+        poll(pfds, (nfds_t)nfds, 20);
+        for (int k = 1; k < nfds; ++k)
+        {
+            if (pfds[k].revents && !read_worker(pool, pidx[k], ga, batch_count, &remaining))
+                worker_lost(pool, pidx[k]);
+        }
+
+        double now = now_sec();
+        for (int b = 0; b < batch_count; ++b)
+        {
+            DistBatch* batch = &pool->batches[b];
+            if (!batch->done && batch->worker >= 0 && now > batch->deadline)
+                worker_lost(pool, batch->worker);
+        }
+    }
+    free(sendbuf);
+
+    ga->best_index = 0;
+    for (int i = 1; i < n; ++i)
+    {
+        if (ga->population[i].fitness > ga->population[ga->best_index].fitness)
+            ga->best_index = i;
+    }
+    pool->last_workers = used;
+    pool->last_seconds = now_sec() - t0;
+    pool->last_evals_per_sec = (float)((double)n / (pool->last_seconds > 1e-9 ? pool->last_seconds : 1e-9));
+    return n;
+}
+
+void dist_close(DistPool* pool)
+{
+    if (!pool)
+        return;
+    // closing the sockets is the shutdown signal
+    for (int i = 0; i < pool->worker_count; ++i)
+    {
+        if (pool->workers[i].alive)
+            close(pool->workers[i].fd);
+        free(pool->workers[i].rbuf);
+    }
+    close(pool->listen_fd);
+    if (!strchr(pool->addr, ':') || strchr(pool->addr, '/'))
+        unlink(pool->addr);
+    double end = now_sec() + 1.0;
+    for (int i = 0; i < pool->spawned_count; ++i)
+    {
+        while (waitpid(pool->spawned[i], NULL, WNOHANG) == 0)
+        {
+            if (now_sec() > end)
+            {
+                kill(pool->spawned[i], SIGKILL);
+                waitpid(pool->spawned[i], NULL, 0);
+                break;
+            }
+            usleep(1000);
+        }
+    }
+    free(pool->batches);
+    free(pool);
+}
+
+// Worker process: evaluates batches until the master closes the connection.
+int dist_worker_main(const char* addr)
+{
+    signal(SIGPIPE, SIG_IGN);
+    int fd = -1;
+    double end = now_sec() + 10.0;
+    while ((fd = open_socket(addr, 0)) < 0 && now_sec() < end)
+        usleep(20000);
+    if (fd < 0)
+    {
+        fprintf(stderr, "[DIST] worker: cannot connect to %s\n", addr);
+        return 1;
+    }
+
+    uint8_t hello[DIST_HEADER_BYTES + 4];
+    put_u32(put_header(hello, DIST_MSG_HELLO, 0, 0, 0, 4), (uint32_t)getpid());
+    if (!send_all(fd, hello, sizeof(hello)))
+    {
+        close(fd);
+        return 1;
+    }
+
+    GAContext ga;
+    ga_init(&ga, 1);
+    float dt = 1.f / 120.f;
+    int steps = 1;
+    uint8_t* payload = NULL;
+    size_t payload_cap = 0;
+    float* fitness = NULL;
+    uint8_t* out = NULL;
+    int out_cap = 0;
+    uint8_t h[DIST_HEADER_BYTES];
+    while (recv_all(fd, h, sizeof(h)))
+    {
+        int type = h[0];
+        int count = get_u16(h + 2);
+        uint32_t round = get_u32(h + 4);
+        uint32_t batch = get_u32(h + 8);
+        uint32_t bytes = get_u32(h + 12);
+        if (bytes > 65535u * DIST_GENOME_MAX_BYTES)
+            break;
+        if (bytes > payload_cap)
+        {
+            uint8_t* nb = realloc(payload, bytes);
+            if (!nb)
+                break;
+            payload = nb;
+            payload_cap = bytes;
+        }
+        if (bytes && !recv_all(fd, payload, bytes))
+            break;
+
+        if (type == DIST_MSG_ENV && bytes >= 4 * DIST_ENV_FIELDS)
+        {
+            float e[DIST_ENV_FIELDS];
+            for (int i = 0; i < DIST_ENV_FIELDS; ++i)
+                e[i] = get_f32(payload + 4 * i);
+            ga_set_env(&ga, e[0], e[1], e[2], e[3], e[4], e[5], e[6], e[7], e[8], e[9], e[10]);
+            ga.eval_duration = e[11];
+            dt = e[12];
+            steps = (int)e[13];
+            ga.reward = (int)e[14];
+            ga.reward_bonus = e[15];
+            ga.reward_drop = e[16];
+            ga.reward_effort = e[17];
+            ga_set_control_period(&ga, (int)e[18]);
+        }
+        else if (type == DIST_MSG_BATCH)
+        {
+            if (count > out_cap)
+            {
+                float* nf = realloc(fitness, (size_t)count * sizeof(float));
+                uint8_t* no = nf ? realloc(out, DIST_HEADER_BYTES + (size_t)count * 4) : NULL;
+                if (nf)
+                    fitness = nf;
+                if (no)
+                    out = no;
+                if (!nf || !no)
+                    break;
+                out_cap = count;
+            }
+            const uint8_t* p = payload;
+            const uint8_t* pend = payload + bytes;
+            int ok = 1;
+            for (int i = 0; i < count && ok; ++i)
+            {
+                Genome g;
+                p = get_genome(p, pend, &g);
+                if (!p)
+                    ok = 0;
+                else
+                    fitness[i] = ga_rollout(&ga, &g, dt, steps, NULL);
+            }
+            if (!ok)
+                break;
+            uint8_t* q = put_header(out, DIST_MSG_RESULT, count, round, batch, 4u * (uint32_t)count);
+            for (int i = 0; i < count; ++i)
+                q = put_f32(q, fitness[i]);
+            if (!send_all(fd, out, (size_t)(q - out)))
+                break;
+        }
+    }
+    free(payload);
+    free(fitness);
+    free(out);
+    ga_free(&ga);
+    close(fd);
+    return 0;
+}
+
+// evals/s for 1..max_workers local worker processes on the same population
+int dist_bench(const char* exe, GAContext* ga, float dt, int max_workers, int rounds)
+{
+    if (!exe || !ga || max_workers < 1)
+        return 0;
+    if (rounds < 1)
+        rounds = 1;
+    float base = 0.f;
+    printf("[DIST] %d genomes x %d rounds, batch %d, depth %d\n",
+           ga->population_size, rounds, DIST_BATCH_DEFAULT, DIST_DEPTH_DEFAULT);
+    printf("workers,evals_per_sec,speedup,redispatched,local\n");
+    for (int n = 1; n <= max_workers; ++n)
+    {
+        DistPool* pool = dist_open(NULL);
+        if (!pool)
+            return 0;
+        dist_spawn_local(pool, exe, n);
+        if (dist_wait_workers(pool, n, 10.0) < n)
+        {
+            fprintf(stderr, "[DIST] only %d/%d workers connected\n", dist_alive_workers(pool), n);
+            dist_close(pool);
+            return 0;
+        }
+        double secs = 0.0;
+        int redispatched = 0, local = 0;
+        for (int r = 0; r < rounds; ++r)
+        {
+            dist_evaluate(pool, ga, dt);
+            secs += pool->last_seconds;
+            redispatched += pool->last_redispatched;
+            local += pool->last_local;
+        }
+        float eps = (float)((double)ga->population_size * rounds / (secs > 1e-9 ? secs : 1e-9));
+        if (n == 1)
+            base = eps;
+        printf("%d,%.0f,%.2f,%d,%d\n", n, eps, base > 0.f ? eps / base : 0.f, redispatched, local);
+        fflush(stdout);
+        dist_close(pool);
+    }
+    return 1;
+}
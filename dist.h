@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "ga.h"
+
+// Distributed evaluation: the process owning the GAContext listens on a Unix
+// socket path or "host:port", worker processes (`pendule --worker ADDR`)
+// connect, and every generation is cut into batches shipped over the sockets.
+//
+// Wire format, little-endian, 16-byte header then payload:
+//   u8 type | u8 reserved | u16 count | u32 round | u32 batch | u32 payload bytes
+//   DIST_MSG_HELLO   worker -> master, u32 pid (informational only)
+//   DIST_MSG_ENV     master -> worker, DIST_ENV_FIELDS f32 (physics, dt, steps, reward and its weights, control period)
+//   DIST_MSG_BATCH   master -> worker, `count` genomes: u8 hidden, then
+//                    (5 + 6 * hidden) f32 (b_out, w_direct, per unit w_in/b_h/w_out)
+//   DIST_MSG_RESULT  worker -> master, `count` f32 fitness
+// Each worker keeps up to `depth` batches in flight. A batch that is not back
+// before its deadline, or whose worker hangs up, is re-queued to the others.
+
+#define DIST_MAX_WORKERS   64
+#define DIST_HEADER_BYTES  16
+#define DIST_ENV_FIELDS    19
+#define DIST_BATCH_DEFAULT 32
+#define DIST_DEPTH_DEFAULT 2
+#define DIST_TIMEOUT_SEC   5.0
+
+#define DIST_MSG_HELLO  1
+#define DIST_MSG_ENV    2
+#define DIST_MSG_BATCH  3
+#define DIST_MSG_RESULT 4
+
+typedef struct
+{
+    int      fd;
+    pid_t    pid;       // > 0: our child from dist_spawn_local, by Unix socket peer credentials
+    int      alive;
+    int      inflight;
+    uint32_t env_round; // last round the ENV message was sent for
+    uint8_t* rbuf;
+    size_t   rlen;
+    size_t   rcap;
+    unsigned long long evals;
+} DistWorker;
+
+typedef struct
+{
+    int    start;
+    int    count;
+    int    worker; // -1 queued
+    int    done;
+    double deadline;
+} DistBatch;
+
+typedef struct DistPool
+{
+    int        listen_fd;
+    char       addr[108];
+    int        batch_size;
+    int        depth;
+    double     timeout;
+    uint32_t   round;
+    DistWorker workers[DIST_MAX_WORKERS];
+    int        worker_count;
+    DistBatch* batches;
+    int        batch_cap;
+    pid_t      spawned[DIST_MAX_WORKERS];
+    int        spawned_count;
+
+    // last dist_evaluate
+    int    last_workers;
+    double last_seconds;
+    float  last_evals_per_sec;
+    int    last_redispatched;
+    int    last_local;  // genomes evaluated in-process because no worker was left
+    int    lost_workers;
+} DistPool;
+
+DistPool* dist_open(const char* addr);
+int   dist_spawn_local(DistPool* pool, const char* exe, int count);
+int   dist_wait_workers(DistPool* pool, int count, double timeout_sec);
+int   dist_alive_workers(const DistPool* pool);
+int   dist_evaluate(DistPool* pool, GAContext* ga, float dt);
+void  dist_close(DistPool* pool);
+
+int   dist_worker_main(const char* addr);
+int   dist_bench(const char* exe, GAContext* ga, float dt, int max_workers, int rounds);
@@ -0,0 +1,451 @@
+#include "env.h"
+#include "ga.h"
+#include "physics.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ENV_JOB_RESET 0
+#define ENV_JOB_STEP  1
+
+typedef struct
+{
+    EnvBatch* e;
+    int       start;
+    int       end;
+    pthread_t thread;
+} EnvWorker;
+
+struct EnvBatch
+{
+    EnvConfig cfg;
+    GAContext ga;            // physics and reward weights, in the form reward.h takes them
+    int       padded;        // count rounded up to ENV_LANES, the tail lanes are stepped and dropped
+    int       episode_steps;
+
+    // SoA state, `padded` entries each
+    float*    slider;
+    float*    pivot_x;
+    float*    pivot_v;
+    float*    theta;
+    float*    omega;
+    float*    above;
+    float*    fitness;
+    int*      steps;
+    unsigned* rng;
+    void*     block;
+
+    int       threads;
+    EnvWorker workers[ENV_MAX_THREADS];
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;
+    pthread_cond_t  done;
+    unsigned long   epoch;   // everything below is guarded by the lock
+    int             pending;
+    int             stop;
+
+    // current job, read by the workers after the epoch changes
+    int            job;
+    const uint8_t* mask;
+    const float*   actions;
+    float*         obs;
+    float*         rewards;
+    uint8_t*       dones;
+};
+
+typedef struct
+{
+    float slider[ENV_LANES];
+    float pivot_x[ENV_LANES];
+    float pivot_v[ENV_LANES];
+    float theta[ENV_LANES];
+    float omega[ENV_LANES];
+    float above[ENV_LANES];
+    float fitness[ENV_LANES];
+} EnvLanes;
+
+void env_default_config(EnvConfig* cfg)
+{
+    if (!cfg)
+        return;
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->count = 1024;
+    cfg->threads = 0;
+    cfg->dt = 1.f / 120.f;
+    cfg->control_period = 1;
+    cfg->episode_seconds = 15.f;
+    cfg->reward = GA_REWARD_UPRIGHT;
+    cfg->track_width = 900.f;
+    cfg->length = 200.f;
+    cfg->gravity = 981.f;
+    cfg->damping = 0.06f;
+    cfg->base_k = 100.f;
+    cfg->base_d = 12.f;
+    cfg->max_speed_factor = 12.f;
+    cfg->max_base_speed = 600.f;
+    cfg->upright_threshold = -0.98f;
+    cfg->reward_bonus = 0.3f;
+    cfg->reward_drop = 0.6f;
+    cfg->reward_effort = 0.2f;
+    cfg->seed = 1;
+}
+
+static float env_frand(unsigned* s)
+{
+    unsigned x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return (float)(x >> 8) * (2.f / 16777216.f) - 1.f;
+}
+
+static void write_obs(const EnvBatch* e, int i, float* obs)
+{
+    physics_inputs(e->slider[i], e->theta[i], e->omega[i], &obs[(size_t)i * ENV_OBS], PHYSICS_VMATH);
+}
+
+// same start as the GA's agents, plus the configured noise
+static void reset_range(EnvBatch* e, int start, int end)
+{
+    const GAContext* ga = &e->ga;
+    for (int i = start; i < end; ++i)
+    {
+        if (i < e->cfg.count && e->mask && !e->mask[i])
+            continue;
+        PhysicsState s;
+        physics_reset(ga, &s);
+        e->slider[i] = s.slider;
+        e->pivot_x[i] = s.pivot_x;
+        e->pivot_v[i] = s.pivot_v;
+        e->theta[i] = s.theta + env_frand(&e->rng[i]) * e->cfg.theta_noise;
+        e->omega[i] = s.omega + env_frand(&e->rng[i]) * e->cfg.omega_noise;
+        e->above[i] = s.above;
+        e->fitness[i] = s.fitness;
+        e->steps[i] = 0;
+        if (e->obs && i < e->cfg.count)
+            write_obs(e, i, e->obs);
+    }
+}
+
+// physics_step (physics.h), lane-innermost as in sweep.c
+static GA_ALWAYS_INLINE void step_range(EnvBatch* e, int start, int end, const int reward)
+{
+    const GAContext* ga = &e->ga;
+    const float dt = e->cfg.dt;
+    const int period = e->cfg.control_period;
+    const int count = e->cfg.count;
+    const PhysicsBody body = physics_body(ga);
+    for (int first = start; first < end; first += ENV_LANES)
+    {
+        int n = count - first < ENV_LANES ? count - first : ENV_LANES;
+        EnvLanes L;
+        float control[ENV_LANES] = {0};
+        float before[ENV_LANES];
+        for (int l = 0; l < n; ++l)
+            control[l] = e->actions[first + l];
+        for (int l = 0; l < ENV_LANES; ++l)
+        {
+            int i = first + l;
+            float a = control[l] < -1.f ? -1.f : control[l];
+            a = a > 1.f ? 1.f : a;
+            control[l] = a * ga->max_base_speed;
+            L.slider[l] = e->slider[i];
+            L.pivot_x[l] = e->pivot_x[i];
+            L.pivot_v[l] = e->pivot_v[i];
+            L.theta[l] = e->theta[i];
+            L.omega[l] = e->omega[i];
+            L.above[l] = e->above[i];
+            L.fitness[l] = e->fitness[i];
+            before[l] = L.fitness[l];
+        }
+
+        for (int k = 0; k < period; ++k)
+        {
+            for (int l = 0; l < ENV_LANES; ++l)
+            {
+                PhysicsState s = {L.slider[l], L.pivot_x[l], L.pivot_v[l], L.theta[l], L.omega[l], L.above[l],
+                                  L.fitness[l]};
+                physics_step(ga, &body, &s, control[l], dt, reward, PHYSICS_VMATH);
+                L.slider[l] = s.slider;
+                L.pivot_x[l] = s.pivot_x;
+                L.pivot_v[l] = s.pivot_v;
+                L.theta[l] = s.theta;
+                L.omega[l] = s.omega;
+                L.above[l] = s.above;
+                L.fitness[l] = s.fitness;
+            }
+        }
+
+        for (int l = 0; l < ENV_LANES; ++l)
+        {
+            int i = first + l;
+            e->slider[i] = L.slider[l];
+            e->pivot_x[i] = L.pivot_x[l];
+            e->pivot_v[i] = L.pivot_v[l];
+            e->theta[i] = L.theta[l];
+            e->omega[i] = L.omega[l];
+            e->above[i] = L.above[l];
+            e->fitness[i] = L.fitness[l];
+            e->steps[i] += period;
+        }
+        if (e->obs)
+        {
+            // the whole block, then the live envs
+            float obs[ENV_LANES][ENV_OBS];
+            for (int l = 0; l < ENV_LANES; ++l)
+                physics_inputs(L.slider[l], L.theta[l], L.omega[l], obs[l], PHYSICS_VMATH);
+            memcpy(&e->obs[(size_t)first * ENV_OBS], obs, (size_t)n * sizeof(obs[0]));
+        }
+        for (int l = 0; l < n; ++l)
+        {
+            int i = first + l;
+            if (e->rewards)
+                e->rewards[i] = L.fitness[l] - before[l];
+            if (e->dones)
+                e->dones[i] = e->steps[i] >= e->episode_steps;
+        }
+    }
+}
+
+#define ENV_REWARD_STEP(id, fn, name)                             \
+    static void step_##fn(EnvBatch* e, int start, int end)        \
+    {                                                             \
+        step_range(e, start, end, GA_REWARD_##id);                \
+    }
+GA_REWARD_LIST(ENV_REWARD_STEP)
+#undef ENV_REWARD_STEP
+
+static void run_range(EnvBatch* e, int start, int end)
+{
+    if (e->job == ENV_JOB_RESET)
+    {
+        reset_range(e, start, end);
+        return;
+    }
+    switch (e->cfg.reward)
+    {
+#define ENV_REWARD_DISPATCH(id, fn, name) \
+    case GA_REWARD_##id:                  \
+        step_##fn(e, start, end);         \
+        break;
+        GA_REWARD_LIST(ENV_REWARD_DISPATCH)
+#undef ENV_REWARD_DISPATCH
+    }
+}
+
+static void* env_worker(void* arg)
+{
+    EnvWorker* w = (EnvWorker*)arg;
+    EnvBatch* e = w->e;
+    unsigned long seen = 0;
+    for (;;)
+    {
+        pthread_mutex_lock(&e->lock);
+        while (e->epoch == seen && !e->stop)
+            pthread_cond_wait(&e->wake, &e->lock);
+        if (e->stop)
+        {
+            pthread_mutex_unlock(&e->lock);
+            break;
+        }
+        seen = e->epoch;
+        pthread_mutex_unlock(&e->lock);
+
+        run_range(e, w->start, w->end);
+
+        pthread_mutex_lock(&e->lock);
+        if (--e->pending == 0)
+            pthread_cond_signal(&e->done);
+        pthread_mutex_unlock(&e->lock);
+    }
+    return NULL;
+}
+
+// worker 0 is the calling thread
+static void run_job(EnvBatch* e)
+{
+    if (e->threads > 1)
+    {
+        pthread_mutex_lock(&e->lock);
+        e->pending = e->threads - 1;
+        e->epoch++;
+        pthread_cond_broadcast(&e->wake);
+        pthread_mutex_unlock(&e->lock);
+    }
+    run_range(e, e->workers[0].start, e->workers[0].end);
+    if (e->threads > 1)
+    {
+        pthread_mutex_lock(&e->lock);
+        while (e->pending > 0)
+            pthread_cond_wait(&e->done, &e->lock);
+        pthread_mutex_unlock(&e->lock);
+    }
+}
+
+EnvBatch* env_create(const EnvConfig* cfg)
+{
+    if (!cfg || cfg->count < 1 || cfg->dt <= 0.f || cfg->control_period < 1 || cfg->reward < 0
+        || cfg->reward >= GA_REWARD_COUNT || cfg->track_width <= 0.f || cfg->length <= 0.f)
+        return NULL;
+    EnvBatch* e = calloc(1, sizeof(EnvBatch));
+    if (!e)
+        return NULL;
+    e->cfg = *cfg;
+    e->padded = (cfg->count + ENV_LANES - 1) / ENV_LANES * ENV_LANES;
+    e->episode_steps = (int)ceilf(cfg->episode_seconds / cfg->dt);
+
+    GAContext* ga = &e->ga;
+    ga->track_left = 0.f;
+    ga->track_width = cfg->track_width;
+    ga->length = cfg->length;
+    ga->gravity = cfg->gravity;
+    ga->damping = cfg->damping;
+    ga->base_k = cfg->base_k;
+    ga->base_d = cfg->base_d;
+    ga->max_speed_factor = cfg->max_speed_factor;
+    ga->max_base_speed = cfg->max_base_speed;
+    ga->upright_threshold = cfg->upright_threshold;
+    ga->reward = cfg->reward;
+    ga->reward_bonus = cfg->reward_bonus;
+    ga->reward_drop = cfg->reward_drop;
+    ga->reward_effort = cfg->reward_effort;
+    ga->control_period = cfg->control_period;
+
+    size_t n = (size_t)e->padded;
+    if (posix_memalign(&e->block, 64, n * (7 * sizeof(float) + sizeof(int) + sizeof(unsigned))) != 0)
+    {
+        free(e);
+        return NULL;
+    }
+    float* f = (float*)e->block;
+    e->slider = f;
+    e->pivot_x = f + n;
+    e->pivot_v = f + 2 * n;
+    e->theta = f + 3 * n;
+    e->omega = f + 4 * n;
+    e->above = f + 5 * n;
+    e->fitness = f + 6 * n;
+    e->steps = (int*)(f + 7 * n);
+    e->rng = (unsigned*)(e->steps + n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        unsigned s = (cfg->seed + 1u) * 0x9E3779B9u ^ ((unsigned)i + 1u) * 0x85EBCA6Bu;
+        e->rng[i] = s ? s : 1u;
+    }
+
+    // chunks of whole lane blocks, at least ENV_MIN_CHUNK envs each
+    int threads = cfg->threads;
+    if (threads < 1)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (int)cpus : 1;
+    }
+    int most = e->padded / ENV_MIN_CHUNK;
+    threads = threads > most ? most : threads;
+    threads = threads > ENV_MAX_THREADS ? ENV_MAX_THREADS : (threads < 1 ? 1 : threads);
+    pthread_mutex_init(&e->lock, NULL);
+    pthread_cond_init(&e->wake, NULL);
+    pthread_cond_init(&e->done, NULL);
+    e->threads = 1;
+    for (int t = 1; t < threads; ++t)
+    {
+        e->workers[t].e = e;
+        if (pthread_create(&e->workers[t].thread, NULL, env_worker, &e->workers[t]) != 0)
+            break;
+        e->threads++;
+    }
+    // split once the worker count is known; the workers read their range after the first job is posted
+    int blocks = e->padded / ENV_LANES;
+    pthread_mutex_lock(&e->lock);
+    for (int t = 0; t < e->threads; ++t)
+    {
+        e->workers[t].start = (int)((long long)blocks * t / e->threads) * ENV_LANES;
+        e->workers[t].end = (int)((long long)blocks * (t + 1) / e->threads) * ENV_LANES;
+    }
+    pthread_mutex_unlock(&e->lock);
+    env_reset(e, NULL, NULL);
+    return e;
+}
+
+void env_destroy(EnvBatch* e)
+{
+    if (!e)
+        return;
+    pthread_mutex_lock(&e->lock);
+    e->stop = 1;
+    pthread_cond_broadcast(&e->wake);
+    pthread_mutex_unlock(&e->lock);
+    for (int t = 1; t < e->threads; ++t)
+        pthread_join(e->workers[t].thread, NULL);
+    pthread_cond_destroy(&e->done);
+    pthread_cond_destroy(&e->wake);
+    pthread_mutex_destroy(&e->lock);
+    free(e->block);
+    free(e);
+}
+
+int env_count(const EnvBatch* e)
+{
+    return e ? e->cfg.count : 0;
+}
+
+int env_threads(const EnvBatch* e)
+{
+    return e ? e->threads : 0;
+}
+
+void env_reset(EnvBatch* e, const uint8_t* mask, float* obs)
+{
+    if (!e)
+        return;
+    e->job = ENV_JOB_RESET;
+    e->mask = mask;
+    e->obs = obs;
+    run_job(e);
+}
+
+void env_set_state(EnvBatch* e, const uint8_t* mask, const float* state)
+{
+    if (!e || !state)
+        return;
+    for (int i = 0; i < e->padded; ++i)
+    {
+        if (i < e->cfg.count && mask && !mask[i])
+            continue;
+        e->slider[i] = state[0];
+        e->pivot_x[i] = state[1];
+        e->pivot_v[i] = state[2];
+        e->theta[i] = state[3];
+        e->omega[i] = state[4];
+        e->above[i] = 0.f;
+        e->fitness[i] = 0.f;
+        e->steps[i] = 0;
+    }
+}
+
+void env_get_state(const EnvBatch* e, int index, float* state)
+{
+    if (!e || !state || index < 0 || index >= e->cfg.count)
+        return;
+    state[0] = e->slider[index];
+    state[1] = e->pivot_x[index];
+    state[2] = e->pivot_v[index];
+    state[3] = e->theta[index];
+    state[4] = e->omega[index];
+}
+
+void env_step(EnvBatch* e, const float* actions, float* obs, float* rewards, uint8_t* dones)
+{
+    if (!e || !actions)
+        return;
+    e->job = ENV_JOB_STEP;
+    e->actions = actions;
+    e->obs = obs;
+    e->rewards = rewards;
+    e->dones = dones;
+    run_job(e);
+}
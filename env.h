@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdint.h>
+
+// Batched cart-pendulum environment for external trainers (libpendule_env).
+// Same physics and rewards as the GA rollouts (ga_step_agent, sweep.c), with
+// sin/cos from vmath.h instead of libm: the state is kept SoA and stepped ENV_LANES envs at a time in lane-innermost
+// loops, the batch is split across a persistent worker pool. Self-contained
+// header so FFI binders (ctypes, cffi, bindgen) can parse it as is.
+//
+// Buffers are caller-owned and written in place, row-major per env:
+//   actions  [count]            base velocity command in [-1, 1] (clamped),
+//                               scaled by max_base_speed like the network output
+//   obs      [count][ENV_OBS]   the network inputs: position in [-1, 1],
+//                               sin theta, cos theta, omega
+//   rewards  [count]            fitness gained over the step, so the return of
+//                               an episode is the GA fitness of the same actions
+//                               (to vmath.h rounding, the pendulum is chaotic)
+//   dones    [count]            1 once episode_seconds have been simulated; the
+//                               env keeps stepping until env_reset() clears it
+// One env_step is control_period physics steps with the action held.
+
+#define ENV_OBS         4
+#define ENV_STATE       5    // slider [0, 1], pivot x from the left end of the track, pivot v, theta, omega
+#define ENV_LANES       8
+#define ENV_MAX_THREADS 64
+#define ENV_MIN_CHUNK   1024 // envs per worker before the pool is used
+
+#if defined(__GNUC__)
+#define ENV_API __attribute__((visibility("default")))
+#else
+#define ENV_API
+#endif
+
+typedef struct
+{
+    int      count;
+    int      threads;          // 0: one per online CPU, 1: the calling thread only
+    float    dt;               // physics step (s)
+    int      control_period;   // physics steps per env_step
+    float    episode_seconds;
+    int      reward;           // 0 upright, 1 height, 2 gentle (GA_REWARD_*, reward.h)
+
+    // physics, in the GA's pixel units
+    float    track_width;
+    float    length;
+    float    gravity;
+    float    damping;
+    float    base_k;
+    float    base_d;
+    float    max_speed_factor; // omega cap (rad/s)
+    float    max_base_speed;   // px/s at action 1
+    float    upright_threshold;
+
+    float    reward_bonus;
+    float    reward_drop;
+    float    reward_effort;
+
+    // reset draws theta0 + U(-1,1) * theta_noise and U(-1,1) * omega_noise
+    float    theta_noise;
+    float    omega_noise;
+    uint32_t seed;
+} EnvConfig;
+
+typedef struct EnvBatch EnvBatch;
+
+// the interactive pendulum's physics and the GA's defaults
+ENV_API void      env_default_config(EnvConfig* cfg);
+ENV_API EnvBatch* env_create(const EnvConfig* cfg);
+ENV_API void      env_destroy(EnvBatch* e);
+ENV_API int       env_count(const EnvBatch* e);
+ENV_API int       env_threads(const EnvBatch* e);
+// resets the envs with mask[i] != 0 (all of them when mask is NULL) and writes
+// their observations; obs may be NULL
+ENV_API void      env_reset(EnvBatch* e, const uint8_t* mask, float* obs);
+ENV_API void      env_step(EnvBatch* e, const float* actions, float* obs, float* rewards, uint8_t* dones);
+// starts a new episode of the masked envs (all when mask is NULL) from `state`
+// (ENV_STATE floats), e.g. to plan from the state of another simulator
+ENV_API void      env_set_state(EnvBatch* e, const uint8_t* mask, const float* state);
+ENV_API void      env_get_state(const EnvBatch* e, int index, float* state);
@@ -1,12 +1,37 @@
+#ifdef __linux__
+#define _GNU_SOURCE // pthread_setaffinity_np
+#endif
+
 #include "ga.h"
+#include "dist.h"
+#include "grad.h"
+#include "half.h"
+#include "novelty.h"
+#include "physics.h"
+#include "quant.h"
+#include "reward.h"
+#include "trace.h"
+#include "traj.h"
 
 #include <math.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <pthread.h>
 #include <stdio.h>
+#include <unistd.h>
+
+#define GA_CACHE_LINE   64
+#define GA_PAGE_ALIGN   4096
+#define GA_CHUNK_ALIGN  16
+#define GA_RAND_MAX     0x7fffffff
 
-#define GA_THREAD_COUNT 14
+// the weights of a Genome as one flat float vector: w_in, b_h, w_out, w_direct, b_out
+#define GA_GENOME_WEIGHTS ((int)((offsetof(Genome, fitness) - offsetof(Genome, w_in)) / sizeof(float)))
+_Static_assert((offsetof(Genome, fitness) - offsetof(Genome, w_in)) / sizeof(float) < 64,
+               "crossover takes one mask bit per weight from a 64-bit word, bit 63 picks hidden");
 
 typedef enum
 {
@@ -17,14 +42,88 @@ typedef enum
     MUTATE_WEIGHTS
 } MutationKind;
 
+static unsigned long long now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+// CPU time of the calling thread, unaffected by the slices other workers get
+static unsigned long long thread_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+// rand() is shared state; every thread that breeds keeps its own xorshift generator
+static _Thread_local unsigned rng_state;
+static _Thread_local uint64_t rng64_state; // 0: derived from rng_state on first use
+
+static void ga_seed(unsigned seed)
+{
+    rng_state = seed ? seed : 0x9E3779B9u;
+    rng64_state = 0;
+}
+
+void ga_seed_thread(unsigned seed)
+{
+    ga_seed(seed);
+}
+
+static int ga_rand(void)
+{
+    if (!rng_state)
+        ga_seed((unsigned)now_ns());
+    unsigned x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rng_state = x;
+    return (int)(x >> 1);
+}
+
 static float frand(float a, float b)
 {
-    return a + (b - a) * ((float)rand() / (float)RAND_MAX);
+    return a + (b - a) * ((float)ga_rand() / (float)GA_RAND_MAX);
+}
+
+// xorshift64*, one word per crossover or weight mutation
+static uint64_t ga_rand64(void)
+{
+    if (!rng64_state)
+        rng64_state = ((uint64_t)ga_rand() << 32 ^ (uint64_t)ga_rand()) | 1u;
+    uint64_t x = rng64_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    rng64_state = x;
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+static const uint32_t ga_bit[32] = {
+    1u << 0,  1u << 1,  1u << 2,  1u << 3,  1u << 4,  1u << 5,  1u << 6,  1u << 7,
+    1u << 8,  1u << 9,  1u << 10, 1u << 11, 1u << 12, 1u << 13, 1u << 14, 1u << 15,
+    1u << 16, 1u << 17, 1u << 18, 1u << 19, 1u << 20, 1u << 21, 1u << 22, 1u << 23,
+    1u << 24, 1u << 25, 1u << 26, 1u << 27, 1u << 28, 1u << 29, 1u << 30, 1u << 31,
+};
+
+// counter-based noise: weight k of a mutation gets hash(base + k * stride), so
+// the per-weight loop has no dependency between iterations and vectorizes
+static inline uint32_t hash32(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
 }
 
 static void init_genome(Genome* g)
 {
-    g->hidden = 1 + (rand() % GA_MAX_HIDDEN);
+    g->hidden = 1 + (ga_rand() % GA_MAX_HIDDEN);
     for (int i = 0; i < GA_MAX_HIDDEN; ++i)
     {
         g->b_h[i] = frand(-0.5f, 0.5f);
@@ -56,174 +155,455 @@ static float eval_network(const Genome* g, const float in[GA_INPUTS])
     return tanhf(out);
 }
 
-static void ga_step_agent(GAContext* ga, GAAgent* a, Genome* g, float dt, int write_fitness)
+static int half_format(const GAContext* ga)
 {
-    float inputs[GA_INPUTS];
-    inputs[0] = a->slider_value * 2.f - 1.f; // position [-1,1]
-    inputs[1] = sinf(a->theta);
-    inputs[2] = cosf(a->theta);
-    inputs[3] = a->omega;
+    return (ga->eval_mode == GA_EVAL_BF16) ? HALF_BF16 : HALF_FP16;
+}
 
-    float out = eval_network(g, inputs);
-    float control = out * ga->max_base_speed;
-    a->last_control = control;
+// the network step_agent queries: int8 (q) or packed half (h) copy of g when set
+typedef struct
+{
+    const GAContext* ga;
+    const Genome*    g;
+    const QGenome*   q;
+    const uint16_t*  h;
+} AgentNet;
 
-    // GA outputs base velocity -> update slider target
-    a->slider_value += (control * dt) / ga->track_width;
-    if (a->slider_value < 0.f)
-        a->slider_value = 0.f;
-    if (a->slider_value > 1.f)
-        a->slider_value = 1.f;
+static inline float agent_policy(const void* net, const float in[GA_INPUTS])
+{
+    const AgentNet* n = (const AgentNet*)net;
+    if (n->q)
+        return quant_eval_network(n->q, in);
+    if (n->h)
+        return half_eval_network(n->h, half_format(n->ga), in);
+    return eval_network(n->g, in);
+}
 
-    float pivot_target_x = ga->track_left + ga->track_width * a->slider_value;
-    float dx = pivot_target_x - a->pivot_x;
-    float pivot_acc = ga->base_k * dx - ga->base_d * a->pivot_v;
-    a->pivot_v += pivot_acc * dt;
-    a->pivot_x += a->pivot_v * dt;
+// One physics + reward step (physics.h). q / h: int8 or packed half copy of g
+// to evaluate instead of the float weights. `reward` is a GA_REWARD_* constant
+// at every call site below, so each kernel gets its reward inlined and the
+// switch folded away.
+static GA_ALWAYS_INLINE void step_agent(GAContext* ga, GAAgent* a, Genome* g, const QGenome* q, const uint16_t* h,
+                                        float dt, int write_fitness, const int reward)
+{
+    AgentNet net = {ga, g, q, h};
+    physics_agent_step(ga, a, agent_policy, &net, dt, reward);
+    if (write_fitness)
+        g->fitness = a->fitness;
+}
 
-    // clamp pivot
-    if (a->pivot_x < ga->track_left)
-    {
-        a->pivot_x = ga->track_left;
-        a->pivot_v = 0.f;
+#define GA_REWARD_ROLLOUT(id, fn, name)                                                                \
+    static void rollout_##fn(GAContext* ga, GAAgent* a, Genome* g, const QGenome* q, const uint16_t* h, \
+                             float dt, int steps, int write_fitness)                                   \
+    {                                                                                                  \
+        for (int s = 0; s < steps; ++s)                                                                \
+            step_agent(ga, a, g, q, h, dt, write_fitness, GA_REWARD_##id);                             \
     }
-    if (a->pivot_x > ga->track_left + ga->track_width)
+GA_REWARD_LIST(GA_REWARD_ROLLOUT)
+#undef GA_REWARD_ROLLOUT
+
+// `steps` steps of one agent with the context's reward
+static void ga_step_agent(GAContext* ga, GAAgent* a, Genome* g, const QGenome* q, const uint16_t* h,
+                          float dt, int steps, int write_fitness)
+{
+    switch (ga->reward)
     {
-        a->pivot_x = ga->track_left + ga->track_width;
-        a->pivot_v = 0.f;
+#define GA_REWARD_DISPATCH(id, fn, name)                   \
+        case GA_REWARD_##id:                               \
+            rollout_##fn(ga, a, g, q, h, dt, steps, write_fitness); \
+            break;
+        GA_REWARD_LIST(GA_REWARD_DISPATCH)
+#undef GA_REWARD_DISPATCH
     }
+}
+
+// Work-stealing deque over a contiguous range of GA_CHUNK_ALIGN-agent blocks.
+// Nothing is pushed once evaluation starts, so only pop (owner, bottom) and
+// steal (thieves, top) are needed (Chase-Lev without growth).
+typedef struct
+{
+    _Alignas(GA_CACHE_LINE) atomic_int top;
+    atomic_int bottom;
+    int        first_block;
+} GADeque;
 
-    float theta_dd = -(ga->gravity / ga->length) * sinf(a->theta)
-                     - (pivot_acc / ga->length) * cosf(a->theta)
-                     - ga->damping * a->omega;
-    a->omega += theta_dd * dt;
-    if (a->omega > ga->max_speed_factor)
-        a->omega = ga->max_speed_factor;
-    if (a->omega < -ga->max_speed_factor)
-        a->omega = -ga->max_speed_factor;
-    a->theta += a->omega * dt;
+// Workers get one cache line each, and chunk boundaries are rounded to
+// GA_CHUNK_ALIGN agents so no line of population/agents/qpopulation is shared
+// between two threads (16 * sizeof of each element is a multiple of 64 bytes).
+typedef struct
+{
+    _Alignas(GA_CACHE_LINE) GAContext* ga;
+    int    index;
+    int    start;
+    int    end;
+    float  dt;
+    int    steps;
+    float  best_fitness;
+    int    best_index;
+    void*  touch_base;
+    size_t touch_elem;
 
-    a->bob_x = a->pivot_x + ga->length * sinf(a->theta);
-    a->bob_y = ga->pivot_y + ga->length * cosf(a->theta);
+    GADeque*    deques;
+    int         deque_count;
+    atomic_int* remaining;
+    unsigned    rng;
+    unsigned long long busy_ns;
+    unsigned long long idle_ns;
+    unsigned long long end_ns;
+    int         blocks;
+    int         steals;
+    int         score_novelty; // last pass of a generation with novelty search on
+    unsigned long long novelty_ns;
+    PerfCounters counters;
+    int         counted;
+    PerfSample  perf;
+} GAWorker;
 
-    // reward: above threshold + bonus for staying near angle 0
-    const float center_range = 0.35f; // radians where bonus is strongest
-    const float center_bonus = 0.3f;  // weight of the bonus
-    const float drop_penalty = 0.6f;  // penalty when leaving the threshold
-    if (cosf(a->theta) < ga->upright_threshold)
-    {
-        float closeness = 1.f - (fabsf(a->theta) / center_range);
-        if (closeness < 0.f)
-            closeness = 0.f;
-        if (closeness > 1.f)
-            closeness = 1.f;
+// per-pass worker state, carved from the arena once instead of sitting on the stack
+typedef struct GAScratch
+{
+    GAWorker workers[GA_THREAD_COUNT];
+    GADeque  deques[GA_THREAD_COUNT];
+} GAScratch;
 
-        a->fitness += dt; // base reward for being above threshold
-        a->fitness += dt * center_bonus * closeness; // extra reward near 0
-        a->above_time += dt;
+static int deque_pop(GADeque* d)
+{
+    int b = atomic_load(&d->bottom) - 1;
+    atomic_store(&d->bottom, b);
+    int t = atomic_load(&d->top);
+    if (t > b)
+    {
+        atomic_store(&d->bottom, b + 1);
+        return -1;
     }
-    else
+    if (t == b)
     {
-        if (a->above_time > 0.f)
-            a->fitness -= drop_penalty;
-        a->above_time = 0.f;
+        // last block: race the thieves for it
+        int won = atomic_compare_exchange_strong(&d->top, &t, t + 1);
+        atomic_store(&d->bottom, b + 1);
+        return won ? d->first_block + b : -1;
+    }
+    return d->first_block + b;
+}
+
+static int deque_steal(GADeque* d)
+{
+    int t = atomic_load(&d->top);
+    int b = atomic_load(&d->bottom);
+    if (t >= b)
+        return -1;
+    if (atomic_compare_exchange_strong(&d->top, &t, t + 1))
+        return d->first_block + t;
+    return -1;
+}
+
+static unsigned worker_rand(GAWorker* w)
+{
+    unsigned x = w->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    w->rng = x;
+    return x;
+}
+
+static void pin_worker(const GAWorker* w)
+{
+    if (!w->ga->pin_threads)
+        return;
+#ifdef __linux__
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1)
+        return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET((int)(w->index % cpus), &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+// all steps of one range of agents, one kernel per reward
+#define GA_REWARD_RANGE(id, fn, name)                                                                           \
+    static void eval_steps_##fn(GAWorker* w, int start, int end)                                              \
+    {                                                                                                         \
+        GAContext* ga = w->ga;                                                                                \
+        TrajRecorder* rec = ga->recorder;                                                                     \
+        const HalfPool* hp = (ga->eval_mode == GA_EVAL_FP16 || ga->eval_mode == GA_EVAL_BF16) ? ga->hpopulation \
+                                                                                             : NULL;          \
+        for (int s = 0; s < w->steps; ++s)                                                                    \
+        {                                                                                                     \
+            for (int i = start; i < end; ++i)                                                                 \
+            {                                                                                                 \
+                GAAgent* a = &ga->agents[i];                                                                  \
+                Genome* g = &ga->population[i];                                                               \
+                const QGenome* q = (ga->eval_mode == GA_EVAL_INT8) ? &ga->qpopulation[i] : NULL;              \
+                const uint16_t* h = hp ? half_pool_record(hp, i) : NULL;                                      \
+                step_agent(ga, a, g, q, h, w->dt, 1, GA_REWARD_##id);                                         \
+                if (rec)                                                                                      \
+                    traj_capture(rec, i, a);                                                                  \
+            }                                                                                                 \
+        }                                                                                                     \
     }
+GA_REWARD_LIST(GA_REWARD_RANGE)
+#undef GA_REWARD_RANGE
 
-    // penalties: base motion + angular speed (inertia)
-    // keep base near center (0)
+// evaluate a range, then fold its fitness into the worker's best
+static void eval_range(GAWorker* w, int start, int end)
+{
+    switch (w->ga->reward)
+    {
+#define GA_REWARD_DISPATCH(id, fn, name)      \
+        case GA_REWARD_##id:                  \
+            eval_steps_##fn(w, start, end);   \
+            break;
+        GA_REWARD_LIST(GA_REWARD_DISPATCH)
+#undef GA_REWARD_DISPATCH
+    }
+    GAContext* ga = w->ga;
+    for (int i = start; i < end; ++i)
+    {
+        float f = ga->population[i].fitness;
+        if (f > w->best_fitness)
+        {
+            w->best_fitness = f;
+            w->best_index = i;
+        }
+    }
+    // the archive is read-only during EVAL, SELECT adds to it once every worker is done
+    if (w->score_novelty && ga->novelty && ga->novelty_weight > 0.f)
     {
-        const float center_x = ga->track_left + ga->track_width * 0.5f;
-        float base_dist = fabsf(a->pivot_x - center_x) / (ga->track_width * 0.5f);
-        if (base_dist > 1.f)
-            base_dist = 1.f;
-        a->fitness -= dt * 0.15f * base_dist;
+        unsigned long long t0 = thread_ns();
+        for (int i = start; i < end; ++i)
+        {
+            float desc[NOVELTY_DIM];
+            novelty_describe(ga, &ga->agents[i], desc);
+            ga->agents[i].novelty = novelty_query(ga->novelty, desc);
+        }
+        w->novelty_ns += thread_ns() - t0;
     }
-    a->fitness -= dt * 0.05f * (fabsf(a->pivot_v) / ga->max_base_speed);
-    a->fitness -= dt * 0.08f * fabsf(a->omega);
-    if (a->fitness < 0.f)
-        a->fitness = 0.f;
+}
 
-    if (write_fitness)
-        g->fitness = a->fitness;
+// counters are read around the evaluation only, not the stealing/idle loop
+static void eval_range_counted(GAWorker* w, int start, int end)
+{
+    unsigned long long t0 = trace_begin();
+    if (!w->counted)
+    {
+        eval_range(w, start, end);
+        trace_end(t0, "chunk", start);
+        return;
+    }
+    PerfSample before, after, delta;
+    perf_read(&w->counters, &before);
+    eval_range(w, start, end);
+    perf_read(&w->counters, &after);
+    trace_end(t0, "chunk", start);
+    perf_delta(&before, &after, &delta);
+    perf_add(&w->perf, &delta);
 }
 
-typedef struct
+static void eval_block(GAWorker* w, int block)
 {
-    GAContext* ga;
-    int start;
-    int end;
-    float dt;
-    int steps;
-    float best_fitness;
-    int best_index;
-} GAWorker;
+    int start = block * GA_CHUNK_ALIGN;
+    int end = start + GA_CHUNK_ALIGN;
+    if (end > w->ga->population_size)
+        end = w->ga->population_size;
+    unsigned long long t0 = now_ns();
+    eval_range_counted(w, start, end);
+    w->busy_ns += now_ns() - t0;
+    w->blocks++;
+    atomic_fetch_sub(w->remaining, 1);
+}
 
 static void* eval_worker(void* arg)
 {
     GAWorker* w = (GAWorker*)arg;
     GAContext* ga = w->ga;
-    for (int s = 0; s < w->steps; ++s)
+    pin_worker(w);
+    trace_bind(TRACE_TRACK_WORKER + w->index, "worker");
+    perf_reset(&w->perf);
+    w->counted = ga->perf_counters ? perf_open(&w->counters) != 0 : 0;
+    if (!w->counted)
+        w->perf.valid = 0;
+
+    if (ga->scheduler == GA_SCHED_STATIC || !w->deques)
     {
-        for (int i = w->start; i < w->end; ++i)
-        {
-            GAAgent* a = &ga->agents[i];
-            Genome* g = &ga->population[i];
-            ga_step_agent(ga, a, g, w->dt, 1);
-        }
+        unsigned long long t0 = now_ns();
+        eval_range_counted(w, w->start, w->end);
+        w->end_ns = now_ns();
+        w->busy_ns = w->end_ns - t0;
+        w->blocks = (w->end - w->start + GA_CHUNK_ALIGN - 1) / GA_CHUNK_ALIGN;
+        if (w->counted)
+            perf_close(&w->counters);
+        return NULL;
     }
 
-    float best_now = -1e9f;
-    int best_idx = w->start;
-    for (int i = w->start; i < w->end; ++i)
+    // own blocks first (they were first-touched by this worker), then steal
+    GADeque* own = &w->deques[w->index];
+    for (int block = deque_pop(own); block >= 0; block = deque_pop(own))
+        eval_block(w, block);
+
+    unsigned long long idle_start = now_ns();
+    while (atomic_load(w->remaining) > 0 && w->deque_count > 1)
     {
-        float f = ga->population[i].fitness;
-        if (f > best_now)
+        int victim = (int)(worker_rand(w) % (unsigned)(w->deque_count - 1));
+        if (victim >= w->index)
+            victim++;
+        int block = deque_steal(&w->deques[victim]);
+        if (block < 0)
         {
-            best_now = f;
-            best_idx = i;
+            sched_yield();
+            continue;
         }
+        w->idle_ns += now_ns() - idle_start;
+        w->steals++;
+        eval_block(w, block);
+        idle_start = now_ns();
     }
-
-    w->best_fitness = best_now;
-    w->best_index = best_idx;
+    w->end_ns = now_ns();
+    w->idle_ns += w->end_ns - idle_start;
+    if (w->counted)
+        perf_close(&w->counters);
     return NULL;
 }
 
-static void ga_eval_parallel(GAContext* ga, float dt, int steps)
+// first touch: the worker that will evaluate a chunk is the one that faults its pages in
+static void* touch_worker(void* arg)
 {
-    if (!ga || steps < 1)
-        return;
+    GAWorker* w = (GAWorker*)arg;
+    pin_worker(w);
+    char* base = (char*)w->touch_base;
+    memset(base + (size_t)w->start * w->touch_elem, 0, (size_t)(w->end - w->start) * w->touch_elem);
+    return NULL;
+}
 
+static int ga_run_workers(GAContext* ga, void* (*fn)(void*), GAWorker* workers, float dt, int steps,
+                          void* touch_base, size_t touch_elem, GADeque* deques, atomic_int* remaining)
+{
+    int blocks = (ga->population_size + GA_CHUNK_ALIGN - 1) / GA_CHUNK_ALIGN;
     int thread_count = GA_THREAD_COUNT;
-    if (thread_count > ga->population_size)
-        thread_count = ga->population_size;
+    if (thread_count > blocks)
+        thread_count = blocks;
     if (thread_count < 1)
-        thread_count = 1;
+        return 0;
 
     pthread_t threads[GA_THREAD_COUNT];
-    GAWorker workers[GA_THREAD_COUNT];
-
-    int chunk = ga->population_size / thread_count;
-    int remainder = ga->population_size % thread_count;
-    int start = 0;
+    int chunk = blocks / thread_count;
+    int remainder = blocks % thread_count;
+    int block = 0;
     for (int t = 0; t < thread_count; ++t)
     {
         int size = chunk + (t < remainder ? 1 : 0);
+        int start = block * GA_CHUNK_ALIGN;
+        int end = (block + size) * GA_CHUNK_ALIGN;
+        if (end > ga->population_size)
+            end = ga->population_size;
         workers[t].ga = ga;
+        workers[t].index = t;
         workers[t].start = start;
-        workers[t].end = start + size;
+        workers[t].end = end;
         workers[t].dt = dt;
         workers[t].steps = steps;
         workers[t].best_fitness = -1e9f;
         workers[t].best_index = start;
-        pthread_create(&threads[t], NULL, eval_worker, &workers[t]);
-        start += size;
+        workers[t].touch_base = touch_base;
+        workers[t].touch_elem = touch_elem;
+        workers[t].deques = deques;
+        workers[t].deque_count = thread_count;
+        workers[t].remaining = remaining;
+        workers[t].rng = 0x9E3779B9u * (unsigned)(t + 1);
+        workers[t].busy_ns = 0;
+        workers[t].idle_ns = 0;
+        workers[t].end_ns = 0;
+        workers[t].blocks = 0;
+        workers[t].steals = 0;
+        workers[t].novelty_ns = 0;
+        if (deques)
+        {
+            atomic_store(&deques[t].top, 0);
+            atomic_store(&deques[t].bottom, size);
+            deques[t].first_block = block;
+        }
+        block += size;
     }
+    if (remaining)
+        atomic_store(remaining, blocks);
+    for (int t = 0; t < thread_count; ++t)
+        pthread_create(&threads[t], NULL, fn, &workers[t]);
     for (int t = 0; t < thread_count; ++t)
         pthread_join(threads[t], NULL);
+    return thread_count;
+}
+
+static void* ga_alloc_first_touch(GAContext* ga, size_t elem)
+{
+    void* p = arena_alloc(&ga->arena, (size_t)ga->capacity * elem, GA_PAGE_ALIGN);
+    if (!p)
+        return NULL;
+    GAWorker workers[GA_THREAD_COUNT];
+    ga_run_workers(ga, touch_worker, workers, 0.f, 0, p, elem, NULL, NULL);
+    return p;
+}
+
+// Maps a fresh arena for `capacity` genomes and carves every population-sized
+// array from it; the first `keep` genomes and agents move over from the old
+// arena, which is then unmapped whole. The old one stays if mapping fails.
+static int ga_build_arena(GAContext* ga, int capacity, int keep)
+{
+    capacity = (capacity + GA_CHUNK_ALIGN - 1) / GA_CHUNK_ALIGN * GA_CHUNK_ALIGN;
+    size_t bytes = (size_t)capacity * (sizeof(Genome) + sizeof(GAAgent) + sizeof(QGenome))
+                 + sizeof(GAScratch) + 4 * GA_PAGE_ALIGN;
+    Arena old = ga->arena;
+    int old_capacity = ga->capacity;
+    Genome* old_population = ga->population;
+    GAAgent* old_agents = ga->agents;
+    if (!arena_init(&ga->arena, bytes, ga->huge_pages))
+    {
+        ga->arena = old;
+        return 0;
+    }
+    ga->capacity = capacity;
+    Genome* population = ga_alloc_first_touch(ga, sizeof(Genome));
+    GAAgent* agents = ga_alloc_first_touch(ga, sizeof(GAAgent));
+    QGenome* qpopulation = ga_alloc_first_touch(ga, sizeof(QGenome));
+    GAScratch* scratch = arena_alloc(&ga->arena, sizeof(GAScratch), GA_CACHE_LINE);
+    if (!population || !agents || !qpopulation || !scratch)
+    {
+        arena_free(&ga->arena);
+        ga->arena = old;
+        ga->capacity = old_capacity;
+        return 0;
+    }
+    if (keep > 0 && old_population && old_agents)
+    {
+        memcpy(population, old_population, (size_t)keep * sizeof(Genome));
+        memcpy(agents, old_agents, (size_t)keep * sizeof(GAAgent));
+    }
+    ga->population = population;
+    ga->agents = agents;
+    ga->qpopulation = qpopulation;
+    ga->scratch = scratch;
+    arena_free(&old);
+    return 1;
+}
+
+// last: the pass ends the generation's rollouts, the workers then score novelty
+static void ga_eval_parallel(GAContext* ga, float dt, int steps, int last)
+{
+    if (!ga || steps < 1)
+        return;
+
+    GAWorker* workers = ga->scratch->workers;
+    GADeque* deques = ga->scratch->deques;
+    atomic_int remaining;
+    for (int t = 0; t < GA_THREAD_COUNT; ++t)
+        workers[t].score_novelty = last;
+    unsigned long long start_ns = now_ns();
+    int thread_count = ga_run_workers(ga, eval_worker, workers, dt, steps, NULL, 0, deques, &remaining);
 
     ga->best_index = 0;
     float best_now = -1e9f;
+    unsigned long long last_end = start_ns;
     for (int t = 0; t < thread_count; ++t)
     {
         if (workers[t].best_fitness > best_now)
@@ -231,21 +611,87 @@ static void ga_eval_parallel(GAContext* ga, float dt, int steps)
             best_now = workers[t].best_fitness;
             ga->best_index = workers[t].best_index;
         }
+        if (workers[t].end_ns > last_end)
+            last_end = workers[t].end_ns;
     }
+
+    // utilization of this pass: busy vs searching for work vs waiting at the join
+    ga->worker_count = thread_count;
+    for (int t = 0; t < thread_count; ++t)
+    {
+        GAWorkerStats* st = &ga->worker_stats[t];
+        unsigned long long end = workers[t].end_ns ? workers[t].end_ns : last_end;
+        st->busy_ms = (float)((double)workers[t].busy_ns * 1e-6);
+        st->idle_ms = (float)((double)workers[t].idle_ns * 1e-6);
+        st->wait_ms = (float)((double)(last_end - end) * 1e-6);
+        st->utilization = last_end > start_ns ? (float)((double)workers[t].busy_ns / (double)(last_end - start_ns)) : 0.f;
+        st->blocks = workers[t].blocks;
+        st->steals = workers[t].steals;
+        st->perf = workers[t].perf;
+    }
+
+    // EVAL counters are the sum of the workers' chunks
+    perf_reset(&ga->perf_stage[GA_STAGE_EVAL]);
+    if (!ga->perf_counters || thread_count == 0)
+        ga->perf_stage[GA_STAGE_EVAL].valid = 0;
+    for (int t = 0; t < thread_count; ++t)
+        perf_add(&ga->perf_stage[GA_STAGE_EVAL], &workers[t].perf);
+
+    if (last && ga->novelty && ga->novelty_weight > 0.f)
+    {
+        unsigned long long knn_ns = 0;
+        for (int t = 0; t < thread_count; ++t)
+            knn_ns += workers[t].novelty_ns;
+        ga->novelty->score_ms = (float)((double)knn_ns * 1e-6);
+    }
+}
+
+void ga_get_worker_summary(const GAContext* ga, float* util_min, float* util_avg, float* wait_max_ms)
+{
+    if (!ga)
+        return;
+    float umin = 1.f, usum = 0.f, wmax = 0.f;
+    for (int t = 0; t < ga->worker_count; ++t)
+    {
+        const GAWorkerStats* st = &ga->worker_stats[t];
+        if (st->utilization < umin)
+            umin = st->utilization;
+        usum += st->utilization;
+        if (st->wait_ms > wmax)
+            wmax = st->wait_ms;
+    }
+    if (ga->worker_count < 1)
+        umin = 0.f;
+    if (util_min)
+        *util_min = umin;
+    if (util_avg)
+        *util_avg = ga->worker_count > 0 ? usum / (float)ga->worker_count : 0.f;
+    if (wait_max_ms)
+        *wait_max_ms = wmax;
 }
 
 static void reset_agent(GAContext* ga, GAAgent* a)
 {
-    a->slider_value = 0.5f;
-    a->pivot_x = ga->track_left + ga->track_width * 0.5f;
-    a->pivot_v = 0.f;
-    a->theta = -0.7f;
-    a->omega = 0.f;
-    a->bob_x = a->pivot_x + ga->length * sinf(a->theta);
-    a->bob_y = ga->pivot_y + ga->length * cosf(a->theta);
-    a->above_time = 0.f;
-    a->last_control = 0.f;
-    a->fitness = 0.f;
+    physics_reset_agent(ga, a);
+    a->novelty = 0.f;
+}
+
+// int8 / half copies follow the population; only needed while evaluating in those modes
+static void refresh_quantized(GAContext* ga)
+{
+    if (ga->eval_mode == GA_EVAL_FP16 || ga->eval_mode == GA_EVAL_BF16)
+    {
+        if (!ga->hpopulation)
+            ga->hpopulation = calloc(1, sizeof(HalfPool));
+        if (!ga->hpopulation
+            || !half_pool_build(ga->hpopulation, ga->population, ga->population_size, half_format(ga)))
+            ga->eval_mode = GA_EVAL_FLOAT;
+        return;
+    }
+    if (ga->eval_mode != GA_EVAL_INT8 || !ga->qpopulation)
+        return;
+    for (int i = 0; i < ga->population_size; ++i)
+        quant_genome(&ga->population[i], &ga->qpopulation[i], ga->max_speed_factor);
 }
 
 static int cmp_fitness_desc(const void* a, const void* b)
@@ -269,27 +715,26 @@ static MutationKind pick_mutation_kind(const GAContext* ga)
     return MUTATE_WEIGHTS;
 }
 
+// every weight moves by U(-sigma, sigma) with probability prob; one 64-bit key
+// per call, then one hash per weight: the low 16 bits draw the mask, the high
+// 16 the step
 static void mutate_weights(Genome* g, float sigma, float prob)
 {
-    for (int i = 0; i < GA_MAX_HIDDEN; ++i)
-    {
-        if (frand(0.f, 1.f) < prob)
-            g->b_h[i] += frand(-sigma, sigma);
-        if (frand(0.f, 1.f) < prob)
-            g->w_out[i] += frand(-sigma, sigma);
-        for (int j = 0; j < GA_INPUTS; ++j)
-        {
-            if (frand(0.f, 1.f) < prob)
-                g->w_in[i][j] += frand(-sigma, sigma);
-        }
-    }
-    for (int j = 0; j < GA_INPUTS; ++j)
+    if (prob <= 0.f)
+        return;
+    uint64_t key = ga_rand64();
+    const uint32_t base = (uint32_t)key;
+    const uint32_t stride = (uint32_t)(key >> 32) | 1u;
+    const int32_t threshold = prob >= 1.f ? 65536 : (int32_t)(prob * 65536.f);
+    const float scale = 2.f * sigma / 65536.f;
+    float* w = &g->w_in[0][0];
+    for (int k = 0; k < GA_GENOME_WEIGHTS; ++k)
     {
-        if (frand(0.f, 1.f) < prob)
-            g->w_direct[j] += frand(-sigma, sigma);
+        uint32_t h = hash32(base + (uint32_t)k * stride);
+        int32_t on = (int32_t)(h & 0xffffu) < threshold;  // signed: SSE2 has no unsigned compare
+        float step = (float)(int32_t)(h >> 16) * scale - sigma;
+        w[k] += step * (float)on;                          // no branch on a random bit
     }
-    if (frand(0.f, 1.f) < prob)
-        g->b_out += frand(-sigma, sigma);
 }
 
 static void mutate_genome(Genome* g, MutationKind kind, float sigma, float prob)
@@ -304,15 +749,15 @@ static void mutate_genome(Genome* g, MutationKind kind, float sigma, float prob)
         {
             if (g->hidden > 0)
             {
-                int i = rand() % g->hidden;
-                if (rand() % 2)
+                int i = ga_rand() % g->hidden;
+                if (ga_rand() % 2)
                     g->w_out[i] = frand(-1.f, 1.f);
                 else
-                    g->w_in[i][rand() % GA_INPUTS] = frand(-1.f, 1.f);
+                    g->w_in[i][ga_rand() % GA_INPUTS] = frand(-1.f, 1.f);
             }
             else
             {
-                g->w_direct[rand() % GA_INPUTS] = frand(-1.f, 1.f);
+                g->w_direct[ga_rand() % GA_INPUTS] = frand(-1.f, 1.f);
             }
             break;
         }
@@ -348,42 +793,206 @@ static void mutate_genome(Genome* g, MutationKind kind, float sigma, float prob)
     }
 }
 
+// uniform crossover as a blend of the two weight vectors under the bits of one
+// random word; bit 63 picks the hidden count
 static Genome crossover(const Genome* a, const Genome* b)
 {
-    Genome c = *a;
-    c.hidden = (rand() % 2) ? a->hidden : b->hidden;
-    for (int i = 0; i < GA_MAX_HIDDEN; ++i)
+    Genome c;
+    uint64_t mask = ga_rand64();
+    c.hidden = (mask >> 63) ? a->hidden : b->hidden;
+    // select on the bit patterns: a branch per random bit mispredicts half the
+    // time; lane k tests bit k of its half of the word against a constant
+    uint32_t wa[GA_GENOME_WEIGHTS], wb[GA_GENOME_WEIGHTS], wc[GA_GENOME_WEIGHTS];
+    memcpy(wa, &a->w_in[0][0], sizeof(wa));
+    memcpy(wb, &b->w_in[0][0], sizeof(wb));
+    const uint32_t lo = (uint32_t)mask, hi = (uint32_t)(mask >> 32);
+    for (int k = 0; k < 32; ++k)
     {
-        c.b_h[i]   = (rand() % 2) ? a->b_h[i] : b->b_h[i];
-        c.w_out[i] = (rand() % 2) ? a->w_out[i] : b->w_out[i];
-        for (int j = 0; j < GA_INPUTS; ++j)
-            c.w_in[i][j] = (rand() % 2) ? a->w_in[i][j] : b->w_in[i][j];
+        uint32_t take_a = 0u - (uint32_t)((lo & ga_bit[k]) != 0);
+        wc[k] = (wa[k] & take_a) | (wb[k] & ~take_a);
     }
-    for (int j = 0; j < GA_INPUTS; ++j)
-        c.w_direct[j] = (rand() % 2) ? a->w_direct[j] : b->w_direct[j];
-    c.b_out = (rand() % 2) ? a->b_out : b->b_out;
+    for (int k = 32; k < GA_GENOME_WEIGHTS; ++k)
+    {
+        uint32_t take_a = 0u - (uint32_t)((hi & ga_bit[k - 32]) != 0);
+        wc[k] = (wa[k] & take_a) | (wb[k] & ~take_a);
+    }
+    memcpy(&c.w_in[0][0], wc, sizeof(wc));
     c.fitness = 0.f;
     return c;
 }
 
+// same operators and rates as ga_do_mutate, for breeders outside the generation loop
+void ga_breed(const GAContext* ga, const Genome* a, const Genome* b, Genome* child)
+{
+    *child = crossover(a, b);
+    mutate_genome(child, pick_mutation_kind(ga), ga->mutation_sigma, ga->mutation_prob);
+    if (frand(0.f, 1.f) < 0.30f)
+        mutate_genome(child, MUTATE_WEIGHTS, 0.15f, 0.25f);
+    if (frand(0.f, 1.f) < 0.10f)
+        mutate_genome(child, MUTATE_NEW_CONN, 0.0f, 0.0f);
+}
+
+void ga_random_genome(Genome* g)
+{
+    init_genome(g);
+}
+
+typedef struct
+{
+    float key;
+    int   index;
+} GARank;
+
+static int cmp_rank_desc(const void* a, const void* b)
+{
+    float x = ((const GARank*)a)->key, y = ((const GARank*)b)->key;
+    return (x < y) - (x > y);
+}
+
+// orders the population by fitness + novelty_weight * novelty (scored by the
+// eval workers), then archives a share of the agents' descriptors; returns the
+// new index of the fittest genome, -1 when the buffers could not be allocated
+static int novelty_order(GAContext* ga)
+{
+    const int n = ga->population_size;
+    if (n < 1)
+        return -1;
+    float* desc = malloc((size_t)n * NOVELTY_DIM * sizeof(float));
+    GARank* rank = malloc((size_t)n * sizeof(GARank));
+    Genome* sorted = malloc((size_t)n * sizeof(Genome));
+    if (!desc || !rank || !sorted)
+    {
+        free(desc);
+        free(rank);
+        free(sorted);
+        return -1;
+    }
+    int fittest = 0;
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i)
+    {
+        novelty_describe(ga, &ga->agents[i], &desc[(size_t)i * NOVELTY_DIM]);
+        rank[i].key = ga->population[i].fitness + ga->novelty_weight * ga->agents[i].novelty;
+        rank[i].index = i;
+        sum += ga->agents[i].novelty;
+        fittest = ga->population[i].fitness > ga->population[fittest].fitness ? i : fittest;
+    }
+    ga->novelty->mean_novelty = (float)(sum / n);
+    qsort(rank, (size_t)n, sizeof(GARank), cmp_rank_desc);
+    int best = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        sorted[i] = ga->population[rank[i].index];
+        if (rank[i].index == fittest)
+            best = i;
+    }
+    memcpy(ga->population, sorted, (size_t)n * sizeof(Genome));
+    novelty_add(ga->novelty, desc, n, ga->novelty->add_prob);
+    free(desc);
+    free(rank);
+    free(sorted);
+    return best;
+}
+
 static void ga_do_select(GAContext* ga)
 {
-    qsort(ga->population, (size_t)ga->population_size, sizeof(Genome), cmp_fitness_desc);
-    ga->gen_best_fitness = ga->population[0].fitness;
+    int best = -1;
+    if (ga->novelty && ga->novelty_weight > 0.f && !ga->dist)
+        best = novelty_order(ga);
+    if (best < 0)
+    {
+        qsort(ga->population, (size_t)ga->population_size, sizeof(Genome), cmp_fitness_desc);
+        best = 0;
+    }
+    ga->gen_best_fitness = ga->population[best].fitness;
     if (ga->gen_best_fitness > ga->best_fitness)
         ga->best_fitness = ga->gen_best_fitness;
+    int improved = 0;
     if (ga->gen_best_fitness > ga->champion_fitness)
     {
-        ga->champion = ga->population[0];
+        ga->champion = ga->population[best];
         ga->champion_fitness = ga->gen_best_fitness;
         ga->has_champion = 1;
         ga->display_active = 0;
+        improved = 1;
     }
+    if (ga->recorder)
+        traj_end_generation(ga->recorder, ga, improved);
+}
+
+// Grows or shrinks the population. The front of the population (the elites
+// after every generation) is kept; new slots are children of the elites, or
+// random genomes before the first generation. Grows within the arena's
+// headroom happen in place, anything else remaps.
+static int resize_population(GAContext* ga, int size)
+{
+    ga_steady_stop(ga);
+    int old_size = ga->population_size;
+    int keep = size < old_size ? size : old_size;
+    if (size > ga->capacity || size < ga->capacity / 4)
+    {
+        ga->population_size = size; // the first touch splits the new size between workers
+        if (!ga_build_arena(ga, size + size / 4, keep))
+        {
+            ga->population_size = old_size;
+            return 0;
+        }
+    }
+    ga->population_size = size;
+
+    int elite = (int)(keep * ga->elite_fraction);
+    if (elite < 1)
+        elite = 1;
+    for (int i = keep; i < size; ++i)
+    {
+        if (ga->generation > 0)
+        {
+            Genome child = crossover(&ga->population[ga_rand() % elite], &ga->population[ga_rand() % elite]);
+            mutate_genome(&child, pick_mutation_kind(ga), ga->mutation_sigma, ga->mutation_prob);
+            ga->population[i] = child;
+        }
+        else
+        {
+            init_genome(&ga->population[i]);
+        }
+        ga->population[i].fitness = 0.f;
+        reset_agent(ga, &ga->agents[i]);
+    }
+    if (ga->best_index >= size)
+        ga->best_index = 0;
+    refresh_quantized(ga);
+    return 1;
+}
+
+// Start of a generation's EVAL: every agent from the standard start state.
+// Population size and control period changes made during an evaluation land
+// here, so a generation never mixes two of either.
+static void ga_start_generation(GAContext* ga)
+{
+    if (ga->pending_size > 0)
+    {
+        int size = ga->pending_size;
+        ga->pending_size = 0;
+        resize_population(ga, size);
+    }
+    if (ga->pending_period > 0)
+    {
+        ga->control_period = ga->pending_period;
+        ga->pending_period = 0;
+    }
+    ga->eval_time = 0.f;
+    ga->stage = GA_STAGE_EVAL;
+    for (int i = 0; i < ga->population_size; ++i)
+    {
+        ga->population[i].fitness = 0.f;
+        reset_agent(ga, &ga->agents[i]);
+    }
+    refresh_quantized(ga);
 }
 
 static void ga_do_mutate(GAContext* ga)
 {
-    int elite = (int)(ga->population_size * 0.3f);
+    int elite = (int)(ga->population_size * ga->elite_fraction);
     if (elite < 1)
         elite = 1;
     int count_none = 0;
@@ -395,12 +1004,12 @@ static void ga_do_mutate(GAContext* ga)
     int count_new_conn_extra = 0;
     for (int i = elite; i < ga->population_size; ++i)
     {
-        int p1 = rand() % elite;
-        int p2 = rand() % elite;
+        int p1 = ga_rand() % elite;
+        int p2 = ga_rand() % elite;
         Genome child = crossover(&ga->population[p1], &ga->population[p2]);
         ga->population[i] = child;
         MutationKind kind = pick_mutation_kind(ga);
-        mutate_genome(&ga->population[i], kind, 0.25f, 0.15f);
+        mutate_genome(&ga->population[i], kind, ga->mutation_sigma, ga->mutation_prob);
         switch (kind)
         {
             case MUTATE_NONE:
@@ -438,21 +1047,346 @@ static void ga_do_mutate(GAContext* ga)
         mutate_genome(&ga->population[i], MUTATE_WEIGHTS, 0.05f, 0.5f);
 
     ga->generation++;
+    ga_start_generation(ga);
+}
+
+// Steady-state mode: no generations. Each worker loops on
+//   pick parents (tournament) -> breed -> full rollout -> replace the worst
+// The population slots are guarded by one spinlock each (parents are copied out
+// under it), and the ranking is a min-heap on fitness behind a mutex that is
+// only held for the O(log n) replace, never during a rollout.
+#define GA_STEADY_TOURNAMENT 3
+
+typedef struct
+{
+    _Alignas(GA_CACHE_LINE) struct GASteady* st;
+    int       index;
+    pthread_t thread;
+    atomic_ullong evals;
+    atomic_ullong inserts;
+    atomic_ullong lock_wait_ns;
+    atomic_ullong run_ns;
+} GASteadyWorker;
+
+typedef struct GASteady
+{
+    GAContext*  ga;
+    float       dt;
+    int         steps;
+    int         thread_count;
+    atomic_int  stop;
+    atomic_flag* slot_lock;
+
+    pthread_mutex_t rank_lock;
+    int*        heap;      // slot indices, worst at heap[0]
+    int*        pos;       // slot -> heap position
+    float*      key;       // slot -> fitness
+    float       best;
+    Genome      champion;
+    float       champion_fitness;
+    int         champion_new;
+
+    unsigned long long last_poll_ns;
+    unsigned long long last_evals;
+    float       rate;
+    GASteadyWorker workers[GA_THREAD_COUNT];
+} GASteady;
+
+static void slot_lock(GASteady* st, int i)
+{
+    while (atomic_flag_test_and_set_explicit(&st->slot_lock[i], memory_order_acquire))
+        sched_yield();
+}
+
+static void slot_unlock(GASteady* st, int i)
+{
+    atomic_flag_clear_explicit(&st->slot_lock[i], memory_order_release);
+}
+
+static void heap_swap(GASteady* st, int a, int b)
+{
+    int sa = st->heap[a];
+    int sb = st->heap[b];
+    st->heap[a] = sb;
+    st->heap[b] = sa;
+    st->pos[sb] = a;
+    st->pos[sa] = b;
+}
+
+static void heap_sift_down(GASteady* st, int i)
+{
+    int n = st->ga->population_size;
+    for (;;)
+    {
+        int l = 2 * i + 1;
+        int r = l + 1;
+        int m = i;
+        if (l < n && st->key[st->heap[l]] < st->key[st->heap[m]])
+            m = l;
+        if (r < n && st->key[st->heap[r]] < st->key[st->heap[m]])
+            m = r;
+        if (m == i)
+            return;
+        heap_swap(st, i, m);
+        i = m;
+    }
+}
+
+static int steady_pick(GASteady* st)
+{
+    int n = st->ga->population_size;
+    int best = ga_rand() % n;
+    for (int k = 1; k < GA_STEADY_TOURNAMENT; ++k)
+    {
+        int c = ga_rand() % n;
+        slot_lock(st, c);
+        float fc = st->ga->population[c].fitness;
+        slot_unlock(st, c);
+        slot_lock(st, best);
+        float fb = st->ga->population[best].fitness;
+        slot_unlock(st, best);
+        if (fc > fb)
+            best = c;
+    }
+    return best;
+}
+
+static void* steady_worker(void* arg)
+{
+    GASteadyWorker* w = (GASteadyWorker*)arg;
+    GASteady* st = w->st;
+    GAContext* ga = st->ga;
+    ga_seed(0x9E3779B9u * (unsigned)(w->index + 1) ^ (unsigned)now_ns());
+    trace_bind(TRACE_TRACK_WORKER + w->index, "steady");
+    unsigned long long t_start = now_ns();
+
+    while (!atomic_load_explicit(&st->stop, memory_order_relaxed))
+    {
+        unsigned long long tr = trace_begin();
+        int p1 = steady_pick(st);
+        int p2 = steady_pick(st);
+        Genome a, b;
+        slot_lock(st, p1);
+        a = ga->population[p1];
+        slot_unlock(st, p1);
+        slot_lock(st, p2);
+        b = ga->population[p2];
+        slot_unlock(st, p2);
+
+        Genome child;
+        ga_breed(ga, &a, &b, &child);
+
+        QGenome q;
+        uint16_t h[HALF_MAX + HALF_SLACK] = {0};
+        const QGenome* qp = NULL;
+        const uint16_t* hp = NULL;
+        if (ga->eval_mode == GA_EVAL_INT8)
+        {
+            quant_genome(&child, &q, ga->max_speed_factor);
+            qp = &q;
+        }
+        else if (ga->eval_mode == GA_EVAL_FP16 || ga->eval_mode == GA_EVAL_BF16)
+        {
+            half_pack(&child, h, half_format(ga));
+            hp = h;
+        }
+        trace_end(tr, "breed", -1);
+        tr = trace_begin();
+        GAAgent agent;
+        reset_agent(ga, &agent);
+        ga_step_agent(ga, &agent, &child, qp, hp, st->dt, st->steps, 1);
+        trace_end(tr, "child", -1);
+
+        tr = trace_begin();
+        unsigned long long t0 = now_ns();
+        pthread_mutex_lock(&st->rank_lock);
+        atomic_fetch_add_explicit(&w->lock_wait_ns, now_ns() - t0, memory_order_relaxed);
+        int worst = st->heap[0];
+        if (child.fitness > st->key[worst])
+        {
+            slot_lock(st, worst);
+            ga->population[worst] = child;
+            slot_unlock(st, worst);
+            st->key[worst] = child.fitness;
+            heap_sift_down(st, 0);
+            if (child.fitness > st->best)
+                st->best = child.fitness;
+            if (child.fitness > st->champion_fitness)
+            {
+                st->champion = child;
+                st->champion_fitness = child.fitness;
+                st->champion_new = 1;
+            }
+            atomic_fetch_add_explicit(&w->inserts, 1, memory_order_relaxed);
+        }
+        pthread_mutex_unlock(&st->rank_lock);
+        trace_end(tr, "insert", -1);
+        atomic_fetch_add_explicit(&w->evals, 1, memory_order_relaxed);
+        atomic_store_explicit(&w->run_ns, now_ns() - t_start, memory_order_relaxed);
+    }
+    return NULL;
+}
+
+// Evaluates the current population once (the ranking needs real fitness), then
+// hands the population over to the steady workers until ga_steady_stop.
+int ga_steady_start(GAContext* ga, float dt)
+{
+    if (!ga || !ga->running || ga->steady || !ga->population || ga->population_size < 2)
+        return 0;
+    if (dt <= 0.f)
+        dt = 1.f / 120.f;
+    int n = ga->population_size;
+    int steps = (int)ceilf(ga->eval_duration / dt);
+    if (steps < 1)
+        steps = 1;
+
+    GASteady* st = NULL;
+    if (posix_memalign((void**)&st, GA_CACHE_LINE, sizeof(GASteady)) != 0)
+        return 0;
+    memset(st, 0, sizeof(*st));
+    st->slot_lock = malloc((size_t)n * sizeof(atomic_flag));
+    st->heap = malloc((size_t)n * sizeof(int));
+    st->pos = malloc((size_t)n * sizeof(int));
+    st->key = malloc((size_t)n * sizeof(float));
+    if (!st->slot_lock || !st->heap || !st->pos || !st->key)
+    {
+        free(st->slot_lock);
+        free(st->heap);
+        free(st->pos);
+        free(st->key);
+        free(st);
+        return 0;
+    }
+
+    if (ga->stage != GA_STAGE_EVAL || ga->eval_time > 0.f)
+        ga_reset_agents(ga);
+    ga_eval_parallel(ga, dt, steps, 0);
     ga->eval_time = 0.f;
-    ga->stage = GA_STAGE_EVAL;
 
-    for (int i = 0; i < ga->population_size; ++i)
+    st->ga = ga;
+    st->dt = dt;
+    st->steps = steps;
+    st->best = -1e9f;
+    st->champion = ga->champion;
+    st->champion_fitness = ga->has_champion ? ga->champion_fitness : -1e9f;
+    for (int i = 0; i < n; ++i)
     {
-        ga->population[i].fitness = 0.f;
-        reset_agent(ga, &ga->agents[i]);
+        atomic_flag_clear(&st->slot_lock[i]);
+        st->heap[i] = i;
+        st->pos[i] = i;
+        st->key[i] = ga->population[i].fitness;
+        if (st->key[i] > st->best)
+            st->best = st->key[i];
+        if (st->key[i] > st->champion_fitness)
+        {
+            st->champion = ga->population[i];
+            st->champion_fitness = st->key[i];
+            st->champion_new = 1;
+        }
     }
+    for (int i = n / 2 - 1; i >= 0; --i)
+        heap_sift_down(st, i);
+    pthread_mutex_init(&st->rank_lock, NULL);
+    atomic_store(&st->stop, 0);
+    st->last_poll_ns = now_ns();
+
+    st->thread_count = GA_THREAD_COUNT < n ? GA_THREAD_COUNT : n;
+    for (int t = 0; t < st->thread_count; ++t)
+    {
+        GASteadyWorker* w = &st->workers[t];
+        w->st = st;
+        w->index = t;
+        pthread_create(&w->thread, NULL, steady_worker, w);
+    }
+    ga->steady = st;
+    return 1;
+}
+
+// main-thread view: publishes champion / best into the context like a generation would
+void ga_steady_poll(GAContext* ga, GASteadyStats* out)
+{
+    if (!ga || !ga->steady)
+        return;
+    GASteady* st = ga->steady;
+    unsigned long long evals = 0, inserts = 0, wait_ns = 0, run_ns = 0;
+    for (int t = 0; t < st->thread_count; ++t)
+    {
+        evals += atomic_load_explicit(&st->workers[t].evals, memory_order_relaxed);
+        inserts += atomic_load_explicit(&st->workers[t].inserts, memory_order_relaxed);
+        wait_ns += atomic_load_explicit(&st->workers[t].lock_wait_ns, memory_order_relaxed);
+        run_ns += atomic_load_explicit(&st->workers[t].run_ns, memory_order_relaxed);
+    }
+
+    pthread_mutex_lock(&st->rank_lock);
+    float best = st->best;
+    float worst = st->key[st->heap[0]];
+    if (st->champion_new)
+    {
+        ga->champion = st->champion;
+        ga->champion_fitness = st->champion_fitness;
+        ga->has_champion = 1;
+        ga->display_active = 0;
+        st->champion_new = 0;
+    }
+    pthread_mutex_unlock(&st->rank_lock);
+
+    ga->gen_best_fitness = best;
+    if (best > ga->best_fitness)
+        ga->best_fitness = best;
+    ga->generation = (int)(evals / (unsigned long long)ga->population_size);
+
+    // rate over windows of at least half a second, polls come every frame
+    unsigned long long now = now_ns();
+    double span = (double)(now - st->last_poll_ns) * 1e-9;
+    if (span >= 0.5)
+    {
+        st->rate = (float)((double)(evals - st->last_evals) / span);
+        st->last_poll_ns = now;
+        st->last_evals = evals;
+    }
+    if (out)
+    {
+        out->evals = evals;
+        out->inserts = inserts;
+        out->evals_per_sec = st->rate;
+        out->best = best;
+        out->worst = worst;
+        out->lock_wait_pct = run_ns ? (float)(100.0 * (double)wait_ns / (double)run_ns) : 0.f;
+        out->threads = st->thread_count;
+    }
+}
+
+// Joins the workers and resumes the generational loop from the steady
+// population: it is ranked and bred once, exactly like after SELECT.
+void ga_steady_stop(GAContext* ga)
+{
+    if (!ga || !ga->steady)
+        return;
+    GASteady* st = ga->steady;
+    atomic_store(&st->stop, 1);
+    for (int t = 0; t < st->thread_count; ++t)
+        pthread_join(st->workers[t].thread, NULL);
+    ga_steady_poll(ga, NULL);
+    ga->steady = NULL;
+
+    pthread_mutex_destroy(&st->rank_lock);
+    free(st->slot_lock);
+    free(st->heap);
+    free(st->pos);
+    free(st->key);
+    free(st);
+
+    if (!ga->running)
+        return;
+    qsort(ga->population, (size_t)ga->population_size, sizeof(Genome), cmp_fitness_desc);
+    ga_do_mutate(ga);
 }
 
 void ga_init(GAContext* ga, int population_size)
 {
     if (!ga)
         return;
-    srand((unsigned)time(NULL));
+    ga_seed((unsigned)time(NULL));
     ga->population_size = population_size;
     ga->generation      = 0;
     ga->eval_time       = 0.f;
@@ -467,9 +1401,49 @@ void ga_init(GAContext* ga, int population_size)
     ga->display_active  = 0;
     ga->max_base_speed  = 600.f;
     ga->upright_threshold = -0.7f;
+    ga->control_period  = 1;
+    ga->pending_size    = 0;
+    ga->pending_period  = 0;
     ga->allow_remove_nodes = 0;
-    ga->population      = calloc((size_t)ga->population_size, sizeof(Genome));
-    ga->agents          = calloc((size_t)ga->population_size, sizeof(GAAgent));
+    ga->eval_mode       = GA_EVAL_FLOAT;
+    ga->pin_threads     = 0;
+    ga->scheduler       = GA_SCHED_STEAL;
+    ga->worker_count    = 0;
+    memset(ga->worker_stats, 0, sizeof(ga->worker_stats));
+    memset(&ga->arena, 0, sizeof(ga->arena));
+    ga->capacity        = 0;
+    ga->huge_pages      = ARENA_PAGES_NORMAL;
+    ga->scratch         = NULL;
+    ga->population      = NULL;
+    ga->agents          = NULL;
+    ga->qpopulation     = NULL;
+    ga->hpopulation     = NULL;
+    ga->recorder        = NULL;
+    ga->steady          = NULL;
+    ga->dist            = NULL;
+    ga->reward          = GA_REWARD_UPRIGHT;
+    ga->elite_fraction  = 0.3f;
+    ga->mutation_sigma  = 0.25f;
+    ga->mutation_prob   = 0.15f;
+    ga->reward_bonus    = 0.3f;
+    ga->reward_drop     = 0.6f;
+    ga->reward_effort   = 0.2f;
+    ga->refine_elites   = 0;
+    ga->refine_iterations = 3;
+    ga->refine_step     = 0.05f;
+    ga->refine_improved = 0;
+    ga->refine_gain     = 0.f;
+    ga->refine_ms       = 0.f;
+    ga->novelty_weight  = 0.f;
+    ga->novelty         = NULL;
+    ga->perf_counters   = 0;
+    memset(ga->perf_stage, 0, sizeof(ga->perf_stage));
+    if (population_size < 1 || !ga_build_arena(ga, population_size, 0))
+    {
+        ga_free(ga);
+        ga->population_size = 0;
+        return;
+    }
     for (int i = 0; i < ga->population_size; ++i)
         init_genome(&ga->population[i]);
 }
@@ -515,25 +1489,16 @@ void ga_start(GAContext* ga)
     ga->champion_fitness = -1e9f;
     ga->display_active = 0;
     ga->best_index = 0;
-    ga->stage = GA_STAGE_EVAL;
-    for (int i = 0; i < ga->population_size; ++i)
-    {
-        ga->population[i].fitness = 0.f;
-        reset_agent(ga, &ga->agents[i]);
-    }
+    ga_start_generation(ga);
+    traj_reset_generation(ga->recorder);
 }
 
 void ga_reset_agents(GAContext* ga)
 {
     if (!ga || !ga->agents)
         return;
-    for (int i = 0; i < ga->population_size; ++i)
-    {
-        ga->population[i].fitness = 0.f;
-        reset_agent(ga, &ga->agents[i]);
-    }
-    ga->eval_time = 0.f;
-    ga->stage = GA_STAGE_EVAL;
+    ga_start_generation(ga);
+    traj_reset_generation(ga->recorder);
     ga->best_index = 0;
     ga->display_active = 0;
 }
@@ -546,7 +1511,7 @@ void ga_update(GAContext* ga, float dt)
     if (ga->stage == GA_STAGE_EVAL)
     {
         ga->eval_time += dt;
-        ga_eval_parallel(ga, dt, 1);
+        ga_eval_parallel(ga, dt, 1, ga->eval_time >= ga->eval_duration);
 
         if (ga->eval_time < ga->eval_duration)
             return;
@@ -585,13 +1550,72 @@ void ga_run_generation(GAContext* ga, float dt)
         steps = 1;
 
     ga->eval_time = 0.f;
-    ga_eval_parallel(ga, dt, steps);
+    unsigned long long tr = trace_begin();
+    if (ga->dist)
+    {
+        // the workers are other processes, their counters are not ours to read
+        dist_evaluate(ga->dist, ga, dt);
+        ga->perf_stage[GA_STAGE_EVAL].valid = 0;
+    }
+    else
+    {
+        ga_eval_parallel(ga, dt, steps, 1);
+    }
+    trace_end(tr, "EVAL", ga->generation);
+    if (ga->refine_elites > 0)
+    {
+        // selection below ranks the refined elites with their new fitness
+        tr = trace_begin();
+        grad_refine_elites(ga, dt, steps);
+        trace_end(tr, "REFINE", ga->generation);
+    }
     ga->eval_time = ga->eval_duration;
+    ga_end_generation(ga);
+}
+
+void ga_eval_range(GAContext* ga, int start, int end, float dt, int steps)
+{
+    if (!ga || start < 0 || end > ga->population_size || start >= end)
+        return;
+    GAWorker w;
+    memset(&w, 0, sizeof(w));
+    w.ga = ga;
+    w.dt = dt;
+    w.steps = steps;
+    w.best_fitness = -1e9f;
+    w.score_novelty = 1;
+    eval_range(&w, start, end);
+}
+
+void ga_eval_population(GAContext* ga, float dt, int steps)
+{
+    if (!ga || !ga->population || dt <= 0.f)
+        return;
+    refresh_quantized(ga);
+    ga_eval_parallel(ga, dt, steps, 0);
+}
 
+void ga_end_generation(GAContext* ga)
+{
+    PerfSample p0, p1, p2;
+    if (ga->perf_counters)
+        perf_read(&ga->perf_self, &p0);
+    unsigned long long tr = trace_begin();
     ga->stage = GA_STAGE_SELECT;
     ga_do_select(ga);
+    trace_end(tr, "SELECT", -1);
+    if (ga->perf_counters)
+        perf_read(&ga->perf_self, &p1);
+    tr = trace_begin();
     ga->stage = GA_STAGE_MUTATE;
     ga_do_mutate(ga);
+    trace_end(tr, "MUTATE", -1);
+    if (ga->perf_counters)
+    {
+        perf_read(&ga->perf_self, &p2);
+        perf_delta(&p0, &p1, &ga->perf_stage[GA_STAGE_SELECT]);
+        perf_delta(&p1, &p2, &ga->perf_stage[GA_STAGE_MUTATE]);
+    }
 }
 
 void ga_display_step(GAContext* ga, float dt)
@@ -611,7 +1635,22 @@ void ga_display_step(GAContext* ga, float dt)
     }
 
     ga->eval_time += dt;
-    ga_step_agent(ga, &ga->display_agent, &ga->champion, dt, 0);
+    if (ga->eval_mode == GA_EVAL_INT8)
+    {
+        QGenome q;
+        quant_genome(&ga->champion, &q, ga->max_speed_factor);
+        ga_step_agent(ga, &ga->display_agent, &ga->champion, &q, NULL, dt, 1, 0);
+    }
+    else if (ga->eval_mode == GA_EVAL_FP16 || ga->eval_mode == GA_EVAL_BF16)
+    {
+        uint16_t h[HALF_MAX + HALF_SLACK] = {0};
+        half_pack(&ga->champion, h, half_format(ga));
+        ga_step_agent(ga, &ga->display_agent, &ga->champion, NULL, h, dt, 1, 0);
+    }
+    else
+    {
+        ga_step_agent(ga, &ga->display_agent, &ga->champion, NULL, NULL, dt, 1, 0);
+    }
     if (ga->eval_time >= ga->eval_duration)
     {
         reset_agent(ga, &ga->display_agent);
@@ -619,6 +1658,456 @@ void ga_display_step(GAContext* ga, float dt)
     }
 }
 
+float ga_eval_network(const Genome* g, const float in[GA_INPUTS])
+{
+    if (!g || !in)
+        return 0.f;
+    return eval_network(g, in);
+}
+
+int ga_set_reward(GAContext* ga, const char* name)
+{
+    if (!ga)
+        return 0;
+    int id = reward_find(name);
+    if (id < 0)
+        return 0;
+    ga->reward = id;
+    return 1;
+}
+
+void ga_set_thread_pinning(GAContext* ga, int enabled)
+{
+    if (!ga)
+        return;
+    ga->pin_threads = enabled ? 1 : 0;
+}
+
+// counters for SELECT/MUTATE belong to the calling thread: call this from the
+// thread that runs the generations. Returns the counters that could be opened.
+unsigned ga_set_perf_counters(GAContext* ga, int enabled)
+{
+    if (!ga)
+        return 0;
+    if (ga->perf_counters)
+        perf_close(&ga->perf_self);
+    ga->perf_counters = 0;
+    memset(ga->perf_stage, 0, sizeof(ga->perf_stage));
+    if (!enabled)
+        return 0;
+    unsigned valid = perf_open(&ga->perf_self);
+    if (!valid)
+    {
+        perf_close(&ga->perf_self);
+        return 0;
+    }
+    ga->perf_counters = 1;
+    return valid;
+}
+
+// mid-evaluation the agents are part way through their rollouts and the front
+// of the population is not the elites yet: such changes wait for the next
+// generation (ga_start_generation)
+static int mid_generation(const GAContext* ga)
+{
+    return ga->running && ga->stage == GA_STAGE_EVAL && ga->eval_time > 0.f;
+}
+
+int ga_resize_population(GAContext* ga, int size)
+{
+    if (!ga || !ga->population || size < 2)
+        return 0;
+    if (mid_generation(ga))
+    {
+        ga->pending_size = size == ga->population_size ? 0 : size;
+        return 1;
+    }
+    ga->pending_size = 0;
+    return resize_population(ga, size);
+}
+
+// Remaps the arena with the requested page mode; returns the mode obtained.
+int ga_set_huge_pages(GAContext* ga, int pages)
+{
+    if (!ga || !ga->population)
+        return ARENA_PAGES_NORMAL;
+    ga_steady_stop(ga);
+    int previous = ga->huge_pages;
+    ga->huge_pages = pages;
+    if (!ga_build_arena(ga, ga->capacity, ga->population_size))
+        ga->huge_pages = previous;
+    refresh_quantized(ga);
+    return ga->arena.pages;
+}
+
+void ga_set_eval_mode(GAContext* ga, int mode)
+{
+    if (!ga)
+        return;
+    ga->eval_mode = (mode >= GA_EVAL_INT8 && mode <= GA_EVAL_BF16) ? mode : GA_EVAL_FLOAT;
+    refresh_quantized(ga);
+}
+
+// 1 queries the network every physics step; the steady workers are stopped and
+// a change during an evaluation waits for the next generation, so no rollout
+// mixes two periods
+void ga_set_control_period(GAContext* ga, int period)
+{
+    if (!ga)
+        return;
+    ga_steady_stop(ga);
+    period = period < 1 ? 1 : (period > GA_HOLD_MAX ? GA_HOLD_MAX : period);
+    if (mid_generation(ga))
+    {
+        ga->pending_period = period == ga->control_period ? 0 : period;
+        return;
+    }
+    ga->pending_period = 0;
+    ga->control_period = period;
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Full rollouts of (up to 512 of) the current population at every control
+// period 1..GA_HOLD_MAX, single-threaded so all periods are timed on the same
+// core. Does not touch population fitness.
+void ga_hold_report(GAContext* ga, float dt, GAHoldReport* out)
+{
+    if (!ga || !out || !ga->population || ga->population_size < 1)
+        return;
+    if (dt <= 0.f)
+        dt = 1.f / 120.f;
+    int n = ga->population_size < 512 ? ga->population_size : 512;
+    int steps = (int)ceilf(ga->eval_duration / dt);
+    if (steps < 1)
+        steps = 1;
+    float* fit = malloc((size_t)n * GA_HOLD_MAX * sizeof(float));
+    if (!fit)
+        return;
+    memset(out, 0, sizeof(*out));
+    out->genomes = n;
+    out->steps = steps;
+    out->trained_period = ga->control_period;
+
+    GAContext env = *ga;
+    env.recorder = NULL;
+    GAAgent a;
+    for (int k = 0; k < GA_HOLD_MAX; ++k)
+    {
+        env.control_period = k + 1;
+        float best = -1e9f;
+        double sum = 0.0;
+        double t0 = now_sec();
+        for (int i = 0; i < n; ++i)
+        {
+            Genome g = ga->population[i];
+            reset_agent(&env, &a);
+            ga_step_agent(&env, &a, &g, NULL, NULL, dt, steps, 0);
+            fit[k * n + i] = a.fitness;
+            sum += a.fitness;
+            if (a.fitness > best)
+                best = a.fitness;
+        }
+        double t1 = now_sec();
+        out->steps_per_sec[k] = (float)((double)n * steps / (t1 - t0 > 1e-9 ? t1 - t0 : 1e-9));
+        out->mean_fitness[k] = (float)(sum / n);
+        out->best_fitness[k] = best;
+    }
+    const float* ref = &fit[(out->trained_period - 1) * n];
+    for (int k = 0; k < GA_HOLD_MAX; ++k)
+    {
+        double drift = 0.0;
+        for (int i = 0; i < n; ++i)
+            drift += fabsf(fit[k * n + i] - ref[i]);
+        out->mean_abs_drift[k] = (float)(drift / n);
+    }
+    free(fit);
+}
+
+// Full rollouts of the current population in float and int8, single-threaded so
+// both paths are timed on the same core. Does not touch population fitness.
+void ga_quant_report(GAContext* ga, float dt, GAQuantReport* out)
+{
+    if (!ga || !out || !ga->population || ga->population_size < 1)
+        return;
+    if (dt <= 0.f)
+        dt = 1.f / 120.f;
+    int n = ga->population_size;
+    int steps = (int)ceilf(ga->eval_duration / dt);
+    if (steps < 1)
+        steps = 1;
+
+    float* fit_f = malloc((size_t)n * sizeof(float));
+    float* fit_q = malloc((size_t)n * sizeof(float));
+    QGenome* qs = malloc((size_t)n * sizeof(QGenome));
+    if (!fit_f || !fit_q || !qs)
+    {
+        free(fit_f);
+        free(fit_q);
+        free(qs);
+        return;
+    }
+    for (int i = 0; i < n; ++i)
+        quant_genome(&ga->population[i], &qs[i], ga->max_speed_factor);
+
+    GAAgent a;
+    double t0 = now_sec();
+    for (int i = 0; i < n; ++i)
+    {
+        reset_agent(ga, &a);
+        ga_step_agent(ga, &a, &ga->population[i], NULL, NULL, dt, steps, 0);
+        fit_f[i] = a.fitness;
+    }
+    double t1 = now_sec();
+    for (int i = 0; i < n; ++i)
+    {
+        reset_agent(ga, &a);
+        ga_step_agent(ga, &a, &ga->population[i], &qs[i], NULL, dt, steps, 0);
+        fit_q[i] = a.fitness;
+    }
+    double t2 = now_sec();
+
+    // network alone, on a fixed sweep of inputs
+    const int net_evals = 1 << 20;
+    float in[GA_INPUTS];
+    volatile float sink = 0.f;
+    double t3 = now_sec();
+    for (int k = 0; k < net_evals; ++k)
+    {
+        in[0] = (float)(k & 255) / 127.5f - 1.f;
+        in[1] = sinf((float)k * 0.01f);
+        in[2] = cosf((float)k * 0.01f);
+        in[3] = (float)((k >> 8) & 15) - 7.5f;
+        sink += eval_network(&ga->population[k % n], in);
+    }
+    double t4 = now_sec();
+    for (int k = 0; k < net_evals; ++k)
+    {
+        in[0] = (float)(k & 255) / 127.5f - 1.f;
+        in[1] = sinf((float)k * 0.01f);
+        in[2] = cosf((float)k * 0.01f);
+        in[3] = (float)((k >> 8) & 15) - 7.5f;
+        sink += quant_eval_network(&qs[k % n], in);
+    }
+    double t5 = now_sec();
+    (void)sink;
+
+    int best_f = 0, best_q = 0;
+    double sum_drift = 0.0;
+    float max_drift = 0.f;
+    for (int i = 0; i < n; ++i)
+    {
+        float d = fabsf(fit_f[i] - fit_q[i]);
+        sum_drift += d;
+        if (d > max_drift)
+            max_drift = d;
+        if (fit_f[i] > fit_f[best_f])
+            best_f = i;
+        if (fit_q[i] > fit_q[best_q])
+            best_q = i;
+    }
+
+    out->genomes = n;
+    out->steps = steps;
+    out->mean_abs_drift = (float)(sum_drift / n);
+    out->max_abs_drift = max_drift;
+    out->best_float = fit_f[best_f];
+    out->best_int8 = fit_q[best_q];
+    out->same_best = (best_f == best_q);
+    out->float_steps_per_sec = (float)((double)n * steps / (t1 - t0 > 1e-9 ? t1 - t0 : 1e-9));
+    out->int8_steps_per_sec = (float)((double)n * steps / (t2 - t1 > 1e-9 ? t2 - t1 : 1e-9));
+    out->float_net_per_sec = (float)(net_evals / (t4 - t3 > 1e-9 ? t4 - t3 : 1e-9));
+    out->int8_net_per_sec = (float)(net_evals / (t5 - t4 > 1e-9 ? t5 - t4 : 1e-9));
+
+    free(fit_f);
+    free(fit_q);
+    free(qs);
+}
+
+typedef struct
+{
+    GAContext*      ga;
+    const Genome*   genomes;
+    const HalfPool* pool;
+    GAAgent*        agents;
+    int             start;
+    int             end;
+    int             steps;
+    float           dt;
+} GAHalfJob;
+
+// same sweep order as eval_range: every step walks the whole chunk
+static void* half_report_worker(void* arg)
+{
+    GAHalfJob* job = (GAHalfJob*)arg;
+    for (int i = job->start; i < job->end; ++i)
+        reset_agent(job->ga, &job->agents[i]);
+    for (int s = 0; s < job->steps; ++s)
+    {
+        for (int i = job->start; i < job->end; ++i)
+        {
+            const uint16_t* h = job->pool ? half_pool_record(job->pool, i) : NULL;
+            ga_step_agent(job->ga, &job->agents[i], (Genome*)&job->genomes[i], NULL, h, job->dt, 1, 0);
+        }
+    }
+    return NULL;
+}
+
+static double half_report_pass(GAContext* ga, const Genome* genomes, const HalfPool* pool, GAAgent* agents,
+                               int n, int threads, int steps, float dt)
+{
+    pthread_t tid[GA_THREAD_COUNT];
+    GAHalfJob jobs[GA_THREAD_COUNT];
+    int per = (n + threads - 1) / threads;
+    double t0 = now_sec();
+    for (int t = 0; t < threads; ++t)
+    {
+        int start = t * per;
+        int end = start + per < n ? start + per : n;
+        jobs[t] = (GAHalfJob){ga, genomes, pool, agents, start, end, steps, dt};
+        pthread_create(&tid[t], NULL, half_report_worker, &jobs[t]);
+    }
+    for (int t = 0; t < threads; ++t)
+        pthread_join(tid[t], NULL);
+    return now_sec() - t0;
+}
+
+// The population is tiled up to `genomes` entries and evaluated for `steps`
+// steps in both layouts by all worker threads, so the working set is well past
+// the caches and the pass is limited by how many bytes each step pulls in.
+void ga_half_report(GAContext* ga, float dt, int genomes, int format, GAHalfReport* out)
+{
+    if (!ga || !out || !ga->population || ga->population_size < 1 || genomes < 1)
+        return;
+    if (dt <= 0.f)
+        dt = 1.f / 120.f;
+    const int steps = 16;
+    int n = genomes;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = cpus > 0 ? (int)cpus : 1;
+    if (threads > GA_THREAD_COUNT)
+        threads = GA_THREAD_COUNT;
+    if (threads > n)
+        threads = n;
+
+    Genome* gs = malloc((size_t)n * sizeof(Genome));
+    GAAgent* af = malloc((size_t)n * sizeof(GAAgent));
+    GAAgent* ah = malloc((size_t)n * sizeof(GAAgent));
+    HalfPool pool = {0};
+    double hidden_sum = 0.0;
+    if (gs)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            gs[i] = ga->population[i % ga->population_size];
+            hidden_sum += gs[i].hidden;
+        }
+    }
+    if (!gs || !af || !ah || !half_pool_build(&pool, gs, n, format))
+    {
+        half_pool_free(&pool);
+        free(gs);
+        free(af);
+        free(ah);
+        return;
+    }
+
+    int saved_mode = ga->eval_mode;
+    ga->eval_mode = (format == HALF_BF16) ? GA_EVAL_BF16 : GA_EVAL_FP16;
+    double tf = half_report_pass(ga, gs, NULL, af, n, threads, steps, dt);
+    double th = half_report_pass(ga, gs, &pool, ah, n, threads, steps, dt);
+    ga->eval_mode = saved_mode;
+
+    float drift = 0.f;
+    for (int i = 0; i < n; ++i)
+    {
+        float d = fabsf(af[i].theta - ah[i].theta);
+        if (d > drift)
+            drift = d;
+    }
+
+    out->genomes = n;
+    out->steps = steps;
+    out->threads = threads;
+    out->format = format;
+    out->mean_hidden = (float)(hidden_sum / n);
+    out->float_bytes = (size_t)n * (sizeof(Genome) + sizeof(GAAgent));
+    out->half_bytes = half_pool_bytes(&pool) + (size_t)n * sizeof(GAAgent);
+    out->float_steps_per_sec = (float)((double)n * steps / (tf > 1e-9 ? tf : 1e-9));
+    out->half_steps_per_sec = (float)((double)n * steps / (th > 1e-9 ? th : 1e-9));
+    out->max_theta_drift = drift;
+
+    half_pool_free(&pool);
+    free(gs);
+    free(af);
+    free(ah);
+}
+
+// one float rollout from the standard start state; states[s] receives the state after step s
+float ga_rollout(GAContext* ga, const Genome* g, float dt, int steps, GAAgent* states)
+{
+    if (!ga || !g || dt <= 0.f)
+        return 0.f;
+    Genome local = *g;
+    GAAgent a;
+    reset_agent(ga, &a);
+    for (int s = 0; s < steps; ++s)
+    {
+        ga_step_agent(ga, &a, &local, NULL, NULL, dt, 1, 0);
+        if (states)
+            states[s] = a;
+    }
+    return a.fitness;
+}
+
+// Same, from any start state and with the weights of any eval mode. Without
+// `states` all steps go through one fused rollout kernel call, as in training.
+float ga_rollout_from(GAContext* ga, const Genome* g, const GAAgent* start, int mode, float dt, int steps,
+                      GAAgent* states)
+{
+    if (!ga || !g || dt <= 0.f)
+        return 0.f;
+    Genome local = *g;
+    QGenome q;
+    uint16_t h[HALF_MAX + HALF_SLACK] = {0};
+    const QGenome* qp = NULL;
+    const uint16_t* hp = NULL;
+    GAContext env = *ga; // the half kernel takes its format from eval_mode
+    env.eval_mode = mode;
+    env.recorder = NULL;
+    if (mode == GA_EVAL_INT8)
+    {
+        quant_genome(&local, &q, ga->max_speed_factor);
+        qp = &q;
+    }
+    else if (mode == GA_EVAL_FP16 || mode == GA_EVAL_BF16)
+    {
+        half_pack(&local, h, half_format(&env));
+        hp = h;
+    }
+    GAAgent a;
+    if (start)
+        a = *start;
+    else
+        reset_agent(ga, &a);
+    if (!states)
+    {
+        ga_step_agent(&env, &a, &local, qp, hp, dt, steps, 0);
+        return a.fitness;
+    }
+    for (int s = 0; s < steps; ++s)
+    {
+        ga_step_agent(&env, &a, &local, qp, hp, dt, 1, 0);
+        states[s] = a;
+    }
+    return a.fitness;
+}
+
 const GAAgent* ga_get_display_agent(const GAContext* ga)
 {
     if (!ga || !ga->has_champion)
@@ -637,12 +2126,32 @@ const GAAgent* ga_get_agents(const GAContext* ga, int* count, int* best_index)
     return ga->agents;
 }
 
+void ga_set_novelty(GAContext* ga, float weight, int k)
+{
+    if (!ga)
+        return;
+    ga->novelty_weight = weight > 0.f ? weight : 0.f;
+    if (weight > 0.f && !ga->novelty)
+        ga->novelty = novelty_create(k, NOVELTY_ADD_PROB);
+    else if (ga->novelty && k > 0)
+        ga->novelty->k = k < NOVELTY_K_MAX ? k : NOVELTY_K_MAX;
+}
+
 void ga_free(GAContext* ga)
 {
     if (!ga)
         return;
-    free(ga->population);
-    free(ga->agents);
+    ga_steady_stop(ga);
+    ga_set_perf_counters(ga, 0);
+    arena_free(&ga->arena);
+    half_pool_free(ga->hpopulation);
+    free(ga->hpopulation);
+    novelty_free(ga->novelty);
+    ga->novelty = NULL;
     ga->population = NULL;
     ga->agents = NULL;
+    ga->qpopulation = NULL;
+    ga->hpopulation = NULL;
+    ga->scratch = NULL;
+    ga->capacity = 0;
 }
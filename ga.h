@@ -1,10 +1,30 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arena.h"
+#include "perf.h"
+
+struct TrajRecorder;
+struct HalfPool;
+struct GASteady;
+struct DistPool;
+struct NoveltyArchive;
+struct GAScratch;
+
 #define GA_INPUTS 4
 #define GA_MAX_HIDDEN 8
 #define GA_STAGE_EVAL 0
 #define GA_STAGE_SELECT 1
 #define GA_STAGE_MUTATE 2
+#define GA_EVAL_FLOAT 0
+#define GA_EVAL_INT8 1
+#define GA_EVAL_FP16 2
+#define GA_EVAL_BF16 3
+#define GA_SCHED_STATIC 0
+#define GA_SCHED_STEAL 1
+#define GA_THREAD_COUNT 14
 
 typedef struct
 {
@@ -17,6 +37,33 @@ typedef struct
     float fitness;
 } Genome;
 
+// int8 copy of a Genome (see quant.h); inactive hidden rows are zeroed
+typedef struct
+{
+    int     hidden;
+    float   act_scale;                // inputs and hidden outputs as int16
+    int32_t act_mul;                  // Q15 tanh -> act_scale (Q16)
+    int8_t  w_in[GA_MAX_HIDDEN][GA_INPUTS];
+    int32_t b_h[GA_MAX_HIDDEN];
+    int32_t h_mul[GA_MAX_HIDDEN];     // per row: accumulator -> tanh table index
+    int8_t  w_out[GA_MAX_HIDDEN];
+    int8_t  w_direct[GA_INPUTS];
+    int32_t b_out;
+    int32_t o_mul;
+} QGenome;
+
+// per-worker timing of the last evaluation pass
+typedef struct
+{
+    float busy_ms;
+    float idle_ms;     // looking for blocks to steal
+    float wait_ms;     // done, waiting for the slowest worker
+    float utilization; // busy / wall time of the pass
+    int   blocks;
+    int   steals;
+    PerfSample perf;   // counters over this worker's chunks (perf_counters on)
+} GAWorkerStats;
+
 typedef struct
 {
     float slider_value;
@@ -29,11 +76,14 @@ typedef struct
     float above_time;
     float last_control;
     float fitness;
+    int   hold;          // physics steps left before the next network query
+    float novelty;       // last generation, novelty search on (novelty.h)
 } GAAgent;
 
 typedef struct
 {
     int     population_size;
+    int     pending_size;   // ga_resize_population during an evaluation, applied at the next generation; 0: none
     int     generation;
     float   eval_time;
     float   eval_duration;
@@ -55,7 +105,40 @@ typedef struct
     float   max_speed_factor;
     float   max_base_speed;
     float   upright_threshold;
+    int     control_period; // physics steps per network query, the command is held in between
+    int     pending_period; // ga_set_control_period during an evaluation, applied at the next generation; 0: none
     int     allow_remove_nodes;
+    int     eval_mode;
+    int     pin_threads;
+    int     scheduler;
+    int     reward;     // GA_REWARD_* (reward.h)
+
+    // hyperparameters: ga_init sets the defaults, tune.h sweeps them
+    float   elite_fraction;  // top share kept as parents each generation
+    float   mutation_sigma;  // weight perturbation range of the main mutation
+    float   mutation_prob;   // per-weight probability of the main mutation
+    float   reward_bonus;    // upright/gentle: bonus near angle 0
+    float   reward_drop;     // upright/gentle: penalty when falling
+    float   reward_effort;   // gentle: control effort cost
+
+    // gradient refinement of the elites after each evaluation (grad.h), 0: off
+    int     refine_elites;
+    int     refine_iterations;
+    float   refine_step;
+    int     refine_improved; // last generation: elites whose fitness went up
+    float   refine_gain;     // last generation: largest fitness gain
+    float   refine_ms;
+
+    // novelty search (novelty.h): selection ranks by fitness + novelty_weight * novelty,
+    // the champion stays the fittest; 0: off
+    float   novelty_weight;
+    struct NoveltyArchive* novelty;
+
+    int     perf_counters; // sample hardware counters each generation (perf.h)
+    PerfCounters perf_self; // this thread's counters for SELECT/MUTATE
+    PerfSample perf_stage[3]; // last generation, by GA_STAGE_*; EVAL sums the workers
+    int     worker_count;
+    GAWorkerStats worker_stats[GA_THREAD_COUNT];
 
     Genome  champion;
     int     has_champion;
@@ -63,10 +146,76 @@ typedef struct
     GAAgent display_agent;
     int     display_active;
 
+    // population, agents, int8 copies and eval-pass scratch, carved from one arena
+    Arena   arena;
+    int     capacity;   // genomes the arena holds; population_size <= capacity
+    int     huge_pages; // ARENA_PAGES_* requested
+    struct GAScratch* scratch;
     Genome* population;
     GAAgent* agents;
+    QGenome* qpopulation;
+    struct HalfPool* hpopulation;
+    struct TrajRecorder* recorder;
+    struct GASteady* steady;
+    struct DistPool* dist; // set: generations are evaluated on worker processes (dist.h)
 } GAContext;
 
+typedef struct
+{
+    int   genomes;
+    int   steps;
+    float mean_abs_drift;
+    float max_abs_drift;
+    float best_float;
+    float best_int8;
+    int   same_best;
+    float float_steps_per_sec;
+    float int8_steps_per_sec;
+    float float_net_per_sec;
+    float int8_net_per_sec;
+} GAQuantReport;
+
+// control period sweep over the current population, index N - 1
+#define GA_HOLD_MAX 8
+
+typedef struct
+{
+    int   genomes;
+    int   steps;
+    int   trained_period;              // control period of the population's training
+    float steps_per_sec[GA_HOLD_MAX];  // physics steps
+    float mean_fitness[GA_HOLD_MAX];
+    float best_fitness[GA_HOLD_MAX];
+    float mean_abs_drift[GA_HOLD_MAX]; // per genome, against its fitness at the trained period
+} GAHoldReport;
+
+// steady-state mode, sampled by ga_steady_poll
+typedef struct
+{
+    unsigned long long evals;
+    unsigned long long inserts;   // children that replaced the worst member
+    float evals_per_sec;          // over the last ~0.5 s
+    float best;
+    float worst;
+    float lock_wait_pct;          // share of worker time spent waiting on the ranking lock
+    int   threads;
+} GASteadyStats;
+
+// float32 layout vs packed half records, on a population scaled up to `genomes`
+typedef struct
+{
+    int    genomes;
+    int    steps;
+    int    threads;
+    int    format;
+    float  mean_hidden;
+    size_t float_bytes;  // Genome + GAAgent per genome
+    size_t half_bytes;   // pool + offsets + GAAgent
+    float  float_steps_per_sec;
+    float  half_steps_per_sec;
+    float  max_theta_drift; // after `steps`, float vs half weights
+} GAHalfReport;
+
 void  ga_init(GAContext* ga, int population_size);
 void  ga_set_env(GAContext* ga,
                  float track_left,
@@ -83,8 +232,42 @@ void  ga_set_env(GAContext* ga,
 void  ga_start(GAContext* ga);
 void  ga_update(GAContext* ga, float dt);
 void  ga_run_generation(GAContext* ga, float dt);
+// the two halves of ga_run_generation, for callers that schedule the evaluation
+// themselves (tune.h): rollouts of agents [start, end), then SELECT + MUTATE
+void  ga_eval_range(GAContext* ga, int start, int end, float dt, int steps);
+// the EVAL pass of ga_run_generation alone: `steps` steps of every agent from
+// its current state on the worker threads, fitness written to the population
+void  ga_eval_population(GAContext* ga, float dt, int steps);
+void  ga_end_generation(GAContext* ga);
+// breeding operators of ga_do_mutate, usable from any thread (per-thread generator)
+void  ga_breed(const GAContext* ga, const Genome* a, const Genome* b, Genome* child);
+void  ga_random_genome(Genome* g);
+// reseeds the calling thread's generator, which SELECT/MUTATE draw from; for a
+// reproducible run, call it after ga_init and redraw the population with
+// ga_random_genome (ga_init seeds from the clock)
+void  ga_seed_thread(unsigned seed);
 void  ga_display_step(GAContext* ga, float dt);
 void  ga_reset_agents(GAContext* ga);
+float ga_eval_network(const Genome* g, const float in[GA_INPUTS]);
+float ga_rollout(GAContext* ga, const Genome* g, float dt, int steps, GAAgent* states);
+float ga_rollout_from(GAContext* ga, const Genome* g, const GAAgent* start, int mode, float dt, int steps,
+                      GAAgent* states);
 const GAAgent* ga_get_display_agent(const GAContext* ga);
 const GAAgent* ga_get_agents(const GAContext* ga, int* count, int* best_index);
+void  ga_set_eval_mode(GAContext* ga, int mode);
+void  ga_set_control_period(GAContext* ga, int period);
+// weight <= 0 turns novelty off and keeps the archive; k: neighbors per query
+void  ga_set_novelty(GAContext* ga, float weight, int k);
+int   ga_set_reward(GAContext* ga, const char* name);
+void  ga_set_thread_pinning(GAContext* ga, int enabled);
+unsigned ga_set_perf_counters(GAContext* ga, int enabled);
+int   ga_resize_population(GAContext* ga, int size);
+int   ga_set_huge_pages(GAContext* ga, int pages);
+void  ga_get_worker_summary(const GAContext* ga, float* util_min, float* util_avg, float* wait_max_ms);
+void  ga_quant_report(GAContext* ga, float dt, GAQuantReport* out);
+void  ga_half_report(GAContext* ga, float dt, int genomes, int format, GAHalfReport* out);
+void  ga_hold_report(GAContext* ga, float dt, GAHoldReport* out);
+int   ga_steady_start(GAContext* ga, float dt);
+void  ga_steady_poll(GAContext* ga, GASteadyStats* out);
+void  ga_steady_stop(GAContext* ga);
 void  ga_free(GAContext* ga);
@@ -0,0 +1,310 @@
+#include "grad.h"
+#include "physics.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <time.h>
+
+#define GRAD_SMOOTH 0.01f // |x| ~ sqrt(x^2 + e^2) - e
+
+typedef struct
+{
+    GAContext*  ga;
+    int         index[GRAD_MAX_ELITES];
+    int         count;
+    float       dt;
+    int         steps;
+    atomic_int  next;
+    atomic_int  improved;
+    float       gain[GRAD_MAX_ELITES];
+} GradJob;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int grad_param_count(const Genome* g)
+{
+    return 1 + GA_INPUTS + g->hidden * (GA_INPUTS + 2);
+}
+
+void grad_pack(const Genome* g, float* p)
+{
+    int k = 0;
+    p[k++] = g->b_out;
+    for (int j = 0; j < GA_INPUTS; ++j)
+        p[k++] = g->w_direct[j];
+    for (int i = 0; i < g->hidden; ++i)
+    {
+        for (int j = 0; j < GA_INPUTS; ++j)
+            p[k++] = g->w_in[i][j];
+        p[k++] = g->b_h[i];
+        p[k++] = g->w_out[i];
+    }
+}
+
+void grad_unpack(Genome* g, const float* p)
+{
+    int k = 0;
+    g->b_out = p[k++];
+    for (int j = 0; j < GA_INPUTS; ++j)
+        g->w_direct[j] = p[k++];
+    for (int i = 0; i < g->hidden; ++i)
+    {
+        for (int j = 0; j < GA_INPUTS; ++j)
+            g->w_in[i][j] = p[k++];
+        g->b_h[i] = p[k++];
+        g->w_out[i] = p[k++];
+    }
+}
+
+// smoothed |x| and its derivative
+static float smooth_abs(float x, float* d)
+{
+    float r = sqrtf(x * x + GRAD_SMOOTH * GRAD_SMOOTH);
+    *d = x / r;
+    return r - GRAD_SMOOTH;
+}
+
+float grad_rollout(const GAContext* ga, const Genome* g, float dt, int steps, float* grad)
+{
+    const int P = grad_param_count(g);
+    const int H = g->hidden;
+    const float W = ga->track_width;
+    const float center = ga->track_left + W * 0.5f;
+    const int smooth_up = ga->reward != GA_REWARD_HEIGHT;
+
+    // state (the GA's physics, physics.h) and its tangents
+    const PhysicsBody body = physics_body(ga);
+    PhysicsState st;
+    physics_reset(ga, &st);
+    float d_slider[GRAD_MAX_PARAMS] = {0}, d_px[GRAD_MAX_PARAMS] = {0}, d_pv[GRAD_MAX_PARAMS] = {0};
+    float d_th[GRAD_MAX_PARAMS] = {0}, d_om[GRAD_MAX_PARAMS] = {0};
+    float u = 0.f, d_u[GRAD_MAX_PARAMS] = {0};
+    float d_fit[GRAD_MAX_PARAMS] = {0};
+    float fit = 0.f;
+    int hold = 0;
+
+    for (int s = 0; s < steps; ++s)
+    {
+        if (hold > 0)
+        {
+            hold--;
+        }
+        else
+        {
+            // network, as eval_network, with d(out)/d(weights) through the inputs and directly
+            float x[GA_INPUTS];
+            physics_inputs(st.slider, st.theta, st.omega, x, PHYSICS_LIBM);
+            float c = x[2], sn = x[1];
+            float h[GA_MAX_HIDDEN], dz[GA_MAX_HIDDEN][GRAD_MAX_PARAMS];
+            for (int i = 0; i < H; ++i)
+            {
+                float z = g->b_h[i];
+                for (int j = 0; j < GA_INPUTS; ++j)
+                    z += g->w_in[i][j] * x[j];
+                h[i] = tanhf(z);
+                for (int p = 0; p < P; ++p)
+                    dz[i][p] = g->w_in[i][0] * 2.f * d_slider[p] + g->w_in[i][1] * c * d_th[p]
+                             - g->w_in[i][2] * sn * d_th[p] + g->w_in[i][3] * d_om[p];
+                int base = 1 + GA_INPUTS + i * (GA_INPUTS + 2);
+                for (int j = 0; j < GA_INPUTS; ++j)
+                    dz[i][base + j] += x[j];
+                dz[i][base + GA_INPUTS] += 1.f;
+            }
+            float o = g->b_out;
+            for (int j = 0; j < GA_INPUTS; ++j)
+                o += g->w_direct[j] * x[j];
+            for (int i = 0; i < H; ++i)
+                o += g->w_out[i] * h[i];
+            float y = tanhf(o);
+            float dy = (1.f - y * y) * ga->max_base_speed;
+            for (int p = 0; p < P; ++p)
+            {
+                float d_o = g->w_direct[0] * 2.f * d_slider[p] + g->w_direct[1] * c * d_th[p]
+                          - g->w_direct[2] * sn * d_th[p] + g->w_direct[3] * d_om[p];
+                for (int i = 0; i < H; ++i)
+                    d_o += g->w_out[i] * (1.f - h[i] * h[i]) * dz[i][p];
+                d_u[p] = dy * d_o;
+            }
+            d_u[0] += dy;
+            for (int j = 0; j < GA_INPUTS; ++j)
+                d_u[1 + j] += dy * x[j];
+            for (int i = 0; i < H; ++i)
+                d_u[1 + GA_INPUTS + i * (GA_INPUTS + 2) + GA_INPUTS + 1] += dy * h[i];
+            u = y * ga->max_base_speed;
+            hold = ga->control_period - 1;
+        }
+
+        // physics_step, then its tangents; a clamp zeroes the tangent it clamps
+        PhysicsTrace t = physics_step(ga, &body, &st, u, dt, PHYSICS_NO_REWARD, PHYSICS_LIBM);
+        for (int p = 0; p < P; ++p)
+            d_slider[p] = t.slider_clamped ? 0.f : d_slider[p] + d_u[p] * dt / W;
+
+        float d_acc[GRAD_MAX_PARAMS];
+        for (int p = 0; p < P; ++p)
+            d_acc[p] = body.base_k * (W * d_slider[p] - d_px[p]) - body.base_d * d_pv[p];
+        for (int p = 0; p < P; ++p)
+        {
+            d_pv[p] = t.pivot_clamped ? 0.f : d_pv[p] + d_acc[p] * dt;
+            d_px[p] = t.pivot_clamped ? 0.f : d_px[p] + d_pv[p] * dt;
+        }
+
+        float acc = t.pivot_acc, sn = t.sin_theta, c = t.cos_theta;
+        for (int p = 0; p < P; ++p)
+        {
+            float d_thdd = -(body.gravity / body.length) * c * d_th[p] - (d_acc[p] / body.length) * c
+                         + (acc / body.length) * sn * d_th[p] - body.damping * d_om[p];
+            d_om[p] = t.omega_clamped ? 0.f : d_om[p] + d_thdd * dt;
+        }
+        for (int p = 0; p < P; ++p)
+            d_th[p] += d_om[p] * dt;
+
+        // surrogate reward
+        float px = st.pivot_x, pv = st.pivot_v, om = st.omega;
+        c = cosf(st.theta);
+        sn = sinf(st.theta);
+        float r, dr_th;
+        if (smooth_up)
+        {
+            float up = 1.f / (1.f + expf(-(ga->upright_threshold - c) / GRAD_TAU));
+            r = up;
+            dr_th = up * (1.f - up) * sn / GRAD_TAU;
+        }
+        else
+        {
+            float height = 0.5f * (1.f - c);
+            r = height * height;
+            dr_th = height * sn;
+        }
+        float da, db, dc;
+        float base = smooth_abs((px - center) / (W * 0.5f), &da);
+        float speed = smooth_abs(pv / ga->max_base_speed, &db);
+        float spin = smooth_abs(om, &dc);
+        r -= 0.15f * base + 0.05f * speed + 0.08f * spin;
+        float dr_px = -0.15f * da / (W * 0.5f);
+        float dr_pv = -0.05f * db / ga->max_base_speed;
+        float dr_om = -0.08f * dc;
+        float dr_u = 0.f;
+        if (ga->reward == GA_REWARD_GENTLE)
+        {
+            float e = u / ga->max_base_speed;
+            r -= ga->reward_effort * e * e;
+            dr_u = -2.f * ga->reward_effort * e / ga->max_base_speed;
+        }
+        fit += dt * r;
+        for (int p = 0; p < P; ++p)
+            d_fit[p] += dt * (dr_th * d_th[p] + dr_px * d_px[p] + dr_pv * d_pv[p] + dr_om * d_om[p] + dr_u * d_u[p]);
+    }
+    if (grad)
+        memcpy(grad, d_fit, (size_t)P * sizeof(float));
+    return fit;
+}
+
+int grad_refine(GAContext* ga, Genome* g, float dt, int steps, int iterations, float step)
+{
+    const int P = grad_param_count(g);
+    float w[GRAD_MAX_PARAMS], d[GRAD_MAX_PARAMS];
+    int improved = 0;
+    for (int it = 0; it < iterations && step > 1e-5f; ++it)
+    {
+        grad_rollout(ga, g, dt, steps, d);
+        double norm = 0.0;
+        for (int p = 0; p < P; ++p)
+            norm += (double)d[p] * d[p];
+        if (norm <= 0.0 || !isfinite(norm))
+            break;
+        float scale = step / (float)sqrt(norm);
+        grad_pack(g, w);
+        for (int p = 0; p < P; ++p)
+            w[p] += scale * d[p];
+        Genome trial = *g;
+        grad_unpack(&trial, w);
+        trial.fitness = ga_rollout_from(ga, &trial, NULL, ga->eval_mode, dt, steps, NULL);
+        if (trial.fitness > g->fitness)
+        {
+            *g = trial;
+            improved = 1;
+            step *= 1.5f;
+        }
+        else
+        {
+            step *= 0.5f;
+        }
+    }
+    return improved;
+}
+
+static void* refine_worker(void* arg)
+{
+    GradJob* job = (GradJob*)arg;
+    GAContext* ga = job->ga;
+    for (;;)
+    {
+        int k = atomic_fetch_add(&job->next, 1);
+        if (k >= job->count)
+            break;
+        Genome* g = &ga->population[job->index[k]];
+        float before = g->fitness;
+        if (grad_refine(ga, g, job->dt, job->steps, ga->refine_iterations, ga->refine_step))
+            atomic_fetch_add(&job->improved, 1);
+        job->gain[k] = g->fitness - before;
+    }
+    return NULL;
+}
+
+void grad_refine_elites(GAContext* ga, float dt, int steps)
+{
+    if (!ga || ga->refine_elites < 1 || ga->refine_iterations < 1 || !ga->population)
+        return;
+    double t0 = now_sec();
+    GradJob job;
+    memset(&job, 0, sizeof(job));
+    job.ga = ga;
+    job.dt = dt;
+    job.steps = steps;
+    job.count = ga->refine_elites < ga->population_size ? ga->refine_elites : ga->population_size;
+    job.count = job.count < GRAD_MAX_ELITES ? job.count : GRAD_MAX_ELITES;
+    atomic_init(&job.next, 0);
+    atomic_init(&job.improved, 0);
+
+    // the `count` fittest, best first (insertion into a short sorted list)
+    int n = 0;
+    for (int i = 0; i < ga->population_size; ++i)
+    {
+        float f = ga->population[i].fitness;
+        if (n == job.count && f <= ga->population[job.index[n - 1]].fitness)
+            continue;
+        int at = n < job.count ? n++ : n - 1;
+        while (at > 0 && ga->population[job.index[at - 1]].fitness < f)
+        {
+            job.index[at] = job.index[at - 1];
+            at--;
+        }
+        job.index[at] = i;
+    }
+
+    int threads = job.count < GA_THREAD_COUNT ? job.count : GA_THREAD_COUNT;
+    pthread_t tid[GA_THREAD_COUNT];
+    int started = 0;
+    for (int t = 1; t < threads; ++t)
+    {
+        if (pthread_create(&tid[t], NULL, refine_worker, &job) != 0)
+            break;
+        started++;
+    }
+    refine_worker(&job);
+    for (int t = 1; t <= started; ++t)
+        pthread_join(tid[t], NULL);
+
+    ga->refine_improved = atomic_load(&job.improved);
+    ga->refine_gain = 0.f;
+    for (int k = 0; k < job.count; ++k)
+        ga->refine_gain = job.gain[k] > ga->refine_gain ? job.gain[k] : ga->refine_gain;
+    ga->refine_ms = (float)((now_sec() - t0) * 1e3);
+}
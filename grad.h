@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ga.h"
+
+// Gradient refinement of elites.
+// grad_rollout runs the rollout of ga_step_agent (physics, eval_network,
+// control hold) in forward mode: every state variable carries its tangent
+// with respect to each weight of the genome, so one rollout gives the whole
+// gradient. The GA rewards are step functions of the angle (upright threshold,
+// drop penalty, clamp at 0), so the gradient is taken of a smooth surrogate:
+//   upright/gentle  sigmoid((upright_threshold - cos theta) / GRAD_TAU)
+//   height          (0.5 (1 - cos theta))^2
+// minus the motion penalty of reward.h with |x| smoothed, and the squared
+// effort for gentle.
+// grad_refine takes normalized ascent steps on the surrogate and keeps a step
+// only when the true fitness (the training rollout) improves, so refinement
+// never loses fitness.
+//
+// Packed weights: b_out, w_direct[GA_INPUTS], then per hidden unit
+// w_in[GA_INPUTS], b_h, w_out.
+
+#define GRAD_MAX_PARAMS (1 + GA_INPUTS + GA_MAX_HIDDEN * (GA_INPUTS + 2))
+#define GRAD_TAU        0.05f
+#define GRAD_MAX_ELITES 64
+
+int   grad_param_count(const Genome* g);
+void  grad_pack(const Genome* g, float* p);
+void  grad_unpack(Genome* g, const float* p);
+// surrogate return of the rollout from the GA's start state, `grad` gets its
+// derivative for every packed weight
+float grad_rollout(const GAContext* ga, const Genome* g, float dt, int steps, float* grad);
+// up to `iterations` accepted-if-better steps of size `step` (weight units);
+// g->fitness must hold its true fitness, it is updated with the result
+int   grad_refine(GAContext* ga, Genome* g, float dt, int steps, int iterations, float step);
+// refines the ga->refine_elites fittest genomes of the evaluated population,
+// one thread per genome; fills the refine_* stats of the context
+void  grad_refine_elites(GAContext* ga, float dt, int steps);
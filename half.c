@@ -0,0 +1,264 @@
+#include "half.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__F16C__) && defined(__AVX2__)
+#include <immintrin.h>
+#define HALF_USE_F16C 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define HALF_USE_NEON 1
+#endif
+
+// round to nearest even, overflow goes to inf
+static uint16_t fp16_from_float(float f)
+{
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    uint32_t sign = (x >> 16) & 0x8000u;
+    uint32_t fexp = (x >> 23) & 0xffu;
+    uint32_t mant = x & 0x7fffffu;
+    if (fexp == 0xffu)
+        return (uint16_t)(sign | 0x7c00u | (mant ? 0x200u : 0u));
+    int32_t exp = (int32_t)fexp - 127 + 15;
+    if (exp >= 31)
+        return (uint16_t)(sign | 0x7c00u);
+    if (exp <= 0)
+    {
+        // subnormal half
+        if (exp < -10)
+            return (uint16_t)sign;
+        mant |= 0x800000u;
+        uint32_t shift = (uint32_t)(14 - exp);
+        uint32_t h = mant >> shift;
+        uint32_t rem = mant & ((1u << shift) - 1u);
+        uint32_t mid = 1u << (shift - 1u);
+        if (rem > mid || (rem == mid && (h & 1u)))
+            h++;
+        return (uint16_t)(sign | h);
+    }
+    uint32_t h = sign | ((uint32_t)exp << 10) | (mant >> 13);
+    uint32_t rem = mant & 0x1fffu;
+    if (rem > 0x1000u || (rem == 0x1000u && (h & 1u)))
+        h++;
+    return (uint16_t)h;
+}
+
+static float fp16_to_float(uint16_t h)
+{
+    uint32_t sign = (uint32_t)(h & 0x8000u) << 16;
+    int32_t exp = (h >> 10) & 0x1f;
+    uint32_t mant = h & 0x3ffu;
+    uint32_t x;
+    if (exp == 0)
+    {
+        if (mant == 0)
+        {
+            x = sign;
+        }
+        else
+        {
+            exp = 1;
+            while (!(mant & 0x400u))
+            {
+                mant <<= 1;
+                exp--;
+            }
+            mant &= 0x3ffu;
+            x = sign | ((uint32_t)(exp + 112) << 23) | (mant << 13);
+        }
+    }
+    else if (exp == 31)
+    {
+        x = sign | 0x7f800000u | (mant << 13);
+    }
+    else
+    {
+        x = sign | ((uint32_t)(exp + 112) << 23) | (mant << 13);
+    }
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+uint16_t half_from_float(float f, int format)
+{
+    if (format == HALF_FP16)
+        return fp16_from_float(f);
+    uint32_t x;
+    memcpy(&x, &f, sizeof(x));
+    x += 0x7fffu + ((x >> 16) & 1u);
+    return (uint16_t)(x >> 16);
+}
+
+float half_to_float(uint16_t h, int format)
+{
+    if (format == HALF_FP16)
+        return fp16_to_float(h);
+    uint32_t x = (uint32_t)h << 16;
+    float f;
+    memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+void half_pack(const Genome* g, uint16_t* dst, int format)
+{
+    dst[0] = (uint16_t)g->hidden;
+    dst[1] = half_from_float(g->b_out, format);
+    for (int j = 0; j < GA_INPUTS; ++j)
+        dst[2 + j] = half_from_float(g->w_direct[j], format);
+    uint16_t* col = dst + HALF_HEADER;
+    int n = g->hidden;
+    for (int i = 0; i < n; ++i)
+    {
+        for (int j = 0; j < GA_INPUTS; ++j)
+            col[j * n + i] = half_from_float(g->w_in[i][j], format);
+        col[GA_INPUTS * n + i] = half_from_float(g->b_h[i], format);
+        col[(GA_INPUTS + 1) * n + i] = half_from_float(g->w_out[i], format);
+    }
+}
+
+void half_unpack(const uint16_t* rec, Genome* g, int format)
+{
+    memset(g, 0, sizeof(*g));
+    g->hidden = rec[0];
+    g->b_out = half_to_float(rec[1], format);
+    for (int j = 0; j < GA_INPUTS; ++j)
+        g->w_direct[j] = half_to_float(rec[2 + j], format);
+    const uint16_t* col = rec + HALF_HEADER;
+    int n = g->hidden;
+    for (int i = 0; i < n; ++i)
+    {
+        for (int j = 0; j < GA_INPUTS; ++j)
+            g->w_in[i][j] = half_to_float(col[j * n + i], format);
+        g->b_h[i] = half_to_float(col[GA_INPUTS * n + i], format);
+        g->w_out[i] = half_to_float(col[(GA_INPUTS + 1) * n + i], format);
+    }
+}
+
+// Hidden units are stored column-wise ([w_in0 x hidden] .. [w_in3 x hidden]
+// [b_h x hidden] [w_out x hidden]) so one 8-half load widens a whole column and
+// the hidden pre-activations are computed for all units at once.
+#if defined(HALF_USE_F16C)
+static inline __m256 load8(const uint16_t* src, int format)
+{
+    __m128i h = _mm_loadu_si128((const __m128i*)src);
+    if (format == HALF_FP16)
+        return _mm256_cvtph_ps(h);
+    return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(h), 16));
+}
+#endif
+
+static inline void widen8(const uint16_t* src, int format, float dst[8])
+{
+#if defined(HALF_USE_F16C)
+    _mm256_storeu_ps(dst, load8(src, format));
+#elif defined(HALF_USE_NEON)
+    for (int k = 0; k < 8; k += 4)
+    {
+        uint16x4_t h = vld1_u16(src + k);
+        float32x4_t f = (format == HALF_FP16)
+                      ? vcvt_f32_f16(vreinterpret_f16_u16(h))
+                      : vreinterpretq_f32_u32(vshll_n_u16(h, 16));
+        vst1q_f32(dst + k, f);
+    }
+#else
+    for (int k = 0; k < 8; ++k)
+        dst[k] = half_to_float(src[k], format);
+#endif
+}
+
+float half_eval_network(const uint16_t* rec, int format, const float in[GA_INPUTS])
+{
+    int hidden = rec[0];
+    float head[8];
+    widen8(rec, format, head);
+
+    float out = head[1];
+    for (int j = 0; j < GA_INPUTS; ++j)
+        out += head[2 + j] * in[j];
+    if (hidden == 0)
+        return tanhf(out);
+
+    const uint16_t* col = rec + HALF_HEADER;
+    float pre[8];
+#if defined(HALF_USE_F16C)
+    __m256 sum = load8(col + GA_INPUTS * hidden, format);
+    for (int j = 0; j < GA_INPUTS; ++j)
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(load8(col + j * hidden, format), _mm256_set1_ps(in[j])));
+    _mm256_storeu_ps(pre, sum);
+#else
+    widen8(col + GA_INPUTS * hidden, format, pre);
+    for (int j = 0; j < GA_INPUTS; ++j)
+    {
+        float w[8];
+        widen8(col + j * hidden, format, w);
+        for (int i = 0; i < hidden; ++i)
+            pre[i] += w[i] * in[j];
+    }
+#endif
+    float wo[8];
+    widen8(col + (GA_INPUTS + 1) * hidden, format, wo);
+    for (int i = 0; i < hidden; ++i)
+        out += wo[i] * tanhf(pre[i]);
+    return tanhf(out);
+}
+
+int half_pool_build(HalfPool* pool, const Genome* genomes, int count, int format)
+{
+    if (!pool || (!genomes && count > 0))
+        return 0;
+    size_t need = HALF_SLACK;
+    for (int i = 0; i < count; ++i)
+        need += half_record_size(genomes[i].hidden);
+
+    if (count > pool->count || !pool->offset)
+    {
+        uint32_t* offset = realloc(pool->offset, (size_t)(count ? count : 1) * sizeof(uint32_t));
+        if (!offset)
+            return 0;
+        pool->offset = offset;
+    }
+    if (need > pool->capacity)
+    {
+        // grow with headroom: hidden sizes drift a little every generation
+        size_t cap = need + need / 8;
+        void* p = NULL;
+        if (posix_memalign(&p, 64, cap * sizeof(uint16_t)) != 0)
+            return 0;
+        free(pool->data);
+        pool->data = p;
+        pool->capacity = cap;
+    }
+
+    size_t at = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        pool->offset[i] = (uint32_t)at;
+        half_pack(&genomes[i], pool->data + at, format);
+        at += half_record_size(genomes[i].hidden);
+    }
+    memset(pool->data + at, 0, HALF_SLACK * sizeof(uint16_t));
+    pool->used = at;
+    pool->count = count;
+    pool->format = format;
+    return 1;
+}
+
+size_t half_pool_bytes(const HalfPool* pool)
+{
+    if (!pool)
+        return 0;
+    return (pool->used + HALF_SLACK) * sizeof(uint16_t) + (size_t)pool->count * sizeof(uint32_t);
+}
+
+void half_pool_free(HalfPool* pool)
+{
+    if (!pool)
+        return;
+    free(pool->data);
+    free(pool->offset);
+    memset(pool, 0, sizeof(*pool));
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ga.h"
+
+// Half-precision genome storage.
+// A record holds only the active hidden units, as fp16 or bf16:
+//   [hidden, b_out, w_direct x4] then the columns w_in0..w_in3, b_h, w_out
+// so a genome takes 12 + 12 * hidden bytes instead of sizeof(Genome).
+// Records are packed back to back in one pool and widened to float inside the
+// evaluation kernel (F16C / NEON when available).
+
+#define HALF_FP16   0
+#define HALF_BF16   1
+
+#define HALF_HEADER 6
+#define HALF_ROW    6 // halves per hidden unit
+#define HALF_MAX    (HALF_HEADER + HALF_ROW * GA_MAX_HIDDEN)
+#define HALF_SLACK  8 // kernels load 8 halves at a time past the last record
+
+typedef struct HalfPool
+{
+    int       format;
+    int       count;
+    uint16_t* data;
+    size_t    used;     // in halves
+    size_t    capacity; // in halves
+    uint32_t* offset;   // start of each record, in halves
+} HalfPool;
+
+static inline size_t half_record_size(int hidden)
+{
+    return (size_t)(HALF_HEADER + HALF_ROW * hidden);
+}
+
+uint16_t half_from_float(float f, int format);
+float    half_to_float(uint16_t h, int format);
+
+void  half_pack(const Genome* g, uint16_t* dst, int format);
+void  half_unpack(const uint16_t* rec, Genome* g, int format);
+float half_eval_network(const uint16_t* rec, int format, const float in[GA_INPUTS]);
+
+int    half_pool_build(HalfPool* pool, const Genome* genomes, int count, int format);
+size_t half_pool_bytes(const HalfPool* pool);
+void   half_pool_free(HalfPool* pool);
+
+static inline const uint16_t* half_pool_record(const HalfPool* pool, int i)
+{
+    return pool->data + pool->offset[i];
+}
@@ -4,9 +4,28 @@
 #include <stdlib.h>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "pendulum.h"
 #include "ga.h"
+#include "bench.h"
+#include "chain.h"
+#include "check.h"
+#include "control.h"
+#include "dist.h"
+#include "env.h"
+#include "half.h"
+#include "mppi.h"
+#include "novelty.h"
+#include "ooc.h"
+#include "reward.h"
+#include "sparse.h"
+#include "sweep.h"
+#include "trace.h"
+#include "traj.h"
+#include "tune.h"
 
 static float clampf(float v, float lo, float hi)
 {
@@ -128,20 +147,237 @@ static void draw_network(sfRenderWindow* window, const GAContext* ga, sfVector2u
     sfCircleShape_destroy(node);
 }
 
-int main(void)
+static void draw_swing(sfRenderWindow* window, sfRectangleShape* rod, sfCircleShape* bob,
+                       sfVector2f pivot, sfVector2f bob_pos, sfColor col)
 {
-    const sfVideoMode mode = {1400, 1050, 32};
-    sfRenderWindow* window =
-        sfRenderWindow_create(mode, "CSFML Pendulum", sfResize | sfClose, sfWindowed, NULL);
-    if (!window)
-        return EXIT_FAILURE;
+    sfRectangleShape_setFillColor(rod, col);
+    sfCircleShape_setFillColor(bob, col);
+
+    float dx = bob_pos.x - pivot.x;
+    float dy = bob_pos.y - pivot.y;
+    float len = sqrtf(dx * dx + dy * dy);
+    float angle = atan2f(dy, dx) * 180.f / (float)M_PI;
+    sfRectangleShape_setSize(rod, (sfVector2f){len, 2.f});
+    sfRectangleShape_setPosition(rod, pivot);
+    sfRectangleShape_setRotation(rod, angle);
+    sfCircleShape_setPosition(bob, bob_pos);
+
+    sfRenderWindow_drawRectangleShape(window, rod, NULL);
+    sfRenderWindow_drawCircleShape(window, bob, NULL);
+}
+
+static bool replay_load(TrajFile* tf, TrajTrack* track, int index)
+{
+    traj_free_track(track);
+    if (!tf || tf->track_count == 0)
+        return false;
+    int n = (int)tf->track_count;
+    index = ((index % n) + n) % n;
+    return traj_load_track(tf, (uint32_t)index, track) != 0;
+}
+
+static const char* eval_names[] = {"F32", "INT8", "FP16", "BF16"};
+
+static sfColor heat_color(float t)
+{
+    t = clampf(t, 0.f, 1.f);
+    // red -> yellow -> green, same palette as the network links
+    if (t < 0.5f)
+    {
+        float u = t * 2.f;
+        return (sfColor){0xFF, (uint8_t)(0x66 + (0xEE - 0x66) * u), (uint8_t)(0x66 - (0x66 - 0x2A) * u), 0xFF};
+    }
+    float u = (t - 0.5f) * 2.f;
+    return (sfColor){(uint8_t)(0xF4 - (0xF4 - 0x6A) * u), (uint8_t)(0xEE - (0xEE - 0xE3) * u), (uint8_t)(0x2A + (0x74 - 0x2A) * u), 0xFF};
+}
+
+static void draw_heatmap(sfRenderWindow* window, const SweepResult* r, const SweepConfig* cfg, sfText* label)
+{
+    if (!window || !r || !cfg || !r->cell_mean || r->nx < 1 || r->ny < 1)
+        return;
+
+    const float panel_x = 24.f;
+    const float panel_y = 300.f;
+    const float size = 320.f;
+    const float cw = size / (float)r->nx;
+    const float ch = size / (float)r->ny;
+
+    // genome 0 is the champion
+    float maxv = 1e-6f;
+    for (int c = 0; c < r->nx * r->ny; ++c)
+        if (r->cell_mean[c] > maxv)
+            maxv = r->cell_mean[c];
+
+    sfRectangleShape* bg = sfRectangleShape_create();
+    sfRectangleShape_setSize(bg, (sfVector2f){size + 16.f, size + 48.f});
+    sfRectangleShape_setPosition(bg, (sfVector2f){panel_x - 8.f, panel_y - 8.f});
+    sfRectangleShape_setFillColor(bg, (sfColor){0x12, 0x15, 0x1A, 0xDD});
+    sfRenderWindow_drawRectangleShape(window, bg, NULL);
+
+    sfRectangleShape_setSize(bg, (sfVector2f){cw, ch});
+    for (int iy = 0; iy < r->ny; ++iy)
+    {
+        for (int ix = 0; ix < r->nx; ++ix)
+        {
+            float v = r->cell_mean[iy * r->nx + ix] / maxv;
+            sfRectangleShape_setFillColor(bg, heat_color(v));
+            // y axis grows upward
+            sfRectangleShape_setPosition(bg, (sfVector2f){panel_x + ix * cw, panel_y + (r->ny - 1 - iy) * ch});
+            sfRenderWindow_drawRectangleShape(window, bg, NULL);
+        }
+    }
+    sfRectangleShape_destroy(bg);
+
+    char buf[160];
+    snprintf(buf, sizeof(buf), "x: %s %.0f..%.0f   y: %s %.0f..%.0f\n%d rollouts in %.2fs  max mean %.2f",
+             sweep_param_name(cfg->x_param), cfg->lo[cfg->x_param], cfg->hi[cfg->x_param],
+             sweep_param_name(cfg->y_param), cfg->lo[cfg->y_param], cfg->hi[cfg->y_param],
+             r->rollouts, r->seconds, maxv);
+    sfText_setString(label, buf);
+    sfText_setPosition(label, (sfVector2f){panel_x, panel_y + size + 4.f});
+    sfRenderWindow_drawText(window, label, NULL);
+}
+
+static void dist_stop(GAContext* ga)
+{
+    if (!ga->dist)
+        return;
+    dist_close(ga->dist);
+    ga->dist = NULL;
+    printf("[DIST] OFF\n");
+    fflush(stdout);
+}
+
+static void trace_dump(void)
+{
+    trace_stop();
+    long events = trace_write("trace.json");
+    if (events < 0)
+        printf("[TRACE] cannot write trace.json\n");
+    else
+        printf("[TRACE] %ld spans -> trace.json (chrome://tracing or ui.perfetto.dev)\n", events);
+    fflush(stdout);
+}
+
+static void print_perf(const GAContext* ga)
+{
+    static const char* const stages[3] = {"EVAL", "SELECT", "MUTATE"};
+    char line[160];
+    for (int s = 0; s < 3; ++s)
+    {
+        perf_format(&ga->perf_stage[s], line, sizeof(line));
+        printf("[PERF] %-6s %s\n", stages[s], line);
+    }
+    // spread between workers: a low IPC outlier points at its chunk, not the kernel
+    float ipc_min = 0.f, ipc_max = 0.f;
+    int counted = 0;
+    for (int t = 0; t < ga->worker_count; ++t)
+    {
+        float ipc = perf_ipc(&ga->worker_stats[t].perf);
+        if (ipc <= 0.f)
+            continue;
+        ipc_min = (counted == 0 || ipc < ipc_min) ? ipc : ipc_min;
+        ipc_max = (counted == 0 || ipc > ipc_max) ? ipc : ipc_max;
+        counted++;
+    }
+    if (counted)
+        printf("[PERF] worker ipc min/max %.2f/%.2f over %d workers\n", ipc_min, ipc_max, counted);
+}
+
+static double env_bench_pass(int count, int threads, int control_period, int* used)
+{
+    EnvConfig cfg;
+    env_default_config(&cfg);
+    cfg.count = count;
+    cfg.threads = threads;
+    cfg.control_period = control_period;
+    EnvBatch* e = env_create(&cfg);
+    float* obs = malloc((size_t)count * ENV_OBS * sizeof(float));
+    float* actions = malloc((size_t)count * sizeof(float));
+    float* rewards = malloc((size_t)count * sizeof(float));
+    uint8_t* dones = malloc((size_t)count);
+    double rate = 0.0;
+    if (e && obs && actions && rewards && dones)
+    {
+        for (int i = 0; i < count; ++i)
+            actions[i] = (float)(i % 7) / 3.f - 1.f;
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        long calls = 0;
+        double elapsed = 0.0;
+        while (elapsed < 2.0)
+        {
+            env_step(e, actions, obs, rewards, dones);
+            calls++;
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            elapsed = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+        }
+        rate = (double)calls * count * control_period / elapsed;
+        *used = env_threads(e);
+    }
+    env_destroy(e);
+    free(obs);
+    free(actions);
+    free(rewards);
+    free(dones);
+    return rate;
+}
+
+static int env_bench(int count, int control_period)
+{
+    int t1 = 0, tn = 0;
+    double one = env_bench_pass(count, 1, control_period, &t1);
+    double all = env_bench_pass(count, 0, control_period, &tn);
+    if (one <= 0.0 || all <= 0.0)
+        return 0;
+    printf("[ENV] %d envs, %d physics step(s) per action: %.3g steps/s on %d thread, %.3g on %d (x%.2f)\n", count,
+           control_period, one, t1, all, tn, all / one);
+    fflush(stdout);
+    return 1;
+}
+
+// the interactive pendulum's physics, for the planner's rollouts
+static void pendulum_env_config(const Pendulum* p, float dt, EnvConfig* cfg)
+{
+    env_default_config(cfg);
+    cfg->dt = dt;
+    cfg->track_width = p->track_width;
+    cfg->length = p->length;
+    cfg->gravity = p->gravity;
+    cfg->damping = p->damping_ps;
+    cfg->base_k = p->base_k;
+    cfg->base_d = p->base_d;
+    cfg->max_speed_factor = p->max_speed_factor;
+    cfg->max_base_speed = p->max_base_speed;
+}
+
+static void print_hold(GAContext* ga, float dt)
+{
+    GAHoldReport hr;
+    ga_hold_report(ga, dt, &hr);
+    printf("[HOLD] %d genomes x %d steps, trained with the network queried every %d step(s)\n", hr.genomes, hr.steps,
+           hr.trained_period);
+    printf("[HOLD] %2s %10s %7s %9s %9s %9s\n", "N", "steps/s", "speedup", "mean", "best", "drift");
+    for (int k = 0; k < GA_HOLD_MAX; ++k)
+        printf("[HOLD] %2d %10.3g %6.2fx %9.3f %9.3f %9.3f\n", k + 1, hr.steps_per_sec[k],
+               hr.steps_per_sec[0] > 0.f ? hr.steps_per_sec[k] / hr.steps_per_sec[0] : 0.f, hr.mean_fitness[k],
+               hr.best_fitness[k], hr.mean_abs_drift[k]);
+    fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+    // worker process for distributed evaluation: no window, no local GA
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (strcmp(argv[i], "--worker") == 0)
+            return dist_worker_main(argv[i + 1]) ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
 
+    const sfVideoMode mode = {1400, 1050, 32};
     Pendulum pendulum;
     if (!pendulum_init(&pendulum, mode.size))
-    {
-        sfRenderWindow_destroy(window);
         return EXIT_FAILURE;
-    }
 
     GAContext ga;
     ga_init(&ga, 1000);
@@ -157,6 +393,328 @@ int main(void)
                pendulum.max_speed_factor,
                pendulum.max_base_speed,
                -0.98f);
+    const char* dist_addr = NULL;
+    int dist_bench_workers = 0;
+    int check_mode = 0;
+    CheckConfig check_cfg;
+    check_default_config(&ga, &check_cfg);
+    const char* ooc_path = NULL;
+    unsigned long long ooc_count = 0;
+    int ooc_generations = 10;
+    int ooc_tile = OOC_TILE_DEFAULT;
+    int hold_generations = -1;
+    int env_bench_count = 0;
+    int chain_bench_links = 0;
+    float novelty_weight = 0.f;
+    int novelty_k = NOVELTY_K;
+    int chain_bench_envs = 4096;
+    int sparse_generations = 0;
+    MppiConfig mppi_cfg;
+    mppi_default_config(&mppi_cfg);
+    float mppi_bench_seconds = 0.f;
+    int bench_mode = 0;
+    BenchConfig bench_cfg;
+    bench_default_config(&ga, &bench_cfg);
+    int tune_mode = 0;
+    TuneConfig tune_cfg;
+    tune_default_config(&ga, &tune_cfg);
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (strcmp(argv[i], "--reward") == 0 && !ga_set_reward(&ga, argv[i + 1]))
+        {
+            fprintf(stderr, "unknown reward '%s', available:", argv[i + 1]);
+            for (int r = 0; r < GA_REWARD_COUNT; ++r)
+                fprintf(stderr, " %s", reward_name(r));
+            fprintf(stderr, "\n");
+        }
+        if (strcmp(argv[i], "--dist") == 0)
+            dist_addr = argv[i + 1];
+        if (strcmp(argv[i], "--dist-bench") == 0)
+            dist_bench_workers = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--check-seed") == 0)
+            check_cfg.seed = (unsigned)strtoul(argv[i + 1], NULL, 10);
+        if (strcmp(argv[i], "--check-steps") == 0)
+            check_cfg.steps = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--check-ulp") == 0)
+            check_cfg.ulp = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--check-rel") == 0)
+            check_cfg.rel = strtof(argv[i + 1], NULL);
+        if (strcmp(argv[i], "--tune") == 0)
+        {
+            tune_mode = 1;
+            if (!tune_parse_grid(&tune_cfg, argv[i + 1]))
+            {
+                fprintf(stderr, "bad grid '%s', expected name=v1,v2;... with names:", argv[i + 1]);
+                for (int p = 0; p < TUNE_PARAM_COUNT; ++p)
+                    fprintf(stderr, " %s", tune_param_name(p));
+                fprintf(stderr, "\n");
+                return EXIT_FAILURE;
+            }
+        }
+        if (strcmp(argv[i], "--ooc") == 0 && i + 2 < argc)
+        {
+            ooc_path = argv[i + 1];
+            ooc_count = strtoull(argv[i + 2], NULL, 10);
+        }
+        if (strcmp(argv[i], "--ooc-gens") == 0)
+            ooc_generations = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--ooc-tile") == 0)
+            ooc_tile = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--tune-target") == 0)
+            tune_cfg.target = strtof(argv[i + 1], NULL);
+        if (strcmp(argv[i], "--tune-gens") == 0)
+            tune_cfg.max_generations = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--tune-pop") == 0)
+            tune_cfg.population = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--tune-threads") == 0)
+            tune_cfg.threads = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--bench") == 0)
+        {
+            bench_mode = 1;
+            bench_cfg.seeds = atoi(argv[i + 1]);
+        }
+        if (strcmp(argv[i], "--bench-seed") == 0)
+            bench_cfg.first_seed = (unsigned)strtoul(argv[i + 1], NULL, 10);
+        if (strcmp(argv[i], "--bench-target") == 0)
+            bench_cfg.target = strtof(argv[i + 1], NULL);
+        if (strcmp(argv[i], "--bench-gens") == 0)
+            bench_cfg.max_generations = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--bench-pop") == 0)
+            bench_cfg.population = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--mpc") == 0 && i + 2 < argc)
+        {
+            mppi_cfg.samples = atoi(argv[i + 1]);
+            mppi_cfg.horizon = atoi(argv[i + 2]);
+        }
+        if (strcmp(argv[i], "--mpc-bench") == 0)
+            mppi_bench_seconds = strtof(argv[i + 1], NULL);
+        if (strcmp(argv[i], "--env-bench") == 0)
+            env_bench_count = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--chain-bench") == 0)
+            chain_bench_links = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--chain-envs") == 0)
+            chain_bench_envs = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--sparse") == 0)
+            sparse_generations = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--novelty") == 0)
+            novelty_weight = strtof(argv[i + 1], NULL);
+        if (strcmp(argv[i], "--novelty-k") == 0)
+            novelty_k = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--refine") == 0)
+            ga.refine_elites = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--refine-iters") == 0)
+            ga.refine_iterations = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--refine-step") == 0)
+            ga.refine_step = strtof(argv[i + 1], NULL);
+        if (strcmp(argv[i], "--control-period") == 0)
+        {
+            ga_set_control_period(&ga, atoi(argv[i + 1]));
+            pendulum_set_control_period(&pendulum, ga.control_period);
+        }
+        if (strcmp(argv[i], "--huge-pages") == 0)
+        {
+            int want = strcmp(argv[i + 1], "hugetlb") == 0 ? ARENA_PAGES_HUGETLB
+                     : strcmp(argv[i + 1], "thp") == 0     ? ARENA_PAGES_THP
+                                                           : ARENA_PAGES_NORMAL;
+            int got = ga_set_huge_pages(&ga, want);
+            printf("[POP] arena %s pages (asked %s)\n", arena_pages_name(got), arena_pages_name(want));
+        }
+    }
+    if (novelty_weight > 0.f)
+        ga_set_novelty(&ga, novelty_weight, novelty_k);
+    trace_bind(TRACE_TRACK_MAIN, "main");
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--perf") == 0 && !ga_set_perf_counters(&ga, 1))
+            printf("[PERF] hardware counters unavailable\n");
+        if (strcmp(argv[i], "--trace") == 0)
+            trace_start();
+        if (strcmp(argv[i], "--check") == 0)
+        {
+            check_mode = 1;
+            if (i + 1 < argc && atoi(argv[i + 1]) > 0)
+                check_cfg.cases = atoi(argv[i + 1]);
+        }
+        if (strcmp(argv[i], "--hold-report") == 0)
+            hold_generations = (i + 1 < argc && atoi(argv[i + 1]) > 0) ? atoi(argv[i + 1]) : 20;
+    }
+    if (check_mode)
+    {
+        // headless: optimized kernels against the scalar reference, non-zero exit on divergence
+        CheckReport check_report;
+        int ok = check_run(&ga, &check_cfg, &check_report);
+        check_print(&check_cfg, &check_report);
+        ga_free(&ga);
+        pendulum_destroy(&pendulum);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (ooc_path)
+    {
+        // headless: population in a memory-mapped file, evaluated in streaming tiles
+        OocPopulation ooc;
+        if (!ooc_open(&ooc, ooc_path, ooc_count, ooc_tile))
+        {
+            fprintf(stderr, "cannot open or create %s for %llu genomes\n", ooc_path, ooc_count);
+            ga_free(&ga);
+            pendulum_destroy(&pendulum);
+            return EXIT_FAILURE;
+        }
+        printf("[OOC] %s: %llu genomes, %.1f MB, %s at generation %u, tiles of %d\n", ooc_path, ooc_count,
+               (double)ooc.map_bytes / (1024.0 * 1024.0), ooc.created ? "created" : "resumed", ooc.header->generation,
+               ooc.tile);
+        int ok = 1;
+        for (int g = 0; g < ooc_generations && ok; ++g)
+        {
+            ok = ooc_generation(&ooc, &ga, 1.f / 120.f);
+            if (ok)
+                printf("[OOC] gen %u: %llu evaluated in %.2fs (%.0f/s, %.0f MB/s), elite >= %.3f (%llu kept), "
+                       "best %.3f; parents %d in %.2fs, breed %.2fs; peak RSS %.1f MB\n",
+                       ooc.header->generation, (unsigned long long)ooc.evaluated, ooc.eval_seconds,
+                       ooc.eval_seconds > 0.0 ? (double)ooc.evaluated / ooc.eval_seconds : 0.0,
+                       ooc.eval_seconds > 0.0 ? (double)ooc.map_bytes / (1024.0 * 1024.0) / ooc.eval_seconds : 0.0,
+                       ooc.header->threshold, (unsigned long long)ooc.elites, ooc.header->best, ooc.parents,
+                       ooc.parents_seconds, ooc.breed_seconds, (double)ooc.peak_rss_kb / 1024.0);
+            fflush(stdout);
+        }
+        ooc_close(&ooc);
+        ga_free(&ga);
+        pendulum_destroy(&pendulum);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (tune_mode)
+    {
+        // headless: every point of the grid is its own GA, all trained at once on one worker pool
+        TuneResult tune_result;
+        int ok = tune_run(&ga, &tune_cfg, &tune_result);
+        if (ok)
+        {
+            tune_print(&tune_cfg, &tune_result);
+            if (tune_write_csv(&tune_result, &tune_cfg, "tune.csv"))
+                printf("[TUNE] wrote tune.csv\n");
+        }
+        tune_free(&tune_result);
+        ga_free(&ga);
+        pendulum_destroy(&pendulum);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (bench_mode)
+    {
+        // headless: the same configuration from M seeds, time/generations/steps to reach the target
+        BenchResult bench_result;
+        int ok = bench_run(&ga, &bench_cfg, &bench_result);
+        if (ok)
+        {
+            bench_print(&bench_cfg, &bench_result);
+            if (bench_write_csv(&bench_result, &bench_cfg, "bench.csv"))
+                printf("[BENCH] wrote bench.csv\n");
+        }
+        bench_free(&bench_result);
+        ga_free(&ga);
+        pendulum_destroy(&pendulum);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (mppi_bench_seconds > 0.f)
+    {
+        // headless: the planner in closed loop on a simulated pendulum, against the 120 Hz tick budget
+        EnvConfig env_cfg;
+        pendulum_env_config(&pendulum, 1.f / MPPI_RATE_HZ, &env_cfg);
+        MppiBench mb;
+        int ok = mppi_bench(&mppi_cfg, &env_cfg, mppi_bench_seconds, &mb);
+        if (ok)
+            printf("[MPC] %d samples x %d actions x %d steps, %d thread(s): plan ms p50/p99/max %.2f / %.2f / %.2f "
+                   "(budget %.2f, %d/%d over); swing-up %.2fs, upright %.0f%% of the second half\n",
+                   mppi_cfg.samples, mppi_cfg.horizon, mppi_cfg.hold, mb.threads, mb.plan_p50_ms, mb.plan_p99_ms,
+                   mb.plan_max_ms, mb.budget_ms, mb.over_budget, mb.ticks, mb.swing_up_seconds,
+                   100.f * mb.upright_share);
+        ga_free(&ga);
+        pendulum_destroy(&pendulum);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (env_bench_count > 0)
+    {
+        // headless: steps/s of the batched environment library, one thread then all of them
+        int ok = env_bench(env_bench_count, ga.control_period);
+        ga_free(&ga);
+        pendulum_destroy(&pendulum);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (chain_bench_links > 0)
+    {
+        // headless: cost per step of the N-link engine for 1..N links
+        int links = chain_bench_links < CHAIN_MAX_LINKS ? chain_bench_links : CHAIN_MAX_LINKS;
+        ChainBench cb[CHAIN_MAX_LINKS];
+        int ok = chain_bench(&ga, links, chain_bench_envs, 600, cb);
+        if (ok)
+        {
+            printf("[CHAIN] %d envs x 600 steps, ns per step against link count\n", chain_bench_envs);
+            printf("[CHAIN] %5s %6s %10s %8s %9s %12s %9s\n", "links", "inputs", "steps/s", "ns/env", "ns/link",
+                   "energy drift", "best");
+            for (int k = 0; k < links; ++k)
+                printf("[CHAIN] %5d %6d %10.3g %8.1f %9.1f %12.2e %9.3f\n", cb[k].links, cb[k].inputs,
+                       cb[k].env_steps_per_sec, cb[k].ns_per_env_step, cb[k].ns_per_link_step, cb[k].energy_drift,
+                       cb[k].best_fitness);
+            fflush(stdout);
+        }
+        ga_free(&ga);
+        pendulum_destroy(&pendulum);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (sparse_generations > 0)
+    {
+        // headless: generations of sparse genomes compiled to evaluation programs
+        SparsePopulation* sp = sparse_population_create(&ga, ga.population_size, (unsigned)time(NULL));
+        if (sp)
+        {
+            for (int g = 0; g < sparse_generations; ++g)
+            {
+                SparseStats st;
+                sparse_population_step(sp, 1.f / 120.f, &st);
+                printf("[SPARSE] gen %d best=%.2f champion=%.2f live=%.1f conns=%.1f %.0f ns/step (%.0f ms)\n",
+                       st.generation, st.best_fitness, st.champion_fitness, st.mean_live, st.mean_conns,
+                       st.ns_per_step, st.eval_ms);
+                fflush(stdout);
+            }
+            sparse_population_free(sp);
+        }
+        ga_free(&ga);
+        pendulum_destroy(&pendulum);
+        return sp ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (hold_generations >= 0)
+    {
+        // headless: train at the configured period, then replay the population at every period
+        ga_start(&ga);
+        for (int g = 0; g < hold_generations; ++g)
+            ga_run_generation(&ga, 1.f / 120.f);
+        print_hold(&ga, 1.f / 120.f);
+        ga_free(&ga);
+        pendulum_destroy(&pendulum);
+        return EXIT_SUCCESS;
+    }
+    if (dist_bench_workers > 0)
+    {
+        // headless: evals/s of the distributed path for 1..N local workers
+        ga_start(&ga);
+        int ok = dist_bench(argv[0], &ga, 1.f / 120.f, dist_bench_workers, 5);
+        ga_free(&ga);
+        pendulum_destroy(&pendulum);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    sfRenderWindow* window =
+        sfRenderWindow_create(mode, "CSFML Pendulum", sfResize | sfClose, sfWindowed, NULL);
+    if (!window)
+    {
+        ga_free(&ga);
+        pendulum_destroy(&pendulum);
+        return EXIT_FAILURE;
+    }
+
+    const float fixed_step = 1.f / 120.f;
+    ChampionControl control;
+    control_init(&control, &pendulum, fixed_step);
+    Mppi planner;
+    memset(&planner, 0, sizeof(planner));
 
     sfFont* font = sfFont_createFromFile("tuffy.ttf");
     sfText* info_text = sfText_create(font);
@@ -247,21 +805,327 @@ int main(void)
     int history_cap = 0;
     int last_gen = -1;
     bool fast_mode = false;
-    const float fixed_step = 1.f / 120.f;
     float display_accum = 0.f;
+    SweepConfig sweep_cfg;
+    SweepResult sweep_res = {0};
+    bool heatmap_visible = false;
+    const char* traj_path = "run.ptrj";
+    TrajRecorder* recorder = NULL;
+    TrajFile* replay_file = NULL;
+    TrajTrack replay_track = {0};
+    int replay_index = 0;
+    uint32_t replay_step = 0;
+    float replay_time = 0.f;
+    float replay_speed = 1.f;
+    bool replay_paused = false;
+    TrajFrame replay_frame = {0};
+    GASteadyStats steady_stats = {0};
+    float steady_print_accum = 0.f;
     while (running && sfRenderWindow_isOpen(window))
     {
+        unsigned long long frame_trace = trace_begin();
         while (sfRenderWindow_pollEvent(window, &event))
         {
             if (event.type == sfEvtClosed)
                 running = false;
             if (event.type == sfEvtKeyPressed && event.key.code == sfKeyF)
             {
+                ga_steady_stop(&ga);
+                dist_stop(&ga);
                 fast_mode = !fast_mode;
                 if (ga.running && !fast_mode)
                     ga_reset_agents(&ga);
                 display_accum = 0.f;
             }
+            if (event.type == sfEvtKeyPressed && event.key.code == sfKeyP)
+            {
+                ga_set_thread_pinning(&ga, !ga.pin_threads);
+                printf("[PIN] worker core pinning %s\n", ga.pin_threads ? "ON" : "OFF");
+                fflush(stdout);
+            }
+            if (event.type == sfEvtKeyPressed && event.key.code == sfKeyH)
+            {
+                // robustness sweep of the champion (+ current elites) over length x gravity
+                if (heatmap_visible)
+                {
+                    heatmap_visible = false;
+                }
+                else if (ga.has_champion)
+                {
+                    ga_steady_stop(&ga);
+                    Genome sweep_genomes[5];
+                    int sweep_count = 0;
+                    sweep_genomes[sweep_count++] = ga.champion;
+                    for (int i = 0; i < 4 && i < ga.population_size && ga.generation > 0; ++i)
+                        sweep_genomes[sweep_count++] = ga.population[i];
+                    sweep_free(&sweep_res);
+                    sweep_default_config(&ga, &sweep_cfg);
+                    if (sweep_run(&ga, sweep_genomes, sweep_count, &sweep_cfg, &sweep_res))
+                    {
+                        sweep_write_map(&sweep_res, &sweep_cfg, "robustness_map.csv");
+                        printf("[SWEEP] %d genomes, %d rollouts in %.2fs -> robustness_map.csv\n",
+                               sweep_res.genome_count, sweep_res.rollouts, sweep_res.seconds);
+                        fflush(stdout);
+                        heatmap_visible = true;
+                    }
+                }
+            }
+            if (event.type == sfEvtKeyPressed && event.key.code == sfKeyR && ga.running)
+            {
+                // record every 50th agent (+ each new champion) of each generation
+                if (recorder)
+                {
+                    ga.recorder = NULL;
+                    printf("[REC] stop: %d generations written, %d dropped%s\n", recorder->generations_written,
+                           recorder->generations_dropped, recorder->failed ? ", write error" : "");
+                    traj_recorder_close(recorder);
+                    recorder = NULL;
+                }
+                else
+                {
+                    recorder = traj_recorder_open(traj_path, &ga, fixed_step, 50);
+                    ga.recorder = recorder;
+                    printf("[REC] %s -> %s\n", recorder ? "start" : "failed", traj_path);
+                }
+                fflush(stdout);
+            }
+            if (event.type == sfEvtKeyPressed && event.key.code == sfKeyL && !ga.running)
+            {
+                if (replay_file)
+                {
+                    traj_free_track(&replay_track);
+                    traj_close(replay_file);
+                    replay_file = NULL;
+                }
+                else
+                {
+                    replay_file = traj_open(traj_path);
+                    replay_index = replay_file ? (int)replay_file->track_count - 1 : 0;
+                    if (replay_file && !replay_load(replay_file, &replay_track, replay_index))
+                    {
+                        traj_close(replay_file);
+                        replay_file = NULL;
+                    }
+                    replay_time = 0.f;
+                    replay_speed = 1.f;
+                    replay_paused = false;
+                }
+            }
+            if (event.type == sfEvtKeyPressed && replay_file && !ga.running)
+            {
+                // scrub / speed / track selection
+                if (event.key.code == sfKeyRight)
+                    replay_time += 1.f;
+                if (event.key.code == sfKeyLeft)
+                    replay_time = replay_time > 1.f ? replay_time - 1.f : 0.f;
+                if (event.key.code == sfKeyUp && replay_speed < 64.f)
+                    replay_speed *= 2.f;
+                if (event.key.code == sfKeyDown && replay_speed > 0.125f)
+                    replay_speed *= 0.5f;
+                if (event.key.code == sfKeySpace)
+                    replay_paused = !replay_paused;
+                if (event.key.code == sfKeyN || event.key.code == sfKeyB)
+                {
+                    replay_index += (event.key.code == sfKeyN) ? 1 : -1;
+                    replay_index = ((replay_index % (int)replay_file->track_count) + (int)replay_file->track_count)
+                                   % (int)replay_file->track_count;
+                    replay_load(replay_file, &replay_track, replay_index);
+                    replay_time = 0.f;
+                }
+            }
+            if (event.type == sfEvtKeyPressed && event.key.code == sfKeyA && ga.running && fast_mode)
+            {
+                // steady-state GA: workers breed/evaluate/replace continuously, no generation barrier
+                if (ga.steady)
+                    ga_steady_stop(&ga);
+                else
+                {
+                    dist_stop(&ga);
+                    ga_steady_start(&ga, fixed_step);
+                }
+                steady_stats = (GASteadyStats){0};
+                steady_print_accum = 0.f;
+                printf("[STEADY] %s\n", ga.steady ? "ON" : "OFF");
+                fflush(stdout);
+            }
+            if (event.type == sfEvtKeyPressed && event.key.code == sfKeyD && ga.running && fast_mode)
+            {
+                // distributed evaluation: local worker processes, or remote ones connecting to --dist ADDR
+                if (ga.dist)
+                {
+                    dist_stop(&ga);
+                }
+                else
+                {
+                    ga_steady_stop(&ga);
+                    ga.dist = dist_open(dist_addr);
+                    if (ga.dist && !dist_addr)
+                    {
+                        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+                        int n = dist_spawn_local(ga.dist, argv[0], cpus > 0 ? (int)cpus : 1);
+                        dist_wait_workers(ga.dist, n, 2.0);
+                    }
+                    if (ga.dist)
+                        printf("[DIST] ON %s, %d workers\n", ga.dist->addr, dist_alive_workers(ga.dist));
+                    else
+                        printf("[DIST] cannot listen on %s\n", dist_addr ? dist_addr : "a local socket");
+                    fflush(stdout);
+                }
+            }
+            if (event.type == sfEvtKeyPressed && event.key.code == sfKeyG && !ga.running)
+            {
+                ga_set_reward(&ga, reward_name((ga.reward + 1) % GA_REWARD_COUNT));
+                printf("[REWARD] %s\n", reward_name(ga.reward));
+                fflush(stdout);
+            }
+            if (event.type == sfEvtKeyPressed && event.key.code == sfKeyK)
+            {
+                // hardware counters per GA stage and worker chunk (FAST generations)
+                int was_on = ga.perf_counters;
+                unsigned valid = ga_set_perf_counters(&ga, !was_on);
+                if (ga.perf_counters)
+                {
+                    printf("[PERF] ON:");
+                    for (int i = 0; i < PERF_COUNTERS; ++i)
+                        printf(" %s%s", perf_counter_name(i), (valid & (1u << i)) ? "" : "(n/a)");
+                    printf("\n");
+                }
+                else
+                {
+                    printf("[PERF] %s\n", was_on ? "OFF" : "counters unavailable");
+                }
+                fflush(stdout);
+            }
+            if (event.type == sfEvtKeyPressed
+                && (event.key.code == sfKeyEqual || event.key.code == sfKeyAdd
+                    || event.key.code == sfKeyHyphen || event.key.code == sfKeySubtract))
+            {
+                // double / halve the population between generations
+                int grow = event.key.code == sfKeyEqual || event.key.code == sfKeyAdd;
+                int current = ga.pending_size ? ga.pending_size : ga.population_size;
+                int size = grow ? current * 2 : current / 2;
+                int was_steady = ga.steady != NULL;
+                int resized = size <= 256000 && ga_resize_population(&ga, size);
+                if (was_steady)
+                    ga_steady_start(&ga, fixed_step);
+                if (resized && ga.pending_size)
+                    printf("[POP] size -> %d from the next generation\n", ga.pending_size);
+                else if (resized)
+                    printf("[POP] size -> %d (arena %.1f MB, capacity %d, %s pages)\n", ga.population_size,
+                           (double)ga.arena.size / (1024.0 * 1024.0), ga.capacity, arena_pages_name(ga.arena.pages));
+                else
+                    printf("[POP] size %d unchanged\n", current);
+                fflush(stdout);
+            }
+            if (event.type == sfEvtKeyPressed && event.key.code == sfKeyT)
+            {
+                // timeline of frames, GA stages and worker chunks
+                if (atomic_load(&trace_enabled))
+                {
+                    trace_dump();
+                }
+                else
+                {
+                    trace_start();
+                    printf("[TRACE] ON\n");
+                    fflush(stdout);
+                }
+            }
+            if (event.type == sfEvtKeyPressed && event.key.code == sfKeyZ)
+            {
+                // network queried every 1/2/4/8 physics steps, in training and on the interactive pendulum
+                int current = ga.pending_period ? ga.pending_period : ga.control_period;
+                int period = current >= GA_HOLD_MAX ? 1 : current * 2;
+                int was_steady = ga.steady != NULL;
+                ga_set_control_period(&ga, period);
+                control_lock(&control);
+                pendulum_set_control_period(&pendulum, period);
+                control_unlock(&control);
+                printf("[HOLD] control period %d step(s), %.0f Hz%s\n", period, 1.f / (fixed_step * (float)period),
+                       ga.pending_period ? ", training from the next generation" : "");
+                if (ga.running)
+                    print_hold(&ga, fixed_step);
+                if (was_steady)
+                    ga_steady_start(&ga, fixed_step);
+            }
+            if (event.type == sfEvtKeyPressed && event.key.code == sfKeyW)
+                ga.scheduler = (ga.scheduler == GA_SCHED_STEAL) ? GA_SCHED_STATIC : GA_SCHED_STEAL;
+            if (event.type == sfEvtKeyPressed && event.key.code == sfKeyQ)
+            {
+                // cycle F32 -> INT8 -> FP16 -> BF16; report drift/throughput against float on the current population
+                ga_steady_stop(&ga);
+                int mode = (ga.eval_mode + 1) % 4;
+                ga_set_eval_mode(&ga, mode);
+                if (mode == GA_EVAL_INT8)
+                {
+                    GAQuantReport qr;
+                    ga_quant_report(&ga, fixed_step, &qr);
+                    printf("[QUANT] %d genomes x %d steps: drift mean=%.3f max=%.3f best f32=%.2f i8=%.2f same=%d\n"
+                           "[QUANT] rollout steps/s f32=%.3g i8=%.3g (x%.2f)  net evals/s f32=%.3g i8=%.3g (x%.2f)\n",
+                           qr.genomes, qr.steps, qr.mean_abs_drift, qr.max_abs_drift,
+                           qr.best_float, qr.best_int8, qr.same_best,
+                           qr.float_steps_per_sec, qr.int8_steps_per_sec,
+                           qr.int8_steps_per_sec / qr.float_steps_per_sec,
+                           qr.float_net_per_sec, qr.int8_net_per_sec,
+                           qr.int8_net_per_sec / qr.float_net_per_sec);
+                    fflush(stdout);
+                }
+                if (mode == GA_EVAL_FP16 || mode == GA_EVAL_BF16)
+                {
+                    // population tiled to 1M genomes so the float layout no longer fits in cache
+                    GAHalfReport hr;
+                    ga_half_report(&ga, fixed_step, 1 << 20, mode == GA_EVAL_BF16 ? HALF_BF16 : HALF_FP16, &hr);
+                    printf("[HALF] %s %d genomes (hidden avg %.1f) x %d steps, %d threads\n"
+                           "[HALF] memory f32=%.1f MB half=%.1f MB (x%.2f)  steps/s f32=%.3g half=%.3g (x%.2f)  theta drift max=%.2g\n",
+                           mode == GA_EVAL_BF16 ? "bf16" : "fp16", hr.genomes, hr.mean_hidden, hr.steps, hr.threads,
+                           (double)hr.float_bytes / 1e6, (double)hr.half_bytes / 1e6,
+                           (double)hr.float_bytes / (double)(hr.half_bytes ? hr.half_bytes : 1),
+                           hr.float_steps_per_sec, hr.half_steps_per_sec,
+                           hr.half_steps_per_sec / hr.float_steps_per_sec, hr.max_theta_drift);
+                    fflush(stdout);
+                }
+            }
+            if (event.type == sfEvtKeyPressed && event.key.code == sfKeyC && !ga.running)
+            {
+                // champion drives the interactive pendulum from the control thread
+                if (control.active)
+                {
+                    control_stop(&control);
+                }
+                else if (ga.has_champion)
+                {
+                    control_lock(&control);
+                    pendulum_reset(&pendulum);
+                    control_unlock(&control);
+                    control_start(&control, &ga.champion);
+                }
+            }
+            if (event.type == sfEvtKeyPressed && event.key.code == sfKeyM && !ga.running)
+            {
+                // sampling MPC drives the interactive pendulum from the same control thread
+                if (control.active)
+                {
+                    control_stop(&control);
+                }
+                else
+                {
+                    if (!planner.env)
+                    {
+                        EnvConfig env_cfg;
+                        pendulum_env_config(&pendulum, fixed_step, &env_cfg);
+                        if (!mppi_init(&planner, &mppi_cfg, &env_cfg))
+                            printf("[MPC] cannot allocate %d samples x %d actions\n", mppi_cfg.samples,
+                                   mppi_cfg.horizon);
+                    }
+                    if (planner.env)
+                    {
+                        control_lock(&control);
+                        pendulum_reset(&pendulum);
+                        control_unlock(&control);
+                        control_start_planner(&control, &planner);
+                    }
+                }
+            }
             if (event.type == sfEvtMouseButtonPressed && event.mouseButton.button == sfMouseLeft)
             {
                 sfVector2i mp = event.mouseButton.position;
@@ -271,6 +1135,13 @@ int main(void)
                 {
                     if (!ga.running)
                     {
+                        control_stop(&control);
+                        if (replay_file)
+                        {
+                            traj_free_track(&replay_track);
+                            traj_close(replay_file);
+                            replay_file = NULL;
+                        }
                         ga_start(&ga);
                         pendulum_set_external_control(&pendulum, 1);
                         pendulum_reset(&pendulum);
@@ -281,6 +1152,14 @@ int main(void)
                     else
                     {
                         ga.running = 0;
+                        ga_steady_stop(&ga);
+                        dist_stop(&ga);
+                        if (recorder)
+                        {
+                            ga.recorder = NULL;
+                            traj_recorder_close(recorder);
+                            recorder = NULL;
+                        }
                         pendulum_set_external_control(&pendulum, 0);
                         pendulum_set_base_velocity(&pendulum, 0.f);
                         pendulum_reset(&pendulum);
@@ -288,13 +1167,30 @@ int main(void)
                 }
             }
             if (!ga.running)
+            {
+                control_lock(&control);
                 pendulum_handle_event(&pendulum, &event);
+                control_unlock(&control);
+            }
         }
 
         float dt = sfTime_asSeconds(sfClock_restart(clock));
         if (ga.running)
         {
-            if (fast_mode)
+            if (fast_mode && ga.steady)
+            {
+                ga_steady_poll(&ga, &steady_stats);
+                steady_print_accum += dt;
+                if (steady_print_accum >= 1.f)
+                {
+                    printf("[STEADY] evals=%llu (%.0f/s) replaced=%llu best=%.2f worst=%.2f lock wait %.2f%%\n",
+                           steady_stats.evals, steady_stats.evals_per_sec, steady_stats.inserts,
+                           steady_stats.best, steady_stats.worst, steady_stats.lock_wait_pct);
+                    fflush(stdout);
+                    steady_print_accum = 0.f;
+                }
+            }
+            else if (fast_mode)
                 ga_run_generation(&ga, fixed_step);
             else
             {
@@ -315,17 +1211,41 @@ int main(void)
                 }
                 if (history)
                     history[history_count++] = ga.gen_best_fitness;
-                if (fast_mode)
+                if (fast_mode && !ga.steady)
                 {
+                    unsigned long long log_trace = trace_begin();
                     printf("[FAST] Gen %d best=%.2f overall=%.2f\n",
                            ga.generation,
                            ga.gen_best_fitness,
                            ga.best_fitness);
+                    if (ga.perf_counters)
+                        print_perf(&ga);
+                    if (ga.novelty && ga.novelty_weight > 0.f)
+                        printf("[NOVELTY] archive %zu, mean novelty %.3f, kNN %.1f ms, %d rebuilds (last %.1f ms)\n",
+                               ga.novelty->count, ga.novelty->mean_novelty, ga.novelty->score_ms,
+                               ga.novelty->rebuilds, ga.novelty->build_ms);
+                    if (ga.refine_elites > 0)
+                        printf("[GRAD] %d/%d elites improved, best gain %.3f, %.1f ms\n", ga.refine_improved,
+                               ga.refine_elites, ga.refine_gain, ga.refine_ms);
+                    if (ga.dist)
+                        printf("[DIST] %d workers, %.0f evals/s, redispatched=%d local=%d lost=%d\n",
+                               ga.dist->last_workers, ga.dist->last_evals_per_sec, ga.dist->last_redispatched,
+                               ga.dist->last_local, ga.dist->lost_workers);
                     fflush(stdout);
+                    trace_end(log_trace, "log", -1);
                 }
             }
         }
-        else
+        else if (replay_file)
+        {
+            if (!replay_paused)
+                replay_time += dt * replay_speed;
+            float length_s = (float)replay_track.info.frames * replay_file->dt;
+            if (replay_time >= length_s)
+                replay_time = 0.f;
+            replay_step = (uint32_t)(replay_time / replay_file->dt);
+        }
+        else if (!control.active) // otherwise the control thread steps it, one fixed step per tick
         {
             pendulum_set_base_velocity(&pendulum, 0.f);
             pendulum_update(&pendulum, dt);
@@ -343,28 +1263,37 @@ int main(void)
             const GAAgent* a = ga_get_display_agent(&ga);
             if (a)
             {
-                sfColor col = (sfColor){0xF4, 0xEE, 0x2A, 0xFF};
-                sfRectangleShape_setFillColor(agent_rod, col);
-                sfCircleShape_setFillColor(agent_bob, col);
-
-                float dx = a->bob_x - a->pivot_x;
-                float dy = a->bob_y - pendulum.pivot.y;
-                float len = sqrtf(dx * dx + dy * dy);
-                float angle = atan2f(dy, dx) * 180.f / (float)M_PI;
-                sfRectangleShape_setSize(agent_rod, (sfVector2f){len, 2.f});
-                sfRectangleShape_setPosition(agent_rod, (sfVector2f){a->pivot_x, pendulum.pivot.y});
-                sfRectangleShape_setRotation(agent_rod, angle);
-                sfCircleShape_setPosition(agent_bob, (sfVector2f){a->bob_x, a->bob_y});
-
-                sfRenderWindow_drawRectangleShape(window, agent_rod, NULL);
-                sfRenderWindow_drawCircleShape(window, agent_bob, NULL);
+                draw_swing(window, agent_rod, agent_bob,
+                           (sfVector2f){a->pivot_x, pendulum.pivot.y},
+                           (sfVector2f){a->bob_x, a->bob_y},
+                           (sfColor){0xF4, 0xEE, 0x2A, 0xFF});
             }
 
             draw_network(window, &ga, mode.size);
         }
+        else if (!ga.running && replay_file)
+        {
+            // recorded trajectory, decoded from the file only
+            sfRenderWindow_drawConvexShape(window, pendulum.base_rect, NULL);
+            sfRenderWindow_drawRectangleShape(window, pendulum.slider_track, NULL);
+            sfRenderWindow_drawRectangleShape(window, threshold_line, NULL);
+            TrajFrame fr;
+            if (traj_seek(replay_file, &replay_track, replay_step, &fr))
+            {
+                sfVector2f pivot = {fr.pivot_x, replay_file->pivot_y};
+                sfVector2f bob_pos = {fr.pivot_x + replay_file->length * sinf(fr.theta),
+                                      replay_file->pivot_y + replay_file->length * cosf(fr.theta)};
+                sfColor col = (replay_track.info.agent == TRAJ_CHAMPION) ? (sfColor){0xF4, 0xEE, 0x2A, 0xFF}
+                                                                         : (sfColor){0x8F, 0xD7, 0xFF, 0xFF};
+                draw_swing(window, agent_rod, agent_bob, pivot, bob_pos, col);
+                replay_frame = fr;
+            }
+        }
         else if (!ga.running)
         {
+            control_lock(&control);
             pendulum_draw(&pendulum, window);
+            control_unlock(&control);
         }
         else
         {
@@ -412,40 +1341,52 @@ int main(void)
         sfText_setString(button_text, ga.running ? "Stop GA" : "Start GA");
         sfVector2f bp = sfRectangleShape_getPosition(button);
         sfText_setPosition(button_text, (sfVector2f){bp.x + 18.f, bp.y + 8.f});
-        char info[256];
+        char info[1024];
         char time_left[32];
         if (!fast_mode)
             snprintf(time_left, sizeof(time_left), "%.1fs", ga.eval_duration - ga.eval_time);
         else
             snprintf(time_left, sizeof(time_left), "--");
-        const char* stage =
+        const char* stage = ga.steady ? "STEADY" :
             (ga.stage == GA_STAGE_EVAL) ? "EVAL" : (ga.stage == GA_STAGE_SELECT) ? "SELECT" : "MUTATE";
         const GAAgent* display_agent = ga_get_display_agent(&ga);
         float champ = ga.has_champion ? ga.champion_fitness : ga.best_fitness;
         float display_score = (display_agent ? display_agent->fitness : 0.f);
         char display_buf[32];
         snprintf(display_buf, sizeof(display_buf), "%.2f", display_score);
+        float util_min = 0.f, util_avg = 0.f, wait_max = 0.f;
+        ga_get_worker_summary(&ga, &util_min, &util_avg, &wait_max);
         if (fast_mode)
         {
             snprintf(info, sizeof(info),
-                     "GA: %s  Mode: %s  %s\nGen: %d  Pop: %d\nBest ever: %.2f\nGen best: %.2f\nThr: %.2f\nTime left: %s",
+                     "GA: %s  Mode: %s  %s  %s  %s\nGen: %d  Pop: %d\nBest ever: %.2f\nGen best: %.2f\nThr: %.2f\nTime left: %s"
+                     "\nWorkers: %s x%d  util min/avg %.0f%%/%.0f%%  wait max %.1f ms",
                      ga.running ? "ON" : "OFF",
                      "FAST",
                      stage,
+                     eval_names[ga.eval_mode & 3],
+                     reward_name(ga.reward),
                      ga.generation,
                      ga.population_size,
                      champ,
                      ga.gen_best_fitness,
                      ga.upright_threshold,
-                     time_left);
+                     time_left,
+                     ga.scheduler == GA_SCHED_STEAL ? "STEAL" : "STATIC",
+                     ga.worker_count,
+                     util_min * 100.f,
+                     util_avg * 100.f,
+                     wait_max);
         }
         else
         {
             snprintf(info, sizeof(info),
-                     "GA: %s  Mode: %s  %s\nGen: %d  Pop: %d\nDisplay score: %s\nBest ever: %.2f\nThr: %.2f\nTime left: %s",
+                     "GA: %s  Mode: %s  %s  %s  %s\nGen: %d  Pop: %d\nDisplay score: %s\nBest ever: %.2f\nThr: %.2f\nTime left: %s",
                      ga.running ? "ON" : "OFF",
                      "DISPLAY",
                      stage,
+                     eval_names[ga.eval_mode & 3],
+                     reward_name(ga.reward),
                      ga.generation,
                      ga.population_size,
                      display_buf,
@@ -453,13 +1394,84 @@ int main(void)
                      ga.upright_threshold,
                      time_left);
         }
+        if (ga.steady)
+        {
+            size_t len = strlen(info);
+            snprintf(info + len, sizeof(info) - len,
+                     "\nSteady: %.0f evals/s  evals %llu  replaced %llu  worst %.2f  lock %.2f%%",
+                     steady_stats.evals_per_sec,
+                     steady_stats.evals,
+                     steady_stats.inserts,
+                     steady_stats.worst,
+                     steady_stats.lock_wait_pct);
+        }
+        if (ga.perf_counters && fast_mode && !ga.steady)
+        {
+            static const char* const stages[3] = {"Eval", "Select", "Mutate"};
+            for (int s = 0; s < 3; ++s)
+            {
+                size_t len = strlen(info);
+                int n = snprintf(info + len, sizeof(info) - len, "\n%s: ", stages[s]);
+                if (n > 0 && (size_t)n < sizeof(info) - len)
+                    perf_format(&ga.perf_stage[s], info + len + n, (int)(sizeof(info) - len - (size_t)n));
+            }
+        }
+        if (replay_file && !ga.running)
+        {
+            size_t len = strlen(info);
+            char who[24];
+            if (replay_track.info.agent == TRAJ_CHAMPION)
+                snprintf(who, sizeof(who), "champion");
+            else
+                snprintf(who, sizeof(who), "agent %d", replay_track.info.agent);
+            snprintf(info + len, sizeof(info) - len,
+                     "\nReplay %d/%u: gen %u %s  fit %.2f"
+                     "\nStep %u/%u  x%.3g%s  score %.2f  ctl %.0f",
+                     replay_index + 1, replay_file->track_count,
+                     replay_track.info.generation, who, replay_track.info.fitness,
+                     replay_step, replay_track.info.frames, replay_speed, replay_paused ? " (pause)" : "",
+                     replay_frame.fitness, replay_frame.control);
+        }
+        if (control.active)
+        {
+            ControlStats cs;
+            control_get_stats(&control, &cs);
+            size_t len = strlen(info);
+            snprintf(info + len, sizeof(info) - len,
+                     "\nControl: %s %.0f Hz  ticks %llu  overruns %llu"
+                     "\nJitter us p50/p99/max: %.1f / %.1f / %.1f"
+                     "\nInfer us p50/p99/max: %.2f / %.2f / %.2f",
+                     control.planner ? "MPPI" : "CHAMPION",
+                     cs.rate_hz,
+                     cs.ticks,
+                     cs.overruns,
+                     cs.jitter_p50_us,
+                     cs.jitter_p99_us,
+                     cs.jitter_max_us,
+                     cs.infer_p50_us,
+                     cs.infer_p99_us,
+                     cs.infer_max_us);
+        }
         sfText_setString(info_text, info);
         sfRenderWindow_drawRectangleShape(window, button, NULL);
         sfRenderWindow_drawText(window, button_text, NULL);
         sfRenderWindow_drawText(window, info_text, NULL);
+        if (heatmap_visible)
+            draw_heatmap(window, &sweep_res, &sweep_cfg, grad_text);
         sfRenderWindow_display(window);
+        trace_end(frame_trace, "frame", -1);
     }
 
+    control_destroy(&control);
+    mppi_free(&planner);
+    dist_stop(&ga);
+    if (atomic_load(&trace_enabled))
+        trace_dump();
+    ga.recorder = NULL;
+    traj_recorder_close(recorder);
+    traj_free_track(&replay_track);
+    traj_close(replay_file);
+    sweep_free(&sweep_res);
     ga_free(&ga);
     pendulum_destroy(&pendulum);
     sfClock_destroy(clock);
@@ -0,0 +1,236 @@
+#include "mppi.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+void mppi_default_config(MppiConfig* cfg)
+{
+    if (!cfg)
+        return;
+    cfg->samples = 512;
+    cfg->horizon = 60;
+    cfg->hold = 2;
+    cfg->sigma = 0.5f;
+    cfg->lambda = 0.5f;
+    cfg->w_spin = 0.05f;
+    cfg->w_center = 0.2f;
+    cfg->threads = 0;
+}
+
+static float mppi_frand(unsigned* s)
+{
+    unsigned x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return ((float)(x >> 8) + 0.5f) * (1.f / 16777216.f);
+}
+
+// Box-Muller, both outputs used
+static void gaussian_fill(unsigned* s, float* out, int n, float sigma)
+{
+    for (int i = 0; i < n; i += 2)
+    {
+        float r = sigma * sqrtf(-2.f * logf(mppi_frand(s)));
+        float a = 6.2831853f * mppi_frand(s);
+        out[i] = r * cosf(a);
+        if (i + 1 < n)
+            out[i + 1] = r * sinf(a);
+    }
+}
+
+int mppi_init(Mppi* m, const MppiConfig* cfg, const EnvConfig* env)
+{
+    if (!m)
+        return 0;
+    memset(m, 0, sizeof(*m));
+    if (!cfg || !env || cfg->samples < 2 || cfg->horizon < 1 || cfg->hold < 1 || cfg->lambda <= 0.f)
+        return 0;
+    m->cfg = *cfg;
+    EnvConfig ec = *env;
+    ec.count = cfg->samples;
+    ec.threads = cfg->threads;
+    ec.control_period = cfg->hold;
+    ec.episode_seconds = (float)(cfg->horizon * cfg->hold) * env->dt;
+    m->env = env_create(&ec);
+    size_t k = (size_t)cfg->samples;
+    size_t h = (size_t)cfg->horizon;
+    m->nominal = calloc(h, sizeof(float));
+    m->noise = malloc(h * k * sizeof(float));
+    m->actions = malloc(k * sizeof(float));
+    m->obs = malloc(k * ENV_OBS * sizeof(float));
+    m->returns = malloc(k * sizeof(float));
+    if (!m->env || !m->nominal || !m->noise || !m->actions || !m->obs || !m->returns)
+    {
+        mppi_free(m);
+        return 0;
+    }
+    m->rng = 0x9E3779B9u;
+    m->spin_scale = 1.f / (env->max_speed_factor * env->max_speed_factor);
+    return 1;
+}
+
+float mppi_plan(Mppi* m, const float* state)
+{
+    if (!m || !m->env || !state)
+        return 0.f;
+    const int K = m->cfg.samples;
+    const int H = m->cfg.horizon;
+
+    gaussian_fill(&m->rng, m->noise, H * K, m->cfg.sigma);
+    for (int h = 0; h < H; ++h)
+        m->noise[(size_t)h * K] = 0.f;
+    memset(m->returns, 0, (size_t)K * sizeof(float));
+
+    env_set_state(m->env, NULL, state);
+    for (int h = 0; h < H; ++h)
+    {
+        const float* eps = &m->noise[(size_t)h * K];
+        for (int k = 0; k < K; ++k)
+        {
+            float a = m->nominal[h] + eps[k];
+            a = a < -1.f ? -1.f : (a > 1.f ? 1.f : a);
+            m->actions[k] = a;
+        }
+        env_step(m->env, m->actions, m->obs, NULL, NULL);
+        for (int k = 0; k < K; ++k)
+        {
+            const float* o = &m->obs[(size_t)k * ENV_OBS];
+            float height = 0.5f * (1.f - o[2]); // 0 hanging, 1 upright
+            m->returns[k] += height - m->cfg.w_spin * o[3] * o[3] * m->spin_scale - m->cfg.w_center * o[0] * o[0];
+        }
+    }
+
+    float best = m->returns[0];
+    double mean = 0.0;
+    for (int k = 0; k < K; ++k)
+    {
+        best = m->returns[k] > best ? m->returns[k] : best;
+        mean += m->returns[k];
+    }
+    // returns become weights in place
+    double total = 0.0;
+    for (int k = 0; k < K; ++k)
+    {
+        m->returns[k] = expf((m->returns[k] - best) / m->cfg.lambda);
+        total += m->returns[k];
+    }
+    for (int h = 0; h < H; ++h)
+    {
+        const float* eps = &m->noise[(size_t)h * K];
+        double shift = 0.0;
+        for (int k = 0; k < K; ++k)
+            shift += m->returns[k] * eps[k];
+        float u = m->nominal[h] + (float)(shift / total);
+        m->nominal[h] = u < -1.f ? -1.f : (u > 1.f ? 1.f : u);
+    }
+
+    m->best_return = best;
+    m->mean_return = (float)(mean / K);
+    m->action = m->nominal[0];
+    // warm start: the rest of this plan is the start of the next one; a plan is
+    // one physics step, an action `hold` of them
+    if (++m->tick >= m->cfg.hold)
+    {
+        memmove(m->nominal, m->nominal + 1, (size_t)(H - 1) * sizeof(float));
+        m->tick = 0;
+    }
+    return m->action;
+}
+
+void mppi_reset(Mppi* m)
+{
+    if (!m || !m->nominal)
+        return;
+    memset(m->nominal, 0, (size_t)m->cfg.horizon * sizeof(float));
+    m->tick = 0;
+}
+
+void mppi_free(Mppi* m)
+{
+    if (!m)
+        return;
+    env_destroy(m->env);
+    free(m->nominal);
+    free(m->noise);
+    free(m->actions);
+    free(m->obs);
+    free(m->returns);
+    memset(m, 0, sizeof(*m));
+}
+
+static int cmp_float(const void* a, const void* b)
+{
+    float x = *(const float*)a, y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+int mppi_bench(const MppiConfig* cfg, const EnvConfig* env, float seconds, MppiBench* out)
+{
+    if (!out)
+        return 0;
+    memset(out, 0, sizeof(*out));
+    if (!cfg || !env || seconds <= 0.f)
+        return 0;
+    Mppi m;
+    if (!mppi_init(&m, cfg, env))
+        return 0;
+    EnvConfig pc = *env;
+    pc.count = 1;
+    pc.threads = 1;
+    pc.control_period = 1;
+    pc.theta_noise = 0.f;
+    pc.omega_noise = 0.f;
+    EnvBatch* plant = env_create(&pc);
+    int ticks = (int)(seconds / env->dt);
+    float* ms = malloc((size_t)(ticks > 0 ? ticks : 1) * sizeof(float));
+    if (!plant || !ms || ticks < 1)
+    {
+        free(ms);
+        env_destroy(plant);
+        mppi_free(&m);
+        return 0;
+    }
+
+    const float budget = 1000.f / MPPI_RATE_HZ;
+    int upright = 0;
+    out->swing_up_seconds = -1.f;
+    for (int t = 0; t < ticks; ++t)
+    {
+        float state[ENV_STATE];
+        env_get_state(plant, 0, state);
+        int up = cosf(state[3]) < env->upright_threshold;
+        if (up && out->swing_up_seconds < 0.f)
+            out->swing_up_seconds = (float)t * env->dt;
+        if (up && t >= ticks / 2)
+            upright++;
+        double t0 = now_sec();
+        float action = mppi_plan(&m, state);
+        ms[t] = (float)((now_sec() - t0) * 1e3);
+        if (ms[t] > budget)
+            out->over_budget++;
+        env_step(plant, &action, NULL, NULL, NULL);
+    }
+    qsort(ms, (size_t)ticks, sizeof(float), cmp_float);
+    out->ticks = ticks;
+    out->threads = env_threads(m.env);
+    out->budget_ms = budget;
+    out->plan_p50_ms = ms[(ticks - 1) / 2];
+    out->plan_p99_ms = ms[(int)((ticks - 1) * 0.99f)];
+    out->plan_max_ms = ms[ticks - 1];
+    out->upright_share = (float)upright / (float)(ticks - ticks / 2);
+    free(ms);
+    env_destroy(plant);
+    mppi_free(&m);
+    return 1;
+}
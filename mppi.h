@@ -0,0 +1,76 @@
+#pragma once
+
+#include "env.h"
+
+// Sampling-based model-predictive control (MPPI) over the batched simulator.
+// Every tick the current state is loaded into `samples` envs of an EnvBatch,
+// each rolls out the nominal action sequence plus its own Gaussian noise for
+// `horizon` actions (each held `hold` physics steps), and the nominal is
+// replaced by the return-weighted mean of the sampled sequences:
+//   w_k = exp((R_k - max R) / lambda),  U_h += sum_k w_k eps_kh / sum_k w_k
+// The first action is applied, the sequence is shifted by one tick and kept as
+// the warm start of the next plan. Sample 0 is the nominal without noise.
+// The GA rewards clamp the running fitness at 0, so they are flat around the
+// hanging position and give the sampler nothing to follow; the planner scores
+// each action from the env's observations instead: bob height, minus spin and
+// distance from the track center.
+
+#define MPPI_RATE_HZ 120.f // plans per second, the physics rate of the pendulum
+
+typedef struct
+{
+    int   samples;
+    int   horizon;   // actions per sequence
+    int   hold;      // physics steps per action
+    float sigma;     // action noise, in [-1, 1] action units
+    float lambda;    // temperature, in return units
+    float w_spin;    // per (omega / max_speed_factor)^2
+    float w_center;  // per (position in [-1, 1])^2
+    int   threads;   // EnvBatch workers, 0: one per CPU
+} MppiConfig;
+
+typedef struct
+{
+    MppiConfig cfg;
+    EnvBatch*  env;
+    float*     nominal;  // [horizon]
+    float*     noise;    // [horizon][samples]
+    float*     actions;  // [samples], one step of every sequence
+    float*     obs;      // [samples][ENV_OBS]
+    float*     returns;  // [samples]
+    unsigned   rng;
+    float      spin_scale;
+    int        tick;     // plans since the nominal was last shifted by one action
+
+    // last plan
+    float      best_return;
+    float      mean_return;
+    float      action;
+} Mppi;
+
+void  mppi_default_config(MppiConfig* cfg);
+// env: the physics to plan with; count, control_period and episode_seconds are
+// set from cfg
+int   mppi_init(Mppi* m, const MppiConfig* cfg, const EnvConfig* env);
+// plans from `state` (ENV_STATE floats) and returns the first action in [-1, 1]
+float mppi_plan(Mppi* m, const float* state);
+void  mppi_reset(Mppi* m);
+void  mppi_free(Mppi* m);
+
+// closed loop against a simulated pendulum (an EnvBatch of one, started at the
+// GA's start state) for `seconds`, one plan per physics step, timed against
+// the 1 / MPPI_RATE_HZ tick budget
+typedef struct
+{
+    int   ticks;
+    int   threads;
+    int   over_budget;
+    float plan_p50_ms;
+    float plan_p99_ms;
+    float plan_max_ms;
+    float budget_ms;
+    float upright_share;   // ticks with cos(theta) < upright_threshold over the second half
+    float swing_up_seconds; // first upright tick, -1: never
+} MppiBench;
+
+int   mppi_bench(const MppiConfig* cfg, const EnvConfig* env, float seconds, MppiBench* out);
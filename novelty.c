@@ -0,0 +1,232 @@
+#include "novelty.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct
+{
+    float d2[NOVELTY_K_MAX]; // ascending
+    int   n;
+    int   k;
+} Knn;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static float novelty_frand(unsigned* s)
+{
+    unsigned x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return ((float)(x >> 8) + 0.5f) * (1.f / 16777216.f);
+}
+
+NoveltyArchive* novelty_create(int k, float add_prob)
+{
+    NoveltyArchive* a = calloc(1, sizeof(NoveltyArchive));
+    if (!a)
+        return NULL;
+    a->k = k < 1 ? 1 : (k > NOVELTY_K_MAX ? NOVELTY_K_MAX : k);
+    a->add_prob = add_prob;
+    a->rng = 0x9E3779B9u;
+    return a;
+}
+
+void novelty_free(NoveltyArchive* a)
+{
+    if (!a)
+        return;
+    free(a->points);
+    free(a->axis);
+    free(a);
+}
+
+void novelty_describe(const GAContext* ga, const GAAgent* agent, float* out)
+{
+    float half = ga->track_width * 0.5f;
+    float up = ga->eval_duration > 0.f ? agent->above_time / ga->eval_duration : 0.f;
+    out[0] = (agent->pivot_x - ga->track_left - half) / half;
+    out[1] = sinf(agent->theta);
+    out[2] = cosf(agent->theta);
+    out[3] = agent->omega / ga->max_speed_factor;
+    out[4] = 2.f * (up > 1.f ? 1.f : up) - 1.f;
+}
+
+static void swap_points(float* p, size_t i, size_t j)
+{
+    float t[NOVELTY_DIM];
+    memcpy(t, &p[i * NOVELTY_DIM], sizeof(t));
+    memcpy(&p[i * NOVELTY_DIM], &p[j * NOVELTY_DIM], sizeof(t));
+    memcpy(&p[j * NOVELTY_DIM], t, sizeof(t));
+}
+
+// quickselect: the nth point of [lo, hi) on `axis` ends at index nth
+static void select_nth(float* p, size_t lo, size_t hi, size_t nth, int axis)
+{
+    while (hi - lo > 1)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        // median of three as the pivot, moved to hi - 1
+        float a = p[lo * NOVELTY_DIM + axis], b = p[mid * NOVELTY_DIM + axis], c = p[(hi - 1) * NOVELTY_DIM + axis];
+        size_t pick = (a < b) == (b < c) ? mid : ((b < a) == (a < c) ? lo : hi - 1);
+        swap_points(p, pick, hi - 1);
+        float pivot = p[(hi - 1) * NOVELTY_DIM + axis];
+        size_t store = lo;
+        for (size_t i = lo; i < hi - 1; ++i)
+        {
+            if (p[i * NOVELTY_DIM + axis] < pivot)
+                swap_points(p, i, store++);
+        }
+        swap_points(p, store, hi - 1);
+        if (store == nth)
+            return;
+        if (nth < store)
+            hi = store;
+        else
+            lo = store + 1;
+    }
+}
+
+// the node of [lo, hi) is its middle entry, split on the range's widest axis
+static void build(NoveltyArchive* a, size_t lo, size_t hi)
+{
+    while (hi - lo > NOVELTY_LEAF)
+    {
+        float mn[NOVELTY_DIM], mx[NOVELTY_DIM];
+        for (int d = 0; d < NOVELTY_DIM; ++d)
+            mn[d] = mx[d] = a->points[lo * NOVELTY_DIM + d];
+        for (size_t i = lo + 1; i < hi; ++i)
+        {
+            const float* p = &a->points[i * NOVELTY_DIM];
+            for (int d = 0; d < NOVELTY_DIM; ++d)
+            {
+                mn[d] = p[d] < mn[d] ? p[d] : mn[d];
+                mx[d] = p[d] > mx[d] ? p[d] : mx[d];
+            }
+        }
+        int axis = 0;
+        for (int d = 1; d < NOVELTY_DIM; ++d)
+            axis = mx[d] - mn[d] > mx[axis] - mn[axis] ? d : axis;
+        size_t mid = lo + (hi - lo) / 2;
+        select_nth(a->points, lo, hi, mid, axis);
+        a->axis[mid] = (unsigned char)axis;
+        build(a, lo, mid);
+        lo = mid + 1;
+    }
+}
+
+static float dist2(const float* p, const float* q)
+{
+    float s = 0.f;
+    for (int d = 0; d < NOVELTY_DIM; ++d)
+    {
+        float t = p[d] - q[d];
+        s += t * t;
+    }
+    return s;
+}
+
+static float knn_worst(const Knn* s)
+{
+    return s->n < s->k ? INFINITY : s->d2[s->n - 1];
+}
+
+static void knn_offer(Knn* s, float d2)
+{
+    if (s->n == s->k && d2 >= s->d2[s->n - 1])
+        return;
+    int at = s->n < s->k ? s->n++ : s->n - 1;
+    while (at > 0 && s->d2[at - 1] > d2)
+    {
+        s->d2[at] = s->d2[at - 1];
+        at--;
+    }
+    s->d2[at] = d2;
+}
+
+static void search(const NoveltyArchive* a, size_t lo, size_t hi, const float* q, Knn* s)
+{
+    while (hi - lo > NOVELTY_LEAF)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        const float* p = &a->points[mid * NOVELTY_DIM];
+        knn_offer(s, dist2(p, q));
+        int axis = a->axis[mid];
+        float diff = q[axis] - p[axis];
+        // near side first; the far side only if the splitting plane is closer than the kth best
+        if (diff < 0.f)
+        {
+            search(a, lo, mid, q, s);
+            lo = mid + 1;
+        }
+        else
+        {
+            search(a, mid + 1, hi, q, s);
+            hi = mid;
+        }
+        if (diff * diff >= knn_worst(s))
+            return;
+    }
+    for (size_t i = lo; i < hi; ++i)
+        knn_offer(s, dist2(&a->points[i * NOVELTY_DIM], q));
+}
+
+float novelty_query(const NoveltyArchive* a, const float* q)
+{
+    if (!a || a->count == 0)
+        return 0.f;
+    Knn s;
+    s.n = 0;
+    s.k = a->count < (size_t)a->k ? (int)a->count : a->k;
+    search(a, 0, a->tree_count, q, &s);
+    for (size_t i = a->tree_count; i < a->count; ++i)
+        knn_offer(&s, dist2(&a->points[i * NOVELTY_DIM], q));
+    float sum = 0.f;
+    for (int j = 0; j < s.n; ++j)
+        sum += sqrtf(s.d2[j]);
+    return s.n > 0 ? sum / (float)s.n : 0.f;
+}
+
+void novelty_add(NoveltyArchive* a, const float* desc, int n, float add_prob)
+{
+    if (!a || !desc || n < 1)
+        return;
+    for (int i = 0; i < n; ++i)
+    {
+        if (add_prob < 1.f && novelty_frand(&a->rng) >= add_prob)
+            continue;
+        if (a->count == a->capacity)
+        {
+            size_t cap = a->capacity ? a->capacity * 2 : 1024;
+            float* points = realloc(a->points, cap * NOVELTY_DIM * sizeof(float));
+            if (!points)
+                return;
+            a->points = points;
+            unsigned char* axis = realloc(a->axis, cap);
+            if (!axis)
+                return;
+            a->axis = axis;
+            a->capacity = cap;
+        }
+        memcpy(&a->points[a->count * NOVELTY_DIM], &desc[(size_t)i * NOVELTY_DIM], NOVELTY_DIM * sizeof(float));
+        a->count++;
+    }
+    size_t tail = a->count - a->tree_count;
+    size_t limit = a->count / 64 > NOVELTY_TAIL_MIN ? a->count / 64 : NOVELTY_TAIL_MIN;
+    if (tail > limit)
+    {
+        double t0 = now_sec();
+        build(a, 0, a->count);
+        a->tree_count = a->count;
+        a->rebuilds++;
+        a->build_ms = (float)((now_sec() - t0) * 1e3);
+    }
+}
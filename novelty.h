@@ -0,0 +1,50 @@
+#pragma once
+
+#include "ga.h"
+
+// Novelty search archive. Every evaluated agent gets a behavior descriptor
+// from its end state and trajectory statistics; its novelty is the mean
+// distance to its k nearest descriptors in the archive, and a random share of
+// each generation's descriptors is added to the archive.
+//
+// The archive is a k-d tree over most entries plus a short unsorted tail of
+// recent ones: queries descend the tree (median splits on the widest axis,
+// implicit layout, leaves of NOVELTY_LEAF) and scan the tail; the tree is
+// rebuilt once the tail outgrows max(NOVELTY_TAIL_MIN, size / 64), so inserts
+// cost O(log n) amortized and a query stays logarithmic at millions of entries.
+// Queries only read the archive: the GA's eval workers score their own agents
+// at the end of the rollouts, and SELECT adds to the archive afterwards.
+
+#define NOVELTY_DIM      5  // pivot position, sin theta, cos theta, omega, upright share of the episode
+#define NOVELTY_K_MAX    32
+#define NOVELTY_LEAF     8
+#define NOVELTY_TAIL_MIN 4096
+#define NOVELTY_K        15
+#define NOVELTY_ADD_PROB 0.02f // share of each generation's descriptors archived by the GA
+
+typedef struct NoveltyArchive
+{
+    float*         points;     // [capacity][NOVELTY_DIM], tree order first, then the tail
+    unsigned char* axis;       // split axis of the node stored at each tree index
+    size_t         count;
+    size_t         tree_count;
+    size_t         capacity;
+    int            k;
+    float          add_prob;   // share of each generation's descriptors archived
+    unsigned       rng;
+    int            rebuilds;
+
+    // last generation
+    float          mean_novelty;
+    float          score_ms;   // kNN time summed over the eval workers
+    float          build_ms;
+} NoveltyArchive;
+
+NoveltyArchive* novelty_create(int k, float add_prob);
+void            novelty_free(NoveltyArchive* a);
+void            novelty_describe(const GAContext* ga, const GAAgent* agent, float* out);
+// appends n descriptors, each kept with probability add_prob (1: all of them)
+void            novelty_add(NoveltyArchive* a, const float* desc, int n, float add_prob);
+// mean distance of q to its min(k, size) nearest archived descriptors, 0 while
+// the archive is empty; safe from any number of threads between novelty_add calls
+float           novelty_query(const NoveltyArchive* a, const float* q);
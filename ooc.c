@@ -0,0 +1,597 @@
+#include "ooc.h"
+#include "trace.h"
+
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define OOC_PASS_INIT    0
+#define OOC_PASS_EVAL    1
+#define OOC_PASS_PARENTS 2
+#define OOC_PASS_BREED   3
+
+struct OocPass;
+
+typedef struct
+{
+    struct OocPass* pass;
+    int      index;
+    unsigned rng;
+    uint64_t seen;      // eval: genomes, parents: elites; the weight of the reservoir
+    int      kept;
+    int      cap;
+    float*   samples;   // eval: fitness reservoir
+    Genome*  parents;   // parents: elite reservoir
+    uint64_t evaluated;
+    uint64_t elites;
+    float    best;
+    uint64_t best_index;
+} OocWorker;
+
+typedef struct OocPass
+{
+    OocPopulation* pop;
+    GAContext*     ga;
+    int            kind;
+    float          dt;
+    int            steps;
+    float          threshold;
+    float          tie;      // share of the genomes at the threshold that are elites
+    const Genome*  pool;
+    int            pool_size;
+    atomic_ullong  next;
+    uint64_t       blocks;
+    atomic_int*    tile_left;
+    int            threads;
+    OocWorker      workers[GA_THREAD_COUNT];
+} OocPass;
+
+typedef struct
+{
+    float value;
+    float weight;
+} OocSample;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static unsigned ooc_rand(OocWorker* w)
+{
+    unsigned x = w->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    w->rng = x;
+    return x;
+}
+
+// uniform in [0, 1) from the index alone: both passes agree on tie-breaks
+static float tie_hash(uint64_t i, uint32_t generation)
+{
+    uint64_t z = i + ((uint64_t)generation << 40) + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    return (float)(z >> 40) * (1.f / 16777216.f);
+}
+
+static int is_elite(const OocPass* pass, uint64_t i, float fitness)
+{
+    if (fitness != pass->threshold)
+        return fitness > pass->threshold;
+    return tie_hash(i, pass->pop->header->generation) < pass->tie;
+}
+
+// madvise wants page-aligned ranges: read-ahead rounds outward, dropping rounds
+// inward so a page shared with a neighbouring tile that is still in use is kept
+static void tile_range(const OocPopulation* p, uint64_t tile, int outward, size_t* offset, size_t* bytes)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    uint64_t first = tile * (uint64_t)p->tile;
+    uint64_t last = first + (uint64_t)p->tile;
+    if (last > p->count)
+        last = p->count;
+    size_t start = OOC_HEADER_BYTES + (size_t)first * sizeof(Genome);
+    size_t end = OOC_HEADER_BYTES + (size_t)last * sizeof(Genome);
+    if (outward)
+    {
+        start = start / page * page;
+        end = (end + page - 1) / page * page;
+        if (end > p->map_bytes)
+            end = p->map_bytes;
+    }
+    else
+    {
+        start = (start + page - 1) / page * page;
+        end = end / page * page;
+    }
+    *offset = start;
+    *bytes = end > start ? end - start : 0;
+}
+
+static void prefetch_tile(const OocPopulation* p, uint64_t tile)
+{
+    if (tile * (uint64_t)p->tile >= p->count)
+        return;
+    size_t off, bytes;
+    tile_range(p, tile, 1, &off, &bytes);
+    if (bytes)
+        madvise(p->map + off, bytes, MADV_WILLNEED);
+}
+
+static void release_tile(const OocPopulation* p, uint64_t tile, int written)
+{
+    size_t off, bytes;
+    tile_range(p, tile, 0, &off, &bytes);
+    if (!bytes)
+        return;
+    if (written)
+        msync(p->map + off, bytes, MS_ASYNC);
+    madvise(p->map + off, bytes, MADV_DONTNEED);
+#ifdef POSIX_FADV_DONTNEED
+    // starts write-back of dirty pages and drops the clean ones from the page cache
+    posix_fadvise(p->fd, (off_t)off, (off_t)bytes, POSIX_FADV_DONTNEED);
+#endif
+}
+
+static void eval_block(OocPass* pass, OocWorker* w, uint64_t start, uint64_t end)
+{
+    Genome* g = pass->pop->genomes;
+    for (uint64_t i = start; i < end; ++i)
+    {
+        if (g[i].fitness == OOC_UNEVALUATED)
+        {
+            g[i].fitness = ga_rollout_from(pass->ga, &g[i], NULL, GA_EVAL_FLOAT, pass->dt, pass->steps, NULL);
+            w->evaluated++;
+        }
+        float f = g[i].fitness;
+        if (f > w->best)
+        {
+            w->best = f;
+            w->best_index = i;
+        }
+        // reservoir sample of the fitness
+        w->seen++;
+        if (w->kept < w->cap)
+            w->samples[w->kept++] = f;
+        else
+        {
+            uint64_t r = ((uint64_t)ooc_rand(w) << 32 | ooc_rand(w)) % w->seen;
+            if (r < (uint64_t)w->cap)
+                w->samples[r] = f;
+        }
+    }
+}
+
+static void parents_block(OocPass* pass, OocWorker* w, uint64_t start, uint64_t end)
+{
+    const Genome* g = pass->pop->genomes;
+    for (uint64_t i = start; i < end; ++i)
+    {
+        if (!is_elite(pass, i, g[i].fitness))
+            continue;
+        w->seen++;
+        if (w->kept < w->cap)
+            w->parents[w->kept++] = g[i];
+        else
+        {
+            uint64_t r = ((uint64_t)ooc_rand(w) << 32 | ooc_rand(w)) % w->seen;
+            if (r < (uint64_t)w->cap)
+                w->parents[r] = g[i];
+        }
+    }
+}
+
+static void breed_block(OocPass* pass, OocWorker* w, uint64_t start, uint64_t end)
+{
+    Genome* g = pass->pop->genomes;
+    for (uint64_t i = start; i < end; ++i)
+    {
+        if (is_elite(pass, i, g[i].fitness))
+        {
+            w->elites++;
+            continue;
+        }
+        const Genome* a = &pass->pool[ooc_rand(w) % (unsigned)pass->pool_size];
+        const Genome* b = &pass->pool[ooc_rand(w) % (unsigned)pass->pool_size];
+        Genome child;
+        ga_breed(pass->ga, a, b, &child);
+        child.fitness = OOC_UNEVALUATED;
+        g[i] = child;
+    }
+}
+
+static void init_block(OocPass* pass, OocWorker* w, uint64_t start, uint64_t end)
+{
+    (void)w;
+    Genome* g = pass->pop->genomes;
+    for (uint64_t i = start; i < end; ++i)
+    {
+        Genome child;
+        ga_random_genome(&child);
+        child.fitness = OOC_UNEVALUATED;
+        g[i] = child;
+    }
+}
+
+static void* ooc_worker(void* arg)
+{
+    OocWorker* w = (OocWorker*)arg;
+    OocPass* pass = w->pass;
+    OocPopulation* p = pass->pop;
+    static const char* const names[4] = {"init", "eval", "parents", "breed"};
+    trace_bind(TRACE_TRACK_WORKER + w->index, "ooc");
+    uint64_t blocks_per_tile = (uint64_t)p->tile / OOC_BLOCK;
+    for (;;)
+    {
+        uint64_t b = atomic_fetch_add(&pass->next, 1);
+        if (b >= pass->blocks)
+            break;
+        uint64_t tile = b / blocks_per_tile;
+        if (b % blocks_per_tile == 0)
+            prefetch_tile(p, tile + 1);
+        uint64_t start = b * OOC_BLOCK;
+        uint64_t end = start + OOC_BLOCK;
+        if (end > p->count)
+            end = p->count;
+
+        unsigned long long tr = trace_begin();
+        switch (pass->kind)
+        {
+            case OOC_PASS_INIT:
+                init_block(pass, w, start, end);
+                break;
+            case OOC_PASS_EVAL:
+                eval_block(pass, w, start, end);
+                break;
+            case OOC_PASS_PARENTS:
+                parents_block(pass, w, start, end);
+                break;
+            case OOC_PASS_BREED:
+            default:
+                breed_block(pass, w, start, end);
+                break;
+        }
+        trace_end(tr, names[pass->kind], (int)tile);
+
+        if (atomic_fetch_sub(&pass->tile_left[tile], 1) == 1)
+            release_tile(p, tile, pass->kind != OOC_PASS_PARENTS);
+    }
+    return NULL;
+}
+
+// one streaming pass over the whole file on all workers
+static int run_pass(OocPass* pass)
+{
+    OocPopulation* p = pass->pop;
+    uint64_t blocks_per_tile = (uint64_t)p->tile / OOC_BLOCK;
+    uint64_t tiles = (p->count + (uint64_t)p->tile - 1) / (uint64_t)p->tile;
+    pass->blocks = (p->count + OOC_BLOCK - 1) / OOC_BLOCK;
+    pass->tile_left = malloc((size_t)tiles * sizeof(atomic_int));
+    if (!pass->tile_left)
+        return 0;
+    for (uint64_t t = 0; t < tiles; ++t)
+    {
+        uint64_t left = pass->blocks - t * blocks_per_tile;
+        atomic_init(&pass->tile_left[t], (int)(left < blocks_per_tile ? left : blocks_per_tile));
+    }
+    atomic_store(&pass->next, 0);
+    prefetch_tile(p, 0);
+
+    int threads = GA_THREAD_COUNT;
+    if ((uint64_t)threads > pass->blocks)
+        threads = (int)pass->blocks;
+    pthread_t tids[GA_THREAD_COUNT];
+    int started = 0;
+    for (int t = 0; t < threads; ++t)
+    {
+        OocWorker* w = &pass->workers[t];
+        w->pass = pass;
+        w->index = t;
+        w->rng = 0x9E3779B9u * (unsigned)(t + 1) ^ (unsigned)(p->header->generation * 0x85EBCA6Bu);
+        w->seen = 0;
+        w->kept = 0;
+        w->evaluated = 0;
+        w->elites = 0;
+        w->best = -1e9f;
+        w->best_index = 0;
+        // worker 0 runs on this thread; the blocks of a worker that failed to
+        // start go to the others
+        if (t == 0)
+            continue;
+        if (pthread_create(&tids[t], NULL, ooc_worker, w) != 0)
+            break;
+        started++;
+    }
+    pass->threads = started + 1;
+    ooc_worker(&pass->workers[0]);
+    trace_bind(TRACE_TRACK_MAIN, "main");
+    for (int t = 1; t <= started; ++t)
+        pthread_join(tids[t], NULL);
+    free(pass->tile_left);
+    pass->tile_left = NULL;
+    return 1;
+}
+
+static int cmp_sample_desc(const void* a, const void* b)
+{
+    float x = ((const OocSample*)a)->value;
+    float y = ((const OocSample*)b)->value;
+    return (x < y) - (x > y);
+}
+
+// elite threshold from the workers' reservoirs, each weighted by what it saw
+static void elite_threshold(OocPass* pass, float fraction)
+{
+    int n = 0;
+    for (int t = 0; t < pass->threads; ++t)
+        n += pass->workers[t].kept;
+    OocSample* s = malloc((size_t)(n ? n : 1) * sizeof(OocSample));
+    pass->threshold = 0.f;
+    pass->tie = 1.f;
+    if (!s || n == 0)
+    {
+        free(s);
+        return;
+    }
+    int k = 0;
+    double total = 0.0;
+    for (int t = 0; t < pass->threads; ++t)
+    {
+        const OocWorker* w = &pass->workers[t];
+        float weight = w->kept ? (float)((double)w->seen / (double)w->kept) : 0.f;
+        for (int i = 0; i < w->kept; ++i)
+        {
+            s[k].value = w->samples[i];
+            s[k].weight = weight;
+            total += weight;
+            k++;
+        }
+    }
+    qsort(s, (size_t)n, sizeof(OocSample), cmp_sample_desc);
+    double want = total * (double)fraction;
+    double above = 0.0;
+    int i = 0;
+    while (i < n - 1 && above + s[i].weight < want)
+        above += s[i++].weight;
+    float t = s[i].value;
+    // weight strictly above and at the threshold
+    double over = 0.0, at = 0.0;
+    for (int j = 0; j < n; ++j)
+    {
+        if (s[j].value > t)
+            over += s[j].weight;
+        else if (s[j].value == t)
+            at += s[j].weight;
+    }
+    pass->threshold = t;
+    pass->tie = at > 0.0 ? (float)((want - over) / at) : 1.f;
+    if (pass->tie < 0.f)
+        pass->tie = 0.f;
+    if (pass->tie > 1.f)
+        pass->tie = 1.f;
+    free(s);
+}
+
+static long peak_rss_kb(void)
+{
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0)
+        return 0;
+#ifdef __APPLE__
+    return ru.ru_maxrss / 1024; // bytes there
+#else
+    return ru.ru_maxrss;
+#endif
+}
+
+int ooc_open(OocPopulation* p, const char* path, uint64_t count, int tile)
+{
+    memset(p, 0, sizeof(*p));
+    p->fd = -1;
+    if (!path || count < 2)
+        return 0;
+    if (tile < OOC_BLOCK)
+        tile = OOC_TILE_DEFAULT;
+    p->tile = (tile + OOC_BLOCK - 1) / OOC_BLOCK * OOC_BLOCK;
+    p->count = count;
+
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        return 0;
+    size_t bytes = OOC_HEADER_BYTES + (size_t)count * sizeof(Genome);
+    OocHeader h;
+    struct stat st;
+    // a truncated file would fault on first access through the mapping
+    int reuse = pread(fd, &h, sizeof(h), 0) == (ssize_t)sizeof(h) && h.magic == OOC_MAGIC && h.version == OOC_VERSION
+                && h.record_bytes == sizeof(Genome) && h.count == count && fstat(fd, &st) == 0
+                && (uint64_t)st.st_size >= (uint64_t)bytes;
+    if (!reuse && (ftruncate(fd, 0) != 0 || ftruncate(fd, (off_t)bytes) != 0))
+    {
+        close(fd);
+        return 0;
+    }
+    void* map = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        close(fd);
+        return 0;
+    }
+    p->fd = fd;
+    p->map = map;
+    p->map_bytes = bytes;
+    p->header = (OocHeader*)map;
+    p->genomes = (Genome*)(p->map + OOC_HEADER_BYTES);
+    madvise(p->map, bytes, MADV_SEQUENTIAL);
+
+    if (!reuse)
+    {
+        memset(p->header, 0, sizeof(*p->header));
+        p->header->magic = OOC_MAGIC;
+        p->header->version = OOC_VERSION;
+        p->header->record_bytes = sizeof(Genome);
+        p->header->count = count;
+        p->header->best = -1e9f;
+        OocPass* pass = calloc(1, sizeof(OocPass));
+        int ok = pass != NULL;
+        if (ok)
+        {
+            pass->pop = p;
+            pass->kind = OOC_PASS_INIT;
+            ok = run_pass(pass);
+        }
+        free(pass);
+        if (!ok)
+        {
+            ooc_close(p);
+            return 0;
+        }
+        msync(p->map, OOC_HEADER_BYTES, MS_ASYNC);
+        p->created = 1;
+    }
+    p->peak_rss_kb = peak_rss_kb();
+    return 1;
+}
+
+int ooc_generation(OocPopulation* p, GAContext* ga, float dt)
+{
+    if (!p || !p->map || !ga || dt <= 0.f)
+        return 0;
+    OocPass* pass = calloc(1, sizeof(OocPass));
+    if (!pass)
+        return 0;
+    pass->pop = p;
+    pass->ga = ga;
+    pass->dt = dt;
+    pass->steps = (int)ceilf(ga->eval_duration / dt);
+    if (pass->steps < 1)
+        pass->steps = 1;
+
+    int ok = 1;
+    int cap = OOC_SAMPLES / GA_THREAD_COUNT;
+    for (int t = 0; t < GA_THREAD_COUNT && ok; ++t)
+    {
+        pass->workers[t].cap = cap;
+        pass->workers[t].samples = malloc((size_t)cap * sizeof(float));
+        // a worker may see every elite: with fewer than OOC_PARENTS of them
+        // the pool must end up with all of them
+        pass->workers[t].parents = malloc((size_t)OOC_PARENTS * sizeof(Genome));
+        ok = pass->workers[t].samples && pass->workers[t].parents;
+    }
+    Genome* pool = ok ? malloc((size_t)OOC_PARENTS * sizeof(Genome)) : NULL;
+    ok = ok && pool;
+
+    double t0 = now_sec();
+    if (ok)
+    {
+        pass->kind = OOC_PASS_EVAL;
+        ok = run_pass(pass);
+    }
+    double t1 = now_sec();
+    if (ok)
+    {
+        uint64_t evaluated = 0;
+        float best = -1e9f;
+        uint64_t best_index = 0;
+        for (int t = 0; t < pass->threads; ++t)
+        {
+            const OocWorker* w = &pass->workers[t];
+            evaluated += w->evaluated;
+            if (w->best > best)
+            {
+                best = w->best;
+                best_index = w->best_index;
+            }
+        }
+        p->evaluated = evaluated;
+        p->champion = p->genomes[best_index];
+        p->header->best = best;
+        elite_threshold(pass, ga->elite_fraction);
+        p->header->threshold = pass->threshold;
+
+        pass->kind = OOC_PASS_PARENTS;
+        for (int t = 0; t < GA_THREAD_COUNT; ++t)
+            pass->workers[t].cap = OOC_PARENTS;
+        ok = run_pass(pass);
+    }
+    double t2 = now_sec();
+    if (ok)
+    {
+        // each worker contributes in proportion to the elites it saw
+        uint64_t seen = 0;
+        for (int t = 0; t < pass->threads; ++t)
+            seen += pass->workers[t].seen;
+        int n = 0;
+        for (int t = 0; t < pass->threads; ++t)
+        {
+            const OocWorker* w = &pass->workers[t];
+            int take = seen ? (int)((double)OOC_PARENTS * (double)w->seen / (double)seen) : 0;
+            if (take > w->kept)
+                take = w->kept;
+            if (take > OOC_PARENTS - n)
+                take = OOC_PARENTS - n;
+            memcpy(&pool[n], w->parents, (size_t)take * sizeof(Genome));
+            n += take;
+        }
+        p->parents = n;
+        pass->pool = pool;
+        pass->pool_size = n;
+        if (n > 0)
+        {
+            pass->kind = OOC_PASS_BREED;
+            ok = run_pass(pass);
+            p->elites = 0;
+            for (int t = 0; t < pass->threads; ++t)
+                p->elites += pass->workers[t].elites;
+        }
+    }
+    double t3 = now_sec();
+    if (ok)
+    {
+        p->header->generation++;
+        msync(p->map, OOC_HEADER_BYTES, MS_ASYNC);
+        p->eval_seconds = t1 - t0;
+        p->parents_seconds = t2 - t1;
+        p->breed_seconds = t3 - t2;
+        p->peak_rss_kb = peak_rss_kb();
+    }
+
+    for (int t = 0; t < GA_THREAD_COUNT; ++t)
+    {
+        free(pass->workers[t].samples);
+        free(pass->workers[t].parents);
+    }
+    free(pool);
+    free(pass);
+    return ok;
+}
+
+void ooc_close(OocPopulation* p)
+{
+    if (!p)
+        return;
+    if (p->map)
+    {
+        msync(p->map, p->map_bytes, MS_SYNC);
+        munmap(p->map, p->map_bytes);
+    }
+    if (p->fd >= 0)
+        close(p->fd);
+    p->map = NULL;
+    p->header = NULL;
+    p->genomes = NULL;
+    p->fd = -1;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ga.h"
+
+// Out-of-core population: the genomes live in a file mapped MAP_SHARED, so the
+// population size is bounded by the disk, not by RAM.
+// Every pass streams the file in tiles of `tile` genomes. Workers take blocks
+// in file order; the worker that opens a tile asks for the next one to be read
+// ahead (MADV_WILLNEED), and the worker that finishes a tile drops it from the
+// mapping and the page cache, so the resident set stays at a few tiles
+// whatever the population size.
+//
+// A generation is three sequential passes over the file:
+//   eval     rollout of every genome not evaluated yet, fitness written in place;
+//            a reservoir sample of the fitness gives the elite threshold
+//   parents  reservoir sample of up to OOC_PARENTS elites, copied to RAM (one
+//            reservoir of OOC_PARENTS per worker, only touched as it fills)
+//   breed    non-elites are overwritten in place by children of those parents
+// Elites keep their fitness (a rollout is deterministic) and are not rolled out
+// again. Ties at the threshold are broken by a hash of the index, so the
+// parents and breed passes agree on who is an elite.
+//
+// File: OocHeader, padded to one page, then `count` Genome records.
+
+#define OOC_MAGIC        0x50474f4fu // "OOGP"
+#define OOC_VERSION      1
+#define OOC_HEADER_BYTES 4096
+#define OOC_TILE_DEFAULT (1 << 16)   // genomes; a multiple of 1024 keeps tiles page-aligned
+#define OOC_BLOCK        256         // genomes per unit of work, divides the tile
+#define OOC_PARENTS      16384
+#define OOC_SAMPLES      65536
+#define OOC_UNEVALUATED  -1.f
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_bytes;
+    uint32_t generation;
+    uint64_t count;
+    float    best;
+    float    threshold;
+} OocHeader;
+
+typedef struct
+{
+    int        fd;
+    unsigned char* map;
+    size_t     map_bytes;
+    OocHeader* header;
+    Genome*    genomes;
+    uint64_t   count;
+    int        tile;
+    Genome     champion;   // best genome of the last eval pass
+    int        created;    // ooc_open made a new file
+
+    // last generation
+    uint64_t   evaluated;
+    uint64_t   elites;
+    int        parents;
+    double     eval_seconds;
+    double     parents_seconds;
+    double     breed_seconds;
+    long       peak_rss_kb;
+} OocPopulation;
+
+// opens `path`, or creates it with random genomes when it is missing or was
+// written for another count or Genome layout
+int  ooc_open(OocPopulation* p, const char* path, uint64_t count, int tile);
+int  ooc_generation(OocPopulation* p, GAContext* ga, float dt);
+void ooc_close(OocPopulation* p);
@@ -73,6 +73,9 @@ bool pendulum_init(Pendulum* p, sfVector2u window_size)
     p->pivot_vel_x = 0.f;
     p->external_control = 0;
     p->base_vel_cmd = 0.f;
+    p->control_period = 1;
+    p->control_hold = 0;
+    p->held_cmd = 0.f;
 
     p->theta = -0.7f;
     p->omega = 0.f;
@@ -154,17 +157,19 @@ void pendulum_handle_event(Pendulum* p, const sfEvent* event)
 {
     if (!p || !event)
         return;
-    if (p->external_control)
-        return;
 
     if (event->type == sfEvtMouseButtonPressed && event->mouseButton.button == sfMouseLeft)
     {
         sfVector2i mp = event->mouseButton.position;
-        sfVector2f thumbPos = sfCircleShape_getPosition(p->slider_thumb);
-        float dx = mp.x - thumbPos.x;
-        float dy = mp.y - thumbPos.y;
-        if (dx * dx + dy * dy <= p->thumb_radius * p->thumb_radius * 1.2f)
-            p->slider_drag = true;
+        // under external control the slider belongs to the controller, only the bob can be disturbed
+        if (!p->external_control)
+        {
+            sfVector2f thumbPos = sfCircleShape_getPosition(p->slider_thumb);
+            float dx = mp.x - thumbPos.x;
+            float dy = mp.y - thumbPos.y;
+            if (dx * dx + dy * dy <= p->thumb_radius * p->thumb_radius * 1.2f)
+                p->slider_drag = true;
+        }
 
         sfVector2f bobPos = p->bob_pos;
         float bdx = mp.x - bobPos.x;
@@ -216,7 +221,17 @@ void pendulum_update(Pendulum* p, float dt)
     // If GA is active, integrate its velocity command into the slider target
     if (p->external_control && dt > 0.f)
     {
-        float cmd = clampf(p->base_vel_cmd, -p->max_base_speed, p->max_base_speed);
+        // the command is sampled once every control_period steps and held in between
+        if (p->control_hold > 0)
+        {
+            p->control_hold--;
+        }
+        else
+        {
+            p->held_cmd = p->base_vel_cmd;
+            p->control_hold = p->control_period - 1;
+        }
+        float cmd = clampf(p->held_cmd, -p->max_base_speed, p->max_base_speed);
         float delta = (cmd * dt) / p->track_width; // px/s -> slider units
         p->slider_value = clampf(p->slider_value + delta, 0.f, 1.f);
     }
@@ -308,6 +323,7 @@ void pendulum_set_external_control(Pendulum* p, int enabled)
     p->bob_drag = false;
     if (!p->external_control)
         p->base_vel_cmd = 0.f;
+    p->control_hold = 0;
 }
 
 void pendulum_set_base_velocity(Pendulum* p, float v)
@@ -317,6 +333,14 @@ void pendulum_set_base_velocity(Pendulum* p, float v)
     p->base_vel_cmd = v;
 }
 
+void pendulum_set_control_period(Pendulum* p, int period)
+{
+    if (!p)
+        return;
+    p->control_period = period < 1 ? 1 : period;
+    p->control_hold = 0;
+}
+
 void pendulum_reset(Pendulum* p)
 {
     if (!p)
@@ -325,6 +349,7 @@ void pendulum_reset(Pendulum* p)
     p->pivot.x = p->track_left + p->track_width * p->slider_value;
     p->pivot_vel_x = 0.f;
     p->base_vel_cmd = 0.f;
+    p->control_hold = 0;
     p->theta = -0.7f;
     p->omega = 0.f;
     p->bob_pos.x = p->pivot.x + p->length * sinf(p->theta);
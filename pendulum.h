@@ -23,6 +23,9 @@ typedef struct
     float       omega;
     int         external_control;
     float       base_vel_cmd;
+    int         control_period; // physics steps the command is held for, as in training
+    int         control_hold;
+    float       held_cmd;
 
     // slider (controls pivot.x)
     float       slider_value; // 0..1
@@ -50,6 +53,7 @@ void  pendulum_draw(const Pendulum* p, sfRenderWindow* window);
 void  pendulum_destroy(Pendulum* p);
 void  pendulum_set_external_control(Pendulum* p, int enabled);
 void  pendulum_set_base_velocity(Pendulum* p, float v);
+void  pendulum_set_control_period(Pendulum* p, int period);
 void  pendulum_reset(Pendulum* p);
 void  pendulum_get_state(const Pendulum* p, float* theta, float* omega, float* pivot_x);
 void  pendulum_get_inputs(const Pendulum* p, float* position, float* dirx, float* diry, float* omega);
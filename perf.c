@@ -0,0 +1,153 @@
+#include "perf.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+static const char* const counter_names[PERF_COUNTERS] = {"task", "cyc", "ins", "l1d", "llc", "br"};
+
+#ifdef __linux__
+static void counter_attr(int id, struct perf_event_attr* attr)
+{
+    memset(attr, 0, sizeof(*attr));
+    attr->size = sizeof(*attr);
+    attr->type = PERF_TYPE_HARDWARE;
+    switch (id)
+    {
+    case PERF_TASK_CLOCK:
+        attr->type = PERF_TYPE_SOFTWARE;
+        attr->config = PERF_COUNT_SW_TASK_CLOCK;
+        break;
+    case PERF_CYCLES:
+        attr->config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case PERF_INSTRUCTIONS:
+        attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case PERF_L1D_MISSES:
+        attr->type = PERF_TYPE_HW_CACHE;
+        attr->config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                     | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    case PERF_LLC_MISSES:
+        attr->config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    case PERF_BRANCH_MISSES:
+        attr->config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    }
+    attr->exclude_kernel = 1;
+    attr->exclude_hv = 1;
+    // more events than hardware counters: the kernel multiplexes, we rescale
+    attr->read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+}
+#endif
+
+unsigned perf_open(PerfCounters* pc)
+{
+    unsigned valid = 0;
+    for (int i = 0; i < PERF_COUNTERS; ++i)
+    {
+        pc->fd[i] = -1;
+#ifdef __linux__
+        struct perf_event_attr attr;
+        counter_attr(i, &attr);
+        pc->fd[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (pc->fd[i] >= 0)
+            valid |= 1u << i;
+#endif
+    }
+    return valid;
+}
+
+void perf_read(const PerfCounters* pc, PerfSample* out)
+{
+    memset(out, 0, sizeof(*out));
+#ifdef __linux__
+    for (int i = 0; i < PERF_COUNTERS; ++i)
+    {
+        unsigned long long v[3];
+        if (pc->fd[i] < 0 || read(pc->fd[i], v, sizeof(v)) != (ssize_t)sizeof(v))
+            continue;
+        // v = {value, time enabled, time running}
+        if (v[2] > 0 && v[2] < v[1])
+            v[0] = (unsigned long long)((double)v[0] * (double)v[1] / (double)v[2]);
+        out->count[i] = v[0];
+        out->valid |= 1u << i;
+    }
+#else
+    (void)pc;
+#endif
+}
+
+void perf_close(PerfCounters* pc)
+{
+    for (int i = 0; i < PERF_COUNTERS; ++i)
+    {
+        if (pc->fd[i] >= 0)
+            close(pc->fd[i]);
+        pc->fd[i] = -1;
+    }
+}
+
+void perf_delta(const PerfSample* before, const PerfSample* after, PerfSample* out)
+{
+    out->valid = before->valid & after->valid;
+    for (int i = 0; i < PERF_COUNTERS; ++i)
+        out->count[i] = after->count[i] >= before->count[i] ? after->count[i] - before->count[i] : 0;
+}
+
+void perf_reset(PerfSample* acc)
+{
+    memset(acc->count, 0, sizeof(acc->count));
+    acc->valid = (1u << PERF_COUNTERS) - 1u;
+}
+
+void perf_add(PerfSample* acc, const PerfSample* s)
+{
+    // a counter is only valid in a sum if it was valid in every part
+    acc->valid &= s->valid;
+    for (int i = 0; i < PERF_COUNTERS; ++i)
+        acc->count[i] += s->count[i];
+}
+
+float perf_ipc(const PerfSample* s)
+{
+    unsigned need = (1u << PERF_CYCLES) | (1u << PERF_INSTRUCTIONS);
+    if ((s->valid & need) != need || s->count[PERF_CYCLES] == 0)
+        return 0.f;
+    return (float)((double)s->count[PERF_INSTRUCTIONS] / (double)s->count[PERF_CYCLES]);
+}
+
+const char* perf_counter_name(int id)
+{
+    return (id >= 0 && id < PERF_COUNTERS) ? counter_names[id] : "?";
+}
+
+int perf_format(const PerfSample* s, char* buf, int len)
+{
+    int at = 0;
+    for (int i = 0; i < PERF_COUNTERS && at < len; ++i)
+    {
+        const char* sep = i ? " " : "";
+        if (!(s->valid & (1u << i)))
+            at += snprintf(buf + at, (size_t)(len - at), "%s%s=n/a", sep, counter_names[i]);
+        else if (i == PERF_TASK_CLOCK)
+            at += snprintf(buf + at, (size_t)(len - at), "%s%s=%.1fms", sep, counter_names[i],
+                           (double)s->count[i] * 1e-6);
+        else
+            at += snprintf(buf + at, (size_t)(len - at), "%s%s=%.3g", sep, counter_names[i], (double)s->count[i]);
+        if (i == PERF_INSTRUCTIONS && at < len)
+        {
+            float ipc = perf_ipc(s);
+            at += ipc > 0.f ? snprintf(buf + at, (size_t)(len - at), " ipc=%.2f", ipc)
+                            : snprintf(buf + at, (size_t)(len - at), " ipc=n/a");
+        }
+    }
+    return at < len ? at : len - 1;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+// Hardware performance counters (Linux perf_event_open), per thread.
+// Each event is opened on its own so a PMU that lacks one of them (VMs often
+// have no LLC or no PMU at all) still reports the others; `valid` says which
+// ones are real. Counts are user-space only, which perf_event_paranoid <= 2
+// allows without privileges. Elsewhere every call is a no-op reporting
+// nothing valid.
+
+#define PERF_TASK_CLOCK     0 // ns on cpu (software event, works without a PMU)
+#define PERF_CYCLES         1
+#define PERF_INSTRUCTIONS   2
+#define PERF_L1D_MISSES     3
+#define PERF_LLC_MISSES     4
+#define PERF_BRANCH_MISSES  5
+#define PERF_COUNTERS       6
+
+typedef struct
+{
+    unsigned long long count[PERF_COUNTERS];
+    unsigned           valid; // bit i: count[i] was measured
+} PerfSample;
+
+typedef struct
+{
+    int fd[PERF_COUNTERS];
+} PerfCounters;
+
+// counters of the calling thread, from now on; returns the valid mask
+unsigned perf_open(PerfCounters* pc);
+void     perf_read(const PerfCounters* pc, PerfSample* out);
+void     perf_close(PerfCounters* pc);
+
+// counts between two reads of the same counters, and accumulation
+// (perf_reset starts an empty sum: zero counts, every counter valid)
+void  perf_delta(const PerfSample* before, const PerfSample* after, PerfSample* out);
+void  perf_reset(PerfSample* acc);
+void  perf_add(PerfSample* acc, const PerfSample* s);
+float perf_ipc(const PerfSample* s); // 0 when cycles/instructions are missing
+
+const char* perf_counter_name(int id);
+// one line "cyc=.. ins=.. ipc=.. l1d=.. llc=.. br=.." with n/a for missing counters
+int         perf_format(const PerfSample* s, char* buf, int len);
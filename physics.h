@@ -0,0 +1,198 @@
+#pragma once
+
+#include <math.h>
+
+#include "ga.h"
+#include "reward.h"
+#include "vmath.h"
+
+// The cart-pendulum step every rollout shares: step_agent (ga.c), the SoA
+// lanes of sweep.c and env.c, sparse.c, and the primal of grad.c. Clamps are
+// selects, and `reward` and `trig` are constants at every call site, so each
+// kernel gets straight-line code with its reward inlined.
+
+#define PHYSICS_NO_REWARD -1 // physics only (grad.c scores its own surrogate)
+
+// trig: libm for the reference rollouts (ga.c, sparse.c, grad.c and whatever
+// checks against them), vmath.h only in the SoA lanes of sweep.c and env.c
+#define PHYSICS_LIBM  0
+#define PHYSICS_VMATH 1
+
+typedef struct
+{
+    float slider;  // base target along the track, [0, 1]
+    float pivot_x;
+    float pivot_v;
+    float theta;
+    float omega;
+    float above;   // reward state
+    float fitness;
+} PhysicsState;
+
+// the parameters sweep.c varies per lane; the rest comes from the context
+typedef struct
+{
+    float length;
+    float gravity;
+    float base_k;
+    float base_d;
+    float damping;
+} PhysicsBody;
+
+// intermediates of a step, for the tangents of grad.c
+typedef struct
+{
+    float pivot_acc;
+    float sin_theta; // of theta before the step
+    float cos_theta;
+    int   slider_clamped;
+    int   pivot_clamped;
+    int   omega_clamped;
+} PhysicsTrace;
+
+// network output in [-1, 1] for the inputs of physics_inputs
+typedef float (*PhysicsPolicy)(const void* net, const float in[GA_INPUTS]);
+
+static GA_ALWAYS_INLINE void physics_sincos(float x, float* s, float* c, const int trig)
+{
+    if (trig == PHYSICS_VMATH)
+    {
+        vmath_sincosf(x, s, c);
+        return;
+    }
+    *s = sinf(x);
+    *c = cosf(x);
+}
+
+static GA_ALWAYS_INLINE float physics_cos(float x, const int trig)
+{
+    return trig == PHYSICS_VMATH ? vmath_cosf(x) : cosf(x);
+}
+
+static GA_ALWAYS_INLINE PhysicsBody physics_body(const GAContext* ga)
+{
+    PhysicsBody b = {ga->length, ga->gravity, ga->base_k, ga->base_d, ga->damping};
+    return b;
+}
+
+// start of every rollout: base centered, pendulum hanging 0.7 rad off
+static GA_ALWAYS_INLINE void physics_reset(const GAContext* ga, PhysicsState* s)
+{
+    s->slider = 0.5f;
+    s->pivot_x = ga->track_left + ga->track_width * 0.5f;
+    s->pivot_v = 0.f;
+    s->theta = -0.7f;
+    s->omega = 0.f;
+    s->above = 0.f;
+    s->fitness = 0.f;
+}
+
+static GA_ALWAYS_INLINE void physics_inputs(float slider, float theta, float omega, float in[GA_INPUTS],
+                                            const int trig)
+{
+    in[0] = slider * 2.f - 1.f; // position [-1,1]
+    physics_sincos(theta, &in[1], &in[2], trig);
+    in[3] = omega;
+}
+
+// One step with base velocity command `control`, then `reward` folded into
+// s->fitness (nothing for PHYSICS_NO_REWARD).
+static GA_ALWAYS_INLINE PhysicsTrace physics_step(const GAContext* ga, const PhysicsBody* b, PhysicsState* s,
+                                                  float control, float dt, const int reward, const int trig)
+{
+    PhysicsTrace t;
+    const float left = ga->track_left;
+    const float right = ga->track_left + ga->track_width;
+
+    // the command moves the slider target, the base follows on a spring-damper
+    float slider = s->slider + (control * dt) / ga->track_width;
+    t.slider_clamped = (slider < 0.f) | (slider > 1.f);
+    slider = slider < 0.f ? 0.f : slider;
+    slider = slider > 1.f ? 1.f : slider;
+
+    float pivot_target_x = left + ga->track_width * slider;
+    float dx = pivot_target_x - s->pivot_x;
+    t.pivot_acc = b->base_k * dx - b->base_d * s->pivot_v;
+    float pv = s->pivot_v + t.pivot_acc * dt;
+    float px = s->pivot_x + pv * dt;
+    t.pivot_clamped = (px < left) | (px > right);
+    px = px < left ? left : px;
+    px = px > right ? right : px;
+    pv = t.pivot_clamped ? 0.f : pv;
+
+    physics_sincos(s->theta, &t.sin_theta, &t.cos_theta, trig);
+    float theta_dd = -(b->gravity / b->length) * t.sin_theta
+                     - (t.pivot_acc / b->length) * t.cos_theta
+                     - b->damping * s->omega;
+    float omega = s->omega + theta_dd * dt;
+    const float max_omega = ga->max_speed_factor;
+    t.omega_clamped = (omega > max_omega) | (omega < -max_omega);
+    omega = omega > max_omega ? max_omega : omega;
+    omega = omega < -max_omega ? -max_omega : omega;
+
+    s->slider = slider;
+    s->pivot_x = px;
+    s->pivot_v = pv;
+    s->omega = omega;
+    s->theta += omega * dt;
+
+#define PHYSICS_REWARD_CASE(id, fn, name)                                                              \
+    case GA_REWARD_##id:                                                                               \
+        s->fitness = reward_##fn(ga, s->fitness, &s->above, s->theta, physics_cos(s->theta, trig), omega, \
+                                 px, pv, control, dt);                                                 \
+        break;
+    switch (reward)
+    {
+        GA_REWARD_LIST(PHYSICS_REWARD_CASE)
+    }
+#undef PHYSICS_REWARD_CASE
+    return t;
+}
+
+// the GA's agent, on libm: zero-order hold of the policy's command for control_period
+// steps, physics and reward, bob position for display
+static GA_ALWAYS_INLINE void physics_agent_step(const GAContext* ga, GAAgent* a, PhysicsPolicy policy,
+                                                const void* net, float dt, const int reward)
+{
+    if (a->hold > 0)
+    {
+        a->hold--;
+    }
+    else
+    {
+        float in[GA_INPUTS];
+        physics_inputs(a->slider_value, a->theta, a->omega, in, PHYSICS_LIBM);
+        a->last_control = policy(net, in) * ga->max_base_speed;
+        a->hold = ga->control_period - 1;
+    }
+
+    PhysicsBody b = physics_body(ga);
+    PhysicsState s = {a->slider_value, a->pivot_x, a->pivot_v, a->theta, a->omega, a->above_time, a->fitness};
+    physics_step(ga, &b, &s, a->last_control, dt, reward, PHYSICS_LIBM);
+    a->slider_value = s.slider;
+    a->pivot_x = s.pivot_x;
+    a->pivot_v = s.pivot_v;
+    a->theta = s.theta;
+    a->omega = s.omega;
+    a->above_time = s.above;
+    a->fitness = s.fitness;
+    a->bob_x = a->pivot_x + ga->length * sinf(a->theta);
+    a->bob_y = ga->pivot_y + ga->length * cosf(a->theta);
+}
+
+static GA_ALWAYS_INLINE void physics_reset_agent(const GAContext* ga, GAAgent* a)
+{
+    PhysicsState s;
+    physics_reset(ga, &s);
+    a->slider_value = s.slider;
+    a->pivot_x = s.pivot_x;
+    a->pivot_v = s.pivot_v;
+    a->theta = s.theta;
+    a->omega = s.omega;
+    a->above_time = s.above;
+    a->fitness = s.fitness;
+    a->bob_x = a->pivot_x + ga->length * sinf(a->theta);
+    a->bob_y = ga->pivot_y + ga->length * cosf(a->theta);
+    a->last_control = 0.f;
+    a->hold = 0;
+}
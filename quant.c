@@ -0,0 +1,188 @@
+#include "quant.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__AVX2__) && GA_MAX_HIDDEN == 8 && GA_INPUTS == 4
+#include <immintrin.h>
+#define QUANT_USE_AVX2 1
+#endif
+
+static int16_t       tanh_lut[QUANT_TANH_LUT_SIZE];
+static pthread_once_t tanh_lut_once = PTHREAD_ONCE_INIT;
+
+static void build_tanh_lut(void)
+{
+    const float half = (float)(QUANT_TANH_LUT_SIZE / 2);
+    for (int i = 0; i < QUANT_TANH_LUT_SIZE; ++i)
+    {
+        float z = ((float)i - half) * (QUANT_TANH_RANGE / half);
+        tanh_lut[i] = (int16_t)lrintf(tanhf(z) * 32767.f);
+    }
+}
+
+static int8_t q8(float v)
+{
+    long r = lrintf(v);
+    if (r > 127)
+        r = 127;
+    if (r < -127)
+        r = -127;
+    return (int8_t)r;
+}
+
+static int16_t q16(float v)
+{
+    long r = lrintf(v);
+    if (r > 32767)
+        r = 32767;
+    if (r < -32767)
+        r = -32767;
+    return (int16_t)r;
+}
+
+// accumulator -> table index multiplier (Q24) for a row with weight scale s
+// over activations of scale a
+static int32_t lut_mul(float s, float a)
+{
+    return (int32_t)lrintf(16777216.f * (float)(QUANT_TANH_LUT_SIZE / 2) / (QUANT_TANH_RANGE * s * a));
+}
+
+static int16_t lut_tanh(int32_t acc, int32_t mul)
+{
+    int64_t idx = (((int64_t)acc * mul + (1 << 23)) >> 24) + QUANT_TANH_LUT_SIZE / 2;
+    if (idx < 0)
+        idx = 0;
+    if (idx > QUANT_TANH_LUT_SIZE - 1)
+        idx = QUANT_TANH_LUT_SIZE - 1;
+    return tanh_lut[idx];
+}
+
+// per-row int8 weight scale. The row's largest weight maps to 96..127, at the
+// scale with the least rounding error over the row, each weight's error
+// counted at its input's range: an omega weight's error is multiplied by up
+// to omega_range, so it decides where the others would not
+static float row_scale(const float* w, const float* range, int n)
+{
+    float m = 0.f;
+    for (int j = 0; j < n; ++j)
+        m = fmaxf(m, fabsf(w[j]));
+    if (m <= 1e-12f)
+        return 1.f;
+    float best = 127.f / m, best_err = INFINITY;
+    for (int k = 0; k < 32; ++k)
+    {
+        float s = (127.f - (float)k) / m;
+        float err = 0.f;
+        for (int j = 0; j < n; ++j)
+            err += fabsf(rintf(w[j] * s) / s - w[j]) * range[j];
+        if (err < best_err)
+        {
+            best_err = err;
+            best = s;
+        }
+    }
+    return best;
+}
+
+// largest row scale that keeps |b| * s * act_scale within 2^30, leaving the
+// int32 accumulator room for the products (< 12 * 127 * 32767); only binds
+// when the weights are tiny next to the bias, so rounding them away is harmless
+static float bias_scale_cap(float b, float act_scale)
+{
+    float ab = fabsf(b) * act_scale;
+    return ab > 0.f ? 1073741824.f / ab : INFINITY;
+}
+
+void quant_genome(const Genome* g, QGenome* q, float omega_range)
+{
+    if (!g || !q)
+        return;
+    pthread_once(&tanh_lut_once, build_tanh_lut);
+    memset(q, 0, sizeof(*q));
+
+    // one activation scale for the inputs and the hidden outputs, so the
+    // weights need no folded input range and every term of a row shares the
+    // accumulator scale; omega is the only input beyond [-1, 1]
+    float range = omega_range > 1.f ? omega_range : 1.f;
+    q->act_scale = 32767.f / range;
+    q->act_mul = (int32_t)lrintf(65536.f / range);
+
+    float in_range[GA_INPUTS + GA_MAX_HIDDEN];
+    for (int j = 0; j < GA_INPUTS + GA_MAX_HIDDEN; ++j)
+        in_range[j] = 1.f;
+    in_range[3] = range;
+
+    int hidden = g->hidden;
+    if (hidden < 0)
+        hidden = 0;
+    if (hidden > GA_MAX_HIDDEN)
+        hidden = GA_MAX_HIDDEN;
+    q->hidden = hidden;
+
+    for (int i = 0; i < hidden; ++i)
+    {
+        float s_h = fminf(row_scale(g->w_in[i], in_range, GA_INPUTS), bias_scale_cap(g->b_h[i], q->act_scale));
+        for (int j = 0; j < GA_INPUTS; ++j)
+            q->w_in[i][j] = q8(g->w_in[i][j] * s_h);
+        q->b_h[i] = (int32_t)lrintf(g->b_h[i] * s_h * q->act_scale);
+        q->h_mul[i] = lut_mul(s_h, q->act_scale);
+    }
+
+    // output row: direct inputs and hidden activations
+    float w_o[GA_INPUTS + GA_MAX_HIDDEN];
+    for (int j = 0; j < GA_INPUTS; ++j)
+        w_o[j] = g->w_direct[j];
+    for (int i = 0; i < hidden; ++i)
+        w_o[GA_INPUTS + i] = g->w_out[i];
+    float s_o = fminf(row_scale(w_o, in_range, GA_INPUTS + hidden), bias_scale_cap(g->b_out, q->act_scale));
+    for (int j = 0; j < GA_INPUTS; ++j)
+        q->w_direct[j] = q8(g->w_direct[j] * s_o);
+    for (int i = 0; i < hidden; ++i)
+        q->w_out[i] = q8(g->w_out[i] * s_o);
+    q->b_out = (int32_t)lrintf(g->b_out * s_o * q->act_scale);
+    q->o_mul = lut_mul(s_o, q->act_scale);
+}
+
+float quant_eval_network(const QGenome* q, const float in[GA_INPUTS])
+{
+    int16_t x[GA_INPUTS];
+    for (int j = 0; j < GA_INPUTS; ++j)
+        x[j] = q16(in[j] * q->act_scale);
+
+    // all GA_MAX_HIDDEN rows are computed; inactive ones have zero weights
+    int32_t acc[GA_MAX_HIDDEN];
+#ifdef QUANT_USE_AVX2
+    // int8 rows widened to int16, pmaddwd against the broadcast inputs:
+    // two partial sums per row, paired by hadd (rows 0 1 4 5 | 2 3 6 7)
+    int64_t xword;
+    memcpy(&xword, x, sizeof(xword));
+    __m256i xv = _mm256_set1_epi64x(xword);
+    __m256i w03 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)q->w_in[0]));
+    __m256i w47 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)q->w_in[4]));
+    __m256i vacc = _mm256_hadd_epi32(_mm256_madd_epi16(w03, xv), _mm256_madd_epi16(w47, xv));
+    vacc = _mm256_permute4x64_epi64(vacc, _MM_SHUFFLE(3, 1, 2, 0));
+    vacc = _mm256_add_epi32(vacc, _mm256_loadu_si256((const __m256i*)q->b_h));
+    _mm256_storeu_si256((__m256i*)acc, vacc);
+#else
+    for (int i = 0; i < GA_MAX_HIDDEN; ++i)
+    {
+        int32_t sum = q->b_h[i];
+        for (int j = 0; j < GA_INPUTS; ++j)
+            sum += (int32_t)q->w_in[i][j] * (int32_t)x[j];
+        acc[i] = sum;
+    }
+#endif
+
+    int32_t out = q->b_out;
+    for (int j = 0; j < GA_INPUTS; ++j)
+        out += (int32_t)q->w_direct[j] * (int32_t)x[j];
+    for (int i = 0; i < GA_MAX_HIDDEN; ++i)
+    {
+        int32_t t = lut_tanh(acc[i], q->h_mul[i]);
+        int32_t h = (t * q->act_mul + (1 << 15)) >> 16; // Q15 -> activation scale
+        out += (int32_t)q->w_out[i] * h;
+    }
+    return (float)lut_tanh(out, q->o_mul) * (1.f / 32767.f);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "ga.h"
+
+// Fixed-point inference path.
+// Weights are int8 with one scale per row (each hidden unit, and the output),
+// activations int16 at one scale shared by the inputs and the hidden outputs,
+// so a row is an int16 x int8 -> int32 dot product (pmaddwd with AVX2) and its
+// accumulator goes to the tanh table through the row's own multiplier.
+// The int16 activations keep omega, the one input with a range beyond [-1, 1],
+// at full resolution; each row scale is picked for the least rounding error
+// weighted by the input ranges.
+// tanh is read from a Q15 table covering [-QUANT_TANH_RANGE, QUANT_TANH_RANGE].
+
+#define QUANT_TANH_LUT_SIZE 2048
+#define QUANT_TANH_RANGE    4.f
+
+void  quant_genome(const Genome* g, QGenome* q, float omega_range);
+float quant_eval_network(const QGenome* q, const float in[GA_INPUTS]);
@@ -0,0 +1,26 @@
+#include "reward.h"
+
+#include <string.h>
+
+#define GA_REWARD_NAME(id, fn, name) name,
+static const char* const reward_names[GA_REWARD_COUNT] = { GA_REWARD_LIST(GA_REWARD_NAME) };
+#undef GA_REWARD_NAME
+
+int reward_find(const char* name)
+{
+    if (!name)
+        return -1;
+    for (int i = 0; i < GA_REWARD_COUNT; ++i)
+    {
+        if (strcmp(reward_names[i], name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+const char* reward_name(int id)
+{
+    if (id < 0 || id >= GA_REWARD_COUNT)
+        return "?";
+    return reward_names[id];
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <math.h>
+
+#include "ga.h"
+
+// Reward plug-ins.
+// Every variant is a static inline step function with the same signature,
+// called from physics_step (physics.h); the rollout kernels (ga.c, sweep.c,
+// env.c, sparse.c) are stamped out once per entry of GA_REWARD_LIST, so the
+// reward is inlined into its own kernel and selected once per rollout batch,
+// never per step. cos_theta comes from the caller's trig (physics.h); keep
+// the arms of the selects free of arithmetic so the SoA lane loops stay
+// branchless.
+//
+// Adding a variant: write reward_<fn>() below, same rules, and add one X(...) line.
+
+#define GA_REWARD_LIST(X)               \
+    X(UPRIGHT, upright, "upright")      \
+    X(HEIGHT,  height,  "height")       \
+    X(GENTLE,  gentle,  "gentle")
+
+#define GA_REWARD_ENUM(id, fn, name) GA_REWARD_##id,
+enum { GA_REWARD_LIST(GA_REWARD_ENUM) GA_REWARD_COUNT };
+#undef GA_REWARD_ENUM
+
+#ifndef GA_ALWAYS_INLINE
+#if defined(__GNUC__)
+#define GA_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define GA_ALWAYS_INLINE inline
+#endif
+#endif
+
+// shared by the variants: keep the base near the center, penalize base speed and spin
+static GA_ALWAYS_INLINE float reward_motion_penalty(const GAContext* ga, float fit, float omega,
+                                                    float pivot_x, float pivot_v, float dt)
+{
+    const float center_x = ga->track_left + ga->track_width * 0.5f;
+    float base_dist = fabsf(pivot_x - center_x) / (ga->track_width * 0.5f);
+    base_dist = base_dist > 1.f ? 1.f : base_dist;
+    fit -= dt * 0.15f * base_dist;
+    fit -= dt * 0.05f * (fabsf(pivot_v) / ga->max_base_speed);
+    fit -= dt * 0.08f * fabsf(omega);
+    return fit < 0.f ? 0.f : fit;
+}
+
+// original reward: time above the threshold + bonus near angle 0, penalty on falling
+static GA_ALWAYS_INLINE float reward_upright(const GAContext* ga, float fit, float* above, float theta,
+                                             float cos_theta, float omega, float pivot_x, float pivot_v,
+                                             float control, float dt)
+{
+    (void)control;
+    const float center_range = 0.35f;             // radians where bonus is strongest
+    const float center_bonus = ga->reward_bonus;  // weight of the bonus
+    const float drop_penalty = ga->reward_drop;   // penalty when leaving the threshold
+    int up = cos_theta < ga->upright_threshold;
+    float closeness = 1.f - (fabsf(theta) / center_range);
+    closeness = closeness < 0.f ? 0.f : closeness;
+    closeness = closeness > 1.f ? 1.f : closeness;
+    float fit_up = fit + dt;
+    fit_up += dt * center_bonus * closeness;
+    float fit_drop = fit - drop_penalty;
+    float fit_down = (*above > 0.f) ? fit_drop : fit;
+    fit = up ? fit_up : fit_down;
+    float above_up = *above + dt;
+    *above = up ? above_up : 0.f;
+    return reward_motion_penalty(ga, fit, omega, pivot_x, pivot_v, dt);
+}
+
+// dense shaping for swing-up: bob height every step, no threshold cliff
+static GA_ALWAYS_INLINE float reward_height(const GAContext* ga, float fit, float* above, float theta,
+                                            float cos_theta, float omega, float pivot_x, float pivot_v,
+                                            float control, float dt)
+{
+    (void)theta;
+    (void)control;
+    float height = 0.5f * (1.f - cos_theta); // 0 hanging, 1 upright
+    int up = cos_theta < ga->upright_threshold;
+    fit += dt * height * height;
+    float above_up = *above + dt;
+    *above = up ? above_up : 0.f;
+    return reward_motion_penalty(ga, fit, omega, pivot_x, pivot_v, dt);
+}
+
+// upright reward with a control-effort cost, favors smooth base commands
+static GA_ALWAYS_INLINE float reward_gentle(const GAContext* ga, float fit, float* above, float theta,
+                                            float cos_theta, float omega, float pivot_x, float pivot_v,
+                                            float control, float dt)
+{
+    float effort = fabsf(control) / ga->max_base_speed;
+    fit = reward_upright(ga, fit, above, theta, cos_theta, omega, pivot_x, pivot_v, control, dt);
+    fit -= dt * ga->reward_effort * effort;
+    return fit < 0.f ? 0.f : fit;
+}
+
+// runtime registry: name <-> GA_REWARD_* id
+int         reward_find(const char* name);
+const char* reward_name(int id);
@@ -0,0 +1,475 @@
+#include "sparse.h"
+#include "physics.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SPARSE_CHUNK 8 // genomes per grab of the shared counter
+
+struct SparsePopulation
+{
+    GAContext      ga;        // environment, reward and rates
+    int            size;
+    SparseGenome*  genomes;
+    SparseProgram* programs;
+    SparseGenome   champion;
+    float          champion_fitness;
+    int            generation;
+    unsigned       rng;
+};
+
+typedef struct
+{
+    SparsePopulation* sp;
+    float             dt;
+    int               steps;
+    atomic_int        next;
+    atomic_llong      busy_ns;  // thread CPU time over all workers
+} SparseJob;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static long long thread_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (long long)ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+static unsigned sparse_next(unsigned* s)
+{
+    unsigned x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+static float sparse_frand(unsigned* s, float a, float b)
+{
+    return a + (b - a) * ((float)(sparse_next(s) >> 8) * (1.f / 16777216.f));
+}
+
+static int add_conn(SparseGenome* s, int from, int to, float weight)
+{
+    if (s->conns >= SPARSE_MAX_CONNS)
+        return 0;
+    SparseConn* c = &s->conn[s->conns++];
+    c->from = (uint8_t)from;
+    c->to = (uint8_t)to;
+    c->enabled = 1;
+    c->weight = weight;
+    return 1;
+}
+
+void sparse_from_dense(const Genome* g, SparseGenome* s)
+{
+    memset(s, 0, sizeof(*s));
+    s->nodes = SPARSE_OUTPUT + 1 + g->hidden;
+    s->bias[SPARSE_OUTPUT] = g->b_out;
+    for (int j = 0; j < GA_INPUTS; ++j)
+        add_conn(s, j, SPARSE_OUTPUT, g->w_direct[j]);
+    for (int i = 0; i < g->hidden; ++i)
+    {
+        int node = SPARSE_OUTPUT + 1 + i;
+        s->bias[node] = g->b_h[i];
+        for (int j = 0; j < GA_INPUTS; ++j)
+            add_conn(s, j, node, g->w_in[i][j]);
+        add_conn(s, node, SPARSE_OUTPUT, g->w_out[i]);
+    }
+    s->fitness = g->fitness;
+}
+
+// the inputs wired to the output and to one hidden node, as a dense genome
+// with one hidden unit
+void sparse_random(SparseGenome* s, unsigned* rng)
+{
+    memset(s, 0, sizeof(*s));
+    s->nodes = SPARSE_OUTPUT + 2;
+    int hidden = SPARSE_OUTPUT + 1;
+    s->bias[SPARSE_OUTPUT] = sparse_frand(rng, -0.5f, 0.5f);
+    s->bias[hidden] = sparse_frand(rng, -0.5f, 0.5f);
+    for (int j = 0; j < GA_INPUTS; ++j)
+    {
+        add_conn(s, j, SPARSE_OUTPUT, sparse_frand(rng, -1.f, 1.f));
+        add_conn(s, j, hidden, sparse_frand(rng, -1.f, 1.f));
+    }
+    add_conn(s, hidden, SPARSE_OUTPUT, sparse_frand(rng, -1.f, 1.f));
+}
+
+void sparse_compile(const SparseGenome* s, SparseProgram* p)
+{
+    // live: the output and every node with an enabled path to it
+    uint8_t live[SPARSE_MAX_NODES] = {0};
+    live[SPARSE_OUTPUT] = 1;
+    for (int changed = 1; changed;)
+    {
+        changed = 0;
+        for (int k = 0; k < s->conns; ++k)
+        {
+            const SparseConn* c = &s->conn[k];
+            if (c->enabled && live[c->to] && !live[c->from])
+            {
+                live[c->from] = 1;
+                changed = 1;
+            }
+        }
+    }
+
+    // Kahn's order over the live non-input nodes; the output is the only sink
+    int pending[SPARSE_MAX_NODES] = {0};
+    for (int k = 0; k < s->conns; ++k)
+    {
+        const SparseConn* c = &s->conn[k];
+        if (c->enabled && live[c->to] && c->from >= GA_INPUTS)
+            pending[c->to]++;
+    }
+    uint8_t order[SPARSE_MAX_NODES];
+    int head = 0, tail = 0;
+    for (int v = GA_INPUTS; v < s->nodes; ++v)
+    {
+        if (live[v] && pending[v] == 0)
+            order[tail++] = (uint8_t)v;
+    }
+    while (head < tail)
+    {
+        int v = order[head++];
+        for (int k = 0; k < s->conns; ++k)
+        {
+            const SparseConn* c = &s->conn[k];
+            if (c->enabled && c->from == v && live[c->to] && --pending[c->to] == 0)
+                order[tail++] = c->to;
+        }
+    }
+
+    p->ops = 0;
+    p->live = 0;
+    for (int o = 0; o < tail; ++o)
+    {
+        int v = order[o];
+        p->node[p->ops] = (uint8_t)v;
+        p->bias[p->ops] = s->bias[v];
+        p->first[p->ops] = (uint8_t)p->live;
+        for (int k = 0; k < s->conns; ++k)
+        {
+            const SparseConn* c = &s->conn[k];
+            if (c->enabled && c->to == v)
+            {
+                p->src[p->live] = c->from;
+                p->weight[p->live] = c->weight;
+                p->live++;
+            }
+        }
+        p->ops++;
+    }
+    p->first[p->ops] = (uint8_t)p->live;
+}
+
+float sparse_eval(const SparseProgram* p, const float in[GA_INPUTS])
+{
+    float v[SPARSE_MAX_NODES];
+    for (int j = 0; j < GA_INPUTS; ++j)
+        v[j] = in[j];
+    v[SPARSE_OUTPUT] = 0.f;
+    for (int k = 0; k < p->ops; ++k)
+    {
+        float sum = p->bias[k];
+        for (int j = p->first[k]; j < p->first[k + 1]; ++j)
+            sum += p->weight[j] * v[p->src[j]];
+        v[p->node[k]] = tanhf(sum);
+    }
+    return v[SPARSE_OUTPUT];
+}
+
+static float sparse_policy(const void* p, const float in[GA_INPUTS])
+{
+    return sparse_eval((const SparseProgram*)p, in);
+}
+
+// step_agent (ga.c) with the program in place of eval_network
+static GA_ALWAYS_INLINE float rollout(const GAContext* ga, const SparseProgram* p, float dt, int steps,
+                                      const int reward)
+{
+    GAAgent a;
+    physics_reset_agent(ga, &a);
+    for (int s = 0; s < steps; ++s)
+        physics_agent_step(ga, &a, sparse_policy, p, dt, reward);
+    return a.fitness;
+}
+
+float sparse_rollout(const GAContext* ga, const SparseProgram* p, float dt, int steps)
+{
+    switch (ga->reward)
+    {
+#define SPARSE_REWARD_DISPATCH(id, fn, name) \
+        case GA_REWARD_##id:                 \
+            return rollout(ga, p, dt, steps, GA_REWARD_##id);
+        GA_REWARD_LIST(SPARSE_REWARD_DISPATCH)
+#undef SPARSE_REWARD_DISPATCH
+    }
+    return 0.f;
+}
+
+void sparse_crossover(const SparseGenome* a, const SparseGenome* b, SparseGenome* child, unsigned* rng)
+{
+    *child = *a;
+    child->fitness = 0.f;
+    for (int k = 0; k < child->conns; ++k)
+    {
+        SparseConn* c = &child->conn[k];
+        for (int m = 0; m < b->conns; ++m)
+        {
+            if (b->conn[m].from == c->from && b->conn[m].to == c->to)
+            {
+                if (sparse_next(rng) & 1u)
+                    c->weight = b->conn[m].weight;
+                break;
+            }
+        }
+    }
+    int shared = a->nodes < b->nodes ? a->nodes : b->nodes;
+    for (int v = SPARSE_OUTPUT; v < shared; ++v)
+    {
+        if (sparse_next(rng) & 1u)
+            child->bias[v] = b->bias[v];
+    }
+}
+
+// any connection, enabled or not, so re-enabling one never closes a cycle
+static int reaches(const SparseGenome* s, int from, int target)
+{
+    uint8_t seen[SPARSE_MAX_NODES] = {0};
+    uint8_t stack[SPARSE_MAX_NODES];
+    int top = 0;
+    stack[top++] = (uint8_t)from;
+    seen[from] = 1;
+    while (top > 0)
+    {
+        int v = stack[--top];
+        if (v == target)
+            return 1;
+        for (int k = 0; k < s->conns; ++k)
+        {
+            int to = s->conn[k].to;
+            if (s->conn[k].from == v && !seen[to])
+            {
+                seen[to] = 1;
+                stack[top++] = (uint8_t)to;
+            }
+        }
+    }
+    return 0;
+}
+
+static void mutate_new_conn(SparseGenome* s, unsigned* rng)
+{
+    for (int attempt = 0; attempt < 16; ++attempt)
+    {
+        int from = (int)(sparse_next(rng) % (unsigned)s->nodes);
+        int to = SPARSE_OUTPUT + (int)(sparse_next(rng) % (unsigned)(s->nodes - SPARSE_OUTPUT));
+        if (from == SPARSE_OUTPUT || from == to)
+            continue;
+        int existing = -1;
+        for (int k = 0; k < s->conns; ++k)
+        {
+            if (s->conn[k].from == from && s->conn[k].to == to)
+                existing = k;
+        }
+        if (existing >= 0)
+        {
+            if (s->conn[existing].enabled)
+                continue;
+            s->conn[existing].enabled = 1;
+            return;
+        }
+        if (reaches(s, to, from))
+            continue;
+        add_conn(s, from, to, sparse_frand(rng, -1.f, 1.f));
+        return;
+    }
+}
+
+static void mutate_new_node(SparseGenome* s, unsigned* rng)
+{
+    if (s->nodes >= SPARSE_MAX_NODES || s->conns + 2 > SPARSE_MAX_CONNS || s->conns == 0)
+        return;
+    int k = (int)(sparse_next(rng) % (unsigned)s->conns);
+    SparseConn split = s->conn[k];
+    if (!split.enabled)
+        return;
+    s->conn[k].enabled = 0;
+    int node = s->nodes++;
+    s->bias[node] = 0.f;
+    add_conn(s, split.from, node, 1.f);
+    add_conn(s, node, split.to, split.weight);
+}
+
+void sparse_mutate(SparseGenome* s, float sigma, float prob, unsigned* rng)
+{
+    for (int k = 0; k < s->conns; ++k)
+    {
+        if (sparse_frand(rng, 0.f, 1.f) < prob)
+            s->conn[k].weight += sparse_frand(rng, -sigma, sigma);
+    }
+    for (int v = SPARSE_OUTPUT; v < s->nodes; ++v)
+    {
+        if (sparse_frand(rng, 0.f, 1.f) < prob)
+            s->bias[v] += sparse_frand(rng, -sigma, sigma);
+    }
+    float r = sparse_frand(rng, 0.f, 1.f);
+    if (r < 0.15f)
+    {
+        mutate_new_conn(s, rng);
+    }
+    else if (r < 0.20f)
+    {
+        mutate_new_node(s, rng);
+    }
+    else if (r < 0.25f && s->conns > 0)
+    {
+        SparseConn* c = &s->conn[sparse_next(rng) % (unsigned)s->conns];
+        c->enabled = !c->enabled;
+    }
+}
+
+SparsePopulation* sparse_population_create(const GAContext* ga, int size, unsigned seed)
+{
+    if (!ga || size < 2)
+        return NULL;
+    SparsePopulation* sp = calloc(1, sizeof(SparsePopulation));
+    if (!sp)
+        return NULL;
+    sp->ga = *ga;
+    sp->ga.population = NULL;
+    sp->ga.agents = NULL;
+    sp->size = size;
+    sp->genomes = calloc((size_t)size, sizeof(SparseGenome));
+    sp->programs = calloc((size_t)size, sizeof(SparseProgram));
+    if (!sp->genomes || !sp->programs)
+    {
+        sparse_population_free(sp);
+        return NULL;
+    }
+    sp->rng = seed ? seed : 0x9E3779B9u;
+    sp->champion_fitness = -1e9f;
+    for (int i = 0; i < size; ++i)
+    {
+        sparse_random(&sp->genomes[i], &sp->rng);
+        sparse_compile(&sp->genomes[i], &sp->programs[i]);
+    }
+    return sp;
+}
+
+void sparse_population_free(SparsePopulation* sp)
+{
+    if (!sp)
+        return;
+    free(sp->genomes);
+    free(sp->programs);
+    free(sp);
+}
+
+static void* eval_worker(void* arg)
+{
+    SparseJob* job = (SparseJob*)arg;
+    SparsePopulation* sp = job->sp;
+    long long t0 = thread_ns();
+    for (;;)
+    {
+        int start = atomic_fetch_add(&job->next, SPARSE_CHUNK);
+        if (start >= sp->size)
+            break;
+        int end = start + SPARSE_CHUNK < sp->size ? start + SPARSE_CHUNK : sp->size;
+        for (int i = start; i < end; ++i)
+            sp->genomes[i].fitness = sparse_rollout(&sp->ga, &sp->programs[i], job->dt, job->steps);
+    }
+    atomic_fetch_add(&job->busy_ns, thread_ns() - t0);
+    return NULL;
+}
+
+static int cmp_sparse_desc(const void* a, const void* b)
+{
+    float x = ((const SparseGenome*)a)->fitness, y = ((const SparseGenome*)b)->fitness;
+    return (x < y) - (x > y);
+}
+
+// one generation: evaluate, rank, keep the elites, breed the rest and compile them
+void sparse_population_step(SparsePopulation* sp, float dt, SparseStats* stats)
+{
+    if (!sp)
+        return;
+    int steps = (int)ceilf(sp->ga.eval_duration / dt);
+    steps = steps < 1 ? 1 : steps;
+
+    double t0 = now_sec();
+    SparseJob job;
+    job.sp = sp;
+    job.dt = dt;
+    job.steps = steps;
+    atomic_init(&job.next, 0);
+    atomic_init(&job.busy_ns, 0);
+    pthread_t tid[GA_THREAD_COUNT];
+    int started = 0;
+    int threads = (sp->size + SPARSE_CHUNK - 1) / SPARSE_CHUNK;
+    threads = threads < GA_THREAD_COUNT ? threads : GA_THREAD_COUNT;
+    for (int t = 1; t < threads; ++t)
+    {
+        if (pthread_create(&tid[started], NULL, eval_worker, &job) != 0)
+            break;
+        started++;
+    }
+    eval_worker(&job);
+    for (int t = 0; t < started; ++t)
+        pthread_join(tid[t], NULL);
+    double eval = now_sec() - t0;
+
+    // the programs still match the genomes here, read them before breeding
+    double live = 0.0, conns = 0.0;
+    for (int i = 0; i < sp->size; ++i)
+    {
+        live += sp->programs[i].live;
+        conns += sp->genomes[i].conns;
+    }
+
+    qsort(sp->genomes, (size_t)sp->size, sizeof(SparseGenome), cmp_sparse_desc);
+    if (sp->genomes[0].fitness > sp->champion_fitness)
+    {
+        sp->champion = sp->genomes[0];
+        sp->champion_fitness = sp->genomes[0].fitness;
+    }
+    sp->generation++;
+    if (stats)
+    {
+        stats->generation = sp->generation;
+        stats->best_fitness = sp->genomes[0].fitness;
+        stats->champion_fitness = sp->champion_fitness;
+        stats->mean_live = (float)(live / sp->size);
+        stats->mean_conns = (float)(conns / sp->size);
+        stats->ns_per_step = (float)((double)atomic_load(&job.busy_ns) / ((double)sp->size * steps));
+        stats->eval_ms = (float)(eval * 1e3);
+    }
+
+    int elite = (int)(sp->size * sp->ga.elite_fraction);
+    elite = elite < 1 ? 1 : elite;
+    for (int i = elite; i < sp->size; ++i)
+    {
+        int a = (int)(sparse_next(&sp->rng) % (unsigned)elite);
+        int b = (int)(sparse_next(&sp->rng) % (unsigned)elite);
+        const SparseGenome* fitter = a <= b ? &sp->genomes[a] : &sp->genomes[b]; // ranked: lower index is fitter
+        const SparseGenome* other = a <= b ? &sp->genomes[b] : &sp->genomes[a];
+        sparse_crossover(fitter, other, &sp->genomes[i], &sp->rng);
+        sparse_mutate(&sp->genomes[i], sp->ga.mutation_sigma, sp->ga.mutation_prob, &sp->rng);
+    }
+    for (int i = 0; i < sp->size; ++i)
+        sparse_compile(&sp->genomes[i], &sp->programs[i]);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "ga.h"
+
+// Sparse genome: an explicit connection list over numbered nodes, any acyclic
+// topology. Nodes 0 .. GA_INPUTS - 1 are the network inputs, SPARSE_OUTPUT the
+// output, hidden nodes follow; every non-input node has a bias and tanh.
+// Connections carry an enable flag, so structural mutations are real: a new
+// connection links two nodes that were not linked, a new node splits an
+// enabled connection (in weight 1, out weight the old one), and a connection
+// can be disabled and re-enabled later.
+//
+// sparse_compile turns a genome into a SparseProgram once, after breeding:
+// the nodes the output depends on through enabled connections, in topological
+// order, each with its incoming connections as a flat (source, weight) list.
+// A rollout step runs the program, so its cost is the number of live
+// connections, not the size of the genome.
+
+#define SPARSE_OUTPUT    GA_INPUTS
+#define SPARSE_MAX_NODES 32
+#define SPARSE_MAX_CONNS 128
+
+typedef struct
+{
+    uint8_t from;
+    uint8_t to;
+    uint8_t enabled;
+    float   weight;
+} SparseConn;
+
+typedef struct
+{
+    int        nodes;   // inputs, output, hidden
+    int        conns;
+    float      bias[SPARSE_MAX_NODES];
+    SparseConn conn[SPARSE_MAX_CONNS];
+    float      fitness;
+} SparseGenome;
+
+typedef struct
+{
+    int     ops;                          // nodes to compute, output last
+    int     live;                         // connections in the program
+    uint8_t node[SPARSE_MAX_NODES];       // node written by each op
+    uint8_t first[SPARSE_MAX_NODES + 1];  // op k reads src/weight[first[k] .. first[k + 1])
+    uint8_t src[SPARSE_MAX_CONNS];
+    float   bias[SPARSE_MAX_NODES];
+    float   weight[SPARSE_MAX_CONNS];
+} SparseProgram;
+
+// the dense network as a connection list, active hidden rows only
+void  sparse_from_dense(const Genome* g, SparseGenome* s);
+void  sparse_random(SparseGenome* s, unsigned* rng);
+void  sparse_compile(const SparseGenome* s, SparseProgram* p);
+float sparse_eval(const SparseProgram* p, const float in[GA_INPUTS]);
+// fitness of the program over the rollout of ga_rollout (same physics, reward, control hold)
+float sparse_rollout(const GAContext* ga, const SparseProgram* p, float dt, int steps);
+
+// connections aligned on (from, to); the fitter parent `a` gives the structure
+void  sparse_crossover(const SparseGenome* a, const SparseGenome* b, SparseGenome* child, unsigned* rng);
+// weight perturbation at the GA's sigma/prob plus one structural mutation at most
+void  sparse_mutate(SparseGenome* s, float sigma, float prob, unsigned* rng);
+
+// generational GA over sparse genomes with the GA's environment and rates
+typedef struct
+{
+    int   generation;
+    float best_fitness;
+    float champion_fitness;
+    float mean_live;        // live connections per compiled program
+    float mean_conns;       // connections in the genomes, enabled or not
+    float ns_per_step;      // thread time per genome per rollout step
+    float eval_ms;
+} SparseStats;
+
+typedef struct SparsePopulation SparsePopulation;
+
+SparsePopulation* sparse_population_create(const GAContext* ga, int size, unsigned seed);
+void              sparse_population_free(SparsePopulation* sp);
+void              sparse_population_step(SparsePopulation* sp, float dt, SparseStats* stats);
@@ -0,0 +1,491 @@
+#include "sweep.h"
+#include "physics.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct
+{
+    float length[SWEEP_LANES];
+    float gravity[SWEEP_LANES];
+    float base_k[SWEEP_LANES];
+    float base_d[SWEEP_LANES];
+    float damping[SWEEP_LANES];
+
+    float slider[SWEEP_LANES];
+    float pivot_x[SWEEP_LANES];
+    float pivot_v[SWEEP_LANES];
+    float theta[SWEEP_LANES];
+    float omega[SWEEP_LANES];
+    float above[SWEEP_LANES];
+    float fitness[SWEEP_LANES];
+    float control[SWEEP_LANES]; // held command
+    int   hold[SWEEP_LANES];
+} SweepLanes;
+
+typedef struct
+{
+    const GAContext*   ga;
+    const Genome*      genomes;
+    const SweepConfig* cfg;
+    SweepResult*       r;
+    int                per_genome;
+    int                batches_per_genome;
+    int                steps;
+    atomic_int         next_job;
+    int                job_count;
+} SweepJob;
+
+static const char* const param_names[SWEEP_PARAM_COUNT] = {
+    "length", "gravity", "base_k", "base_d", "damping", "theta0", "omega0"
+};
+
+const char* sweep_param_name(int param)
+{
+    if (param < 0 || param >= SWEEP_PARAM_COUNT)
+        return "?";
+    return param_names[param];
+}
+
+static unsigned sweep_rand(unsigned* s)
+{
+    unsigned x = *s;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *s = x;
+    return x;
+}
+
+static float sweep_frand(unsigned* s)
+{
+    return (float)(sweep_rand(s) >> 8) * (1.f / 16777216.f);
+}
+
+// Same step and reward as ga_step_agent (physics.h), one genome across
+// SWEEP_LANES lanes, written lane-innermost so the lane loops vectorize. One
+// copy per reward.
+static GA_ALWAYS_INLINE void rollout_lanes(const GAContext* ga, const Genome* g, SweepLanes* L, float dt, int steps,
+                                           const int reward)
+{
+    const int hidden = g->hidden;
+    const int period = ga->control_period;
+
+    for (int s = 0; s < steps; ++s)
+    {
+        float in[GA_INPUTS][SWEEP_LANES];
+        float h[GA_MAX_HIDDEN][SWEEP_LANES];
+        // the network runs for all lanes when any is due, the others keep their command
+        int due = 0;
+        for (int l = 0; l < SWEEP_LANES; ++l)
+            due |= L->hold[l] <= 0;
+        if (due)
+        {
+            for (int l = 0; l < SWEEP_LANES; ++l)
+            {
+                float x[GA_INPUTS];
+                physics_inputs(L->slider[l], L->theta[l], L->omega[l], x, PHYSICS_VMATH);
+                for (int j = 0; j < GA_INPUTS; ++j)
+                    in[j][l] = x[j];
+            }
+            // the sums of eval_network in the same order, unrolled over the inputs
+            for (int i = 0; i < hidden; ++i)
+            {
+                for (int l = 0; l < SWEEP_LANES; ++l)
+                {
+                    float sum = g->b_h[i] + g->w_in[i][0] * in[0][l] + g->w_in[i][1] * in[1][l]
+                                + g->w_in[i][2] * in[2][l] + g->w_in[i][3] * in[3][l];
+                    h[i][l] = vmath_tanhf(sum);
+                }
+            }
+            float o[SWEEP_LANES];
+            for (int l = 0; l < SWEEP_LANES; ++l)
+                o[l] = g->b_out + g->w_direct[0] * in[0][l] + g->w_direct[1] * in[1][l]
+                       + g->w_direct[2] * in[2][l] + g->w_direct[3] * in[3][l];
+            for (int i = 0; i < hidden; ++i)
+            {
+                for (int l = 0; l < SWEEP_LANES; ++l)
+                    o[l] += g->w_out[i] * h[i][l];
+            }
+            for (int l = 0; l < SWEEP_LANES; ++l)
+            {
+                float c = vmath_tanhf(o[l]) * ga->max_base_speed;
+                L->control[l] = L->hold[l] <= 0 ? c : L->control[l];
+            }
+        }
+        for (int l = 0; l < SWEEP_LANES; ++l)
+            L->hold[l] = L->hold[l] > 0 ? L->hold[l] - 1 : period - 1;
+
+        for (int l = 0; l < SWEEP_LANES; ++l)
+        {
+            PhysicsBody b = {L->length[l], L->gravity[l], L->base_k[l], L->base_d[l], L->damping[l]};
+            PhysicsState st = {L->slider[l], L->pivot_x[l], L->pivot_v[l], L->theta[l], L->omega[l], L->above[l],
+                               L->fitness[l]};
+            physics_step(ga, &b, &st, L->control[l], dt, reward, PHYSICS_VMATH);
+            L->slider[l] = st.slider;
+            L->pivot_x[l] = st.pivot_x;
+            L->pivot_v[l] = st.pivot_v;
+            L->theta[l] = st.theta;
+            L->omega[l] = st.omega;
+            L->above[l] = st.above;
+            L->fitness[l] = st.fitness;
+        }
+    }
+}
+
+#define SWEEP_REWARD_KERNEL(id, fn, name)                                                                  \
+    static void rollout_lanes_##fn(const GAContext* ga, const Genome* g, SweepLanes* L, float dt, int steps) \
+    {                                                                                                      \
+        rollout_lanes(ga, g, L, dt, steps, GA_REWARD_##id);                                                \
+    }
+GA_REWARD_LIST(SWEEP_REWARD_KERNEL)
+#undef SWEEP_REWARD_KERNEL
+
+static void sweep_rollout_lanes(const GAContext* ga, const Genome* g, SweepLanes* L, float dt, int steps)
+{
+    switch (ga->reward)
+    {
+#define SWEEP_REWARD_DISPATCH(id, fn, name)             \
+        case GA_REWARD_##id:                            \
+            rollout_lanes_##fn(ga, g, L, dt, steps);    \
+            break;
+        GA_REWARD_LIST(SWEEP_REWARD_DISPATCH)
+#undef SWEEP_REWARD_DISPATCH
+    }
+}
+
+void sweep_rollout_states(const GAContext* ga, const Genome* g, const GAAgent* start, int count, float dt, int steps,
+                          float* fitness, GAAgent* states)
+{
+    SweepLanes L;
+    for (int first = 0; first < count; first += SWEEP_LANES)
+    {
+        int n = count - first < SWEEP_LANES ? count - first : SWEEP_LANES;
+        for (int l = 0; l < SWEEP_LANES; ++l)
+        {
+            const GAAgent* a = &start[first + (l < n ? l : n - 1)];
+            L.length[l] = ga->length;
+            L.gravity[l] = ga->gravity;
+            L.base_k[l] = ga->base_k;
+            L.base_d[l] = ga->base_d;
+            L.damping[l] = ga->damping;
+            L.slider[l] = a->slider_value;
+            L.pivot_x[l] = a->pivot_x;
+            L.pivot_v[l] = a->pivot_v;
+            L.theta[l] = a->theta;
+            L.omega[l] = a->omega;
+            L.above[l] = a->above_time;
+            L.fitness[l] = a->fitness;
+            L.control[l] = a->last_control;
+            L.hold[l] = a->hold;
+        }
+        if (!states)
+        {
+            sweep_rollout_lanes(ga, g, &L, dt, steps);
+        }
+        else
+        {
+            // one step per call so every state can be copied out
+            for (int s = 0; s < steps; ++s)
+            {
+                sweep_rollout_lanes(ga, g, &L, dt, 1);
+                for (int l = 0; l < n; ++l)
+                {
+                    GAAgent* a = &states[(size_t)(first + l) * (size_t)steps + (size_t)s];
+                    memset(a, 0, sizeof(*a));
+                    a->slider_value = L.slider[l];
+                    a->pivot_x = L.pivot_x[l];
+                    a->pivot_v = L.pivot_v[l];
+                    a->theta = L.theta[l];
+                    a->omega = L.omega[l];
+                    a->above_time = L.above[l];
+                    a->fitness = L.fitness[l];
+                    a->last_control = L.control[l];
+                    a->hold = L.hold[l];
+                }
+            }
+        }
+        for (int l = 0; l < n; ++l)
+            fitness[first + l] = L.fitness[l];
+    }
+}
+
+static void* sweep_worker(void* arg)
+{
+    SweepJob* job = (SweepJob*)arg;
+    const GAContext* ga = job->ga;
+    SweepResult* r = job->r;
+    SweepLanes L;
+
+    for (;;)
+    {
+        int id = atomic_fetch_add(&job->next_job, 1);
+        if (id >= job->job_count)
+            break;
+        int gi = id / job->batches_per_genome;
+        int first = gi * job->per_genome + (id % job->batches_per_genome) * SWEEP_LANES;
+        int last = gi * job->per_genome + job->per_genome;
+        int n = last - first < SWEEP_LANES ? last - first : SWEEP_LANES;
+
+        for (int l = 0; l < SWEEP_LANES; ++l)
+        {
+            // tail lanes repeat the last rollout and are dropped
+            const float* p = &r->params[(size_t)(first + (l < n ? l : n - 1)) * SWEEP_PARAM_COUNT];
+            L.length[l] = p[SWEEP_PARAM_LENGTH];
+            L.gravity[l] = p[SWEEP_PARAM_GRAVITY];
+            L.base_k[l] = p[SWEEP_PARAM_BASE_K];
+            L.base_d[l] = p[SWEEP_PARAM_BASE_D];
+            L.damping[l] = p[SWEEP_PARAM_DAMPING];
+            PhysicsState s;
+            physics_reset(ga, &s);
+            L.slider[l] = s.slider;
+            L.pivot_x[l] = s.pivot_x;
+            L.pivot_v[l] = s.pivot_v;
+            L.theta[l] = p[SWEEP_PARAM_THETA0];
+            L.omega[l] = p[SWEEP_PARAM_OMEGA0];
+            L.above[l] = s.above;
+            L.fitness[l] = s.fitness;
+            L.control[l] = 0.f;
+            L.hold[l] = 0;
+        }
+        sweep_rollout_lanes(ga, &job->genomes[gi], &L, job->cfg->dt, job->steps);
+        for (int l = 0; l < n; ++l)
+            r->fitness[first + l] = L.fitness[l];
+    }
+    return NULL;
+}
+
+void sweep_default_config(const GAContext* ga, SweepConfig* cfg)
+{
+    if (!ga || !cfg)
+        return;
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->mode = SWEEP_MODE_GRID;
+    const float nominal[SWEEP_PARAM_COUNT] = {
+        ga->length, ga->gravity, ga->base_k, ga->base_d, ga->damping, -0.7f, 0.f
+    };
+    for (int p = 0; p < SWEEP_PARAM_COUNT; ++p)
+    {
+        cfg->lo[p] = nominal[p];
+        cfg->hi[p] = nominal[p];
+    }
+    cfg->lo[SWEEP_PARAM_LENGTH] = ga->length * 0.5f;
+    cfg->hi[SWEEP_PARAM_LENGTH] = ga->length * 1.5f;
+    cfg->lo[SWEEP_PARAM_GRAVITY] = ga->gravity * 0.5f;
+    cfg->hi[SWEEP_PARAM_GRAVITY] = ga->gravity * 1.5f;
+    cfg->lo[SWEEP_PARAM_THETA0] = -1.0f;
+    cfg->hi[SWEEP_PARAM_THETA0] = -0.4f;
+    cfg->x_param = SWEEP_PARAM_LENGTH;
+    cfg->y_param = SWEEP_PARAM_GRAVITY;
+    cfg->nx = 32;
+    cfg->ny = 32;
+    cfg->samples = 8;
+    cfg->dt = 1.f / 120.f;
+    cfg->duration = ga->eval_duration;
+    cfg->seed = 12345u;
+    cfg->threads = GA_THREAD_COUNT;
+}
+
+static int axis_bin(const SweepConfig* cfg, int param, int bins, float v)
+{
+    float span = cfg->hi[param] - cfg->lo[param];
+    if (span <= 0.f)
+        return 0;
+    int b = (int)floorf((v - cfg->lo[param]) / span * (float)bins);
+    return b < 0 ? 0 : (b >= bins ? bins - 1 : b);
+}
+
+// one shared set of sample points, reused for every genome
+static void fill_samples(const SweepConfig* cfg, float* params, int per_genome)
+{
+    unsigned rng = cfg->seed ? cfg->seed : 1u;
+    if (cfg->mode == SWEEP_MODE_LHS)
+    {
+        int* perm = malloc((size_t)per_genome * sizeof(int));
+        if (!perm)
+            return;
+        for (int p = 0; p < SWEEP_PARAM_COUNT; ++p)
+        {
+            for (int k = 0; k < per_genome; ++k)
+                perm[k] = k;
+            for (int k = per_genome - 1; k > 0; --k)
+            {
+                int j = (int)(sweep_rand(&rng) % (unsigned)(k + 1));
+                int t = perm[k];
+                perm[k] = perm[j];
+                perm[j] = t;
+            }
+            for (int k = 0; k < per_genome; ++k)
+            {
+                float u = ((float)perm[k] + sweep_frand(&rng)) / (float)per_genome;
+                params[(size_t)k * SWEEP_PARAM_COUNT + p] = cfg->lo[p] + (cfg->hi[p] - cfg->lo[p]) * u;
+            }
+        }
+        free(perm);
+        return;
+    }
+
+    int k = 0;
+    for (int iy = 0; iy < cfg->ny; ++iy)
+    {
+        for (int ix = 0; ix < cfg->nx; ++ix)
+        {
+            for (int s = 0; s < cfg->samples; ++s, ++k)
+            {
+                float* p = &params[(size_t)k * SWEEP_PARAM_COUNT];
+                for (int q = 0; q < SWEEP_PARAM_COUNT; ++q)
+                    p[q] = cfg->lo[q] + (cfg->hi[q] - cfg->lo[q]) * sweep_frand(&rng);
+                p[cfg->x_param] = cfg->lo[cfg->x_param]
+                                  + (cfg->hi[cfg->x_param] - cfg->lo[cfg->x_param]) * ((float)ix + 0.5f) / (float)cfg->nx;
+                p[cfg->y_param] = cfg->lo[cfg->y_param]
+                                  + (cfg->hi[cfg->y_param] - cfg->lo[cfg->y_param]) * ((float)iy + 0.5f) / (float)cfg->ny;
+            }
+        }
+    }
+}
+
+int sweep_run(const GAContext* ga, const Genome* genomes, int count, const SweepConfig* cfg, SweepResult* out)
+{
+    if (!ga || !genomes || count < 1 || !cfg || !out || cfg->nx < 1 || cfg->ny < 1 || cfg->samples < 1 || cfg->dt <= 0.f)
+        return 0;
+    memset(out, 0, sizeof(*out));
+
+    int per_genome = (cfg->mode == SWEEP_MODE_LHS) ? cfg->samples : cfg->nx * cfg->ny * cfg->samples;
+    int rollouts = per_genome * count;
+    int cells = cfg->nx * cfg->ny;
+    out->genome_count = count;
+    out->rollouts = rollouts;
+    out->nx = cfg->nx;
+    out->ny = cfg->ny;
+    out->params = malloc((size_t)rollouts * SWEEP_PARAM_COUNT * sizeof(float));
+    out->genome = malloc((size_t)rollouts * sizeof(int));
+    out->fitness = malloc((size_t)rollouts * sizeof(float));
+    out->cell_mean = calloc((size_t)cells * count, sizeof(float));
+    out->cell_min = malloc((size_t)cells * count * sizeof(float));
+    out->cell_count = calloc((size_t)cells * count, sizeof(int));
+    if (!out->params || !out->genome || !out->fitness || !out->cell_mean || !out->cell_min || !out->cell_count)
+    {
+        sweep_free(out);
+        return 0;
+    }
+
+    fill_samples(cfg, out->params, per_genome);
+    for (int gi = 1; gi < count; ++gi)
+        memcpy(&out->params[(size_t)gi * per_genome * SWEEP_PARAM_COUNT], out->params,
+               (size_t)per_genome * SWEEP_PARAM_COUNT * sizeof(float));
+    for (int k = 0; k < rollouts; ++k)
+        out->genome[k] = k / per_genome;
+
+    SweepJob job;
+    job.ga = ga;
+    job.genomes = genomes;
+    job.cfg = cfg;
+    job.r = out;
+    job.per_genome = per_genome;
+    job.batches_per_genome = (per_genome + SWEEP_LANES - 1) / SWEEP_LANES;
+    job.steps = (int)ceilf(cfg->duration / cfg->dt);
+    if (job.steps < 1)
+        job.steps = 1;
+    atomic_store(&job.next_job, 0);
+    job.job_count = job.batches_per_genome * count;
+
+    int threads = cfg->threads > 0 ? cfg->threads : 1;
+    if (threads > job.job_count)
+        threads = job.job_count;
+    pthread_t* tids = malloc((size_t)threads * sizeof(pthread_t));
+    if (!tids)
+    {
+        sweep_free(out);
+        return 0;
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    // this thread is worker 0; the jobs left by a thread that failed to start
+    // go to the others
+    int started = 0;
+    for (int t = 1; t < threads; ++t)
+    {
+        if (pthread_create(&tids[started], NULL, sweep_worker, &job) != 0)
+            break;
+        started++;
+    }
+    sweep_worker(&job);
+    for (int t = 0; t < started; ++t)
+        pthread_join(tids[t], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    free(tids);
+    out->seconds = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+    for (int c = 0; c < cells * count; ++c)
+        out->cell_min[c] = 1e9f;
+    for (int k = 0; k < rollouts; ++k)
+    {
+        const float* p = &out->params[(size_t)k * SWEEP_PARAM_COUNT];
+        int ix = axis_bin(cfg, cfg->x_param, cfg->nx, p[cfg->x_param]);
+        int iy = axis_bin(cfg, cfg->y_param, cfg->ny, p[cfg->y_param]);
+        int c = out->genome[k] * cells + iy * cfg->nx + ix;
+        out->cell_mean[c] += out->fitness[k];
+        out->cell_count[c]++;
+        if (out->fitness[k] < out->cell_min[c])
+            out->cell_min[c] = out->fitness[k];
+    }
+    for (int c = 0; c < cells * count; ++c)
+    {
+        if (out->cell_count[c] > 0)
+            out->cell_mean[c] /= (float)out->cell_count[c];
+        else
+            out->cell_min[c] = 0.f;
+    }
+    return 1;
+}
+
+int sweep_write_map(const SweepResult* r, const SweepConfig* cfg, const char* path)
+{
+    if (!r || !cfg || !path || !r->cell_mean)
+        return 0;
+    FILE* f = fopen(path, "w");
+    if (!f)
+        return 0;
+    fprintf(f, "# robustness map mode=%s genomes=%d rollouts=%d seconds=%.3f\n",
+            cfg->mode == SWEEP_MODE_LHS ? "lhs" : "grid", r->genome_count, r->rollouts, r->seconds);
+    for (int p = 0; p < SWEEP_PARAM_COUNT; ++p)
+        fprintf(f, "# %s %g %g\n", sweep_param_name(p), cfg->lo[p], cfg->hi[p]);
+    fprintf(f, "genome,ix,iy,%s,%s,count,mean_fitness,min_fitness\n",
+            sweep_param_name(cfg->x_param), sweep_param_name(cfg->y_param));
+    int cells = r->nx * r->ny;
+    for (int gi = 0; gi < r->genome_count; ++gi)
+    {
+        for (int iy = 0; iy < r->ny; ++iy)
+        {
+            for (int ix = 0; ix < r->nx; ++ix)
+            {
+                int c = gi * cells + iy * r->nx + ix;
+                float x = cfg->lo[cfg->x_param] + (cfg->hi[cfg->x_param] - cfg->lo[cfg->x_param]) * ((float)ix + 0.5f) / (float)r->nx;
+                float y = cfg->lo[cfg->y_param] + (cfg->hi[cfg->y_param] - cfg->lo[cfg->y_param]) * ((float)iy + 0.5f) / (float)r->ny;
+                fprintf(f, "%d,%d,%d,%g,%g,%d,%.4f,%.4f\n",
+                        gi, ix, iy, x, y, r->cell_count[c], r->cell_mean[c], r->cell_min[c]);
+            }
+        }
+    }
+    fclose(f);
+    return 1;
+}
+
+void sweep_free(SweepResult* r)
+{
+    if (!r)
+        return;
+    free(r->params);
+    free(r->genome);
+    free(r->fitness);
+    free(r->cell_mean);
+    free(r->cell_min);
+    free(r->cell_count);
+    memset(r, 0, sizeof(*r));
+}
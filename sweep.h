@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ga.h"
+
+// Robustness sweep: rollouts of one or more genomes over a grid or a
+// Latin-hypercube sample of physics parameters and start states.
+// Rollouts run in SoA batches of SWEEP_LANES, each lane with its own physics.
+
+#define SWEEP_LANES 16
+
+#define SWEEP_MODE_GRID 0
+#define SWEEP_MODE_LHS  1
+
+#define SWEEP_PARAM_LENGTH  0
+#define SWEEP_PARAM_GRAVITY 1
+#define SWEEP_PARAM_BASE_K  2
+#define SWEEP_PARAM_BASE_D  3
+#define SWEEP_PARAM_DAMPING 4
+#define SWEEP_PARAM_THETA0  5
+#define SWEEP_PARAM_OMEGA0  6
+#define SWEEP_PARAM_COUNT   7
+
+typedef struct
+{
+    int      mode;
+    float    lo[SWEEP_PARAM_COUNT];
+    float    hi[SWEEP_PARAM_COUNT];
+    int      x_param;   // heatmap axes
+    int      y_param;
+    int      nx;
+    int      ny;
+    int      samples;   // grid: start states per cell, LHS: total points per genome
+    float    dt;
+    float    duration;
+    unsigned seed;
+    int      threads;
+} SweepConfig;
+
+typedef struct
+{
+    int    genome_count;
+    int    rollouts;
+    int    nx;
+    int    ny;
+    double seconds;
+    float* params;     // [rollouts][SWEEP_PARAM_COUNT]
+    int*   genome;     // [rollouts]
+    float* fitness;    // [rollouts]
+    float* cell_mean;  // [genome][ny][nx]
+    float* cell_min;
+    int*   cell_count;
+} SweepResult;
+
+const char* sweep_param_name(int param);
+void  sweep_default_config(const GAContext* ga, SweepConfig* cfg);
+int   sweep_run(const GAContext* ga, const Genome* genomes, int count, const SweepConfig* cfg, SweepResult* out);
+int   sweep_write_map(const SweepResult* r, const SweepConfig* cfg, const char* path);
+void  sweep_free(SweepResult* r);
+
+// SoA lane kernel from explicit start states with the physics of `ga`;
+// states (optional) is [count][steps], only the integrated fields are set
+void  sweep_rollout_states(const GAContext* ga, const Genome* g, const GAAgent* start, int count, float dt, int steps,
+                           float* fitness, GAAgent* states);
@@ -0,0 +1,135 @@
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct
+{
+    unsigned long long start;
+    unsigned long long dur;
+    const char*        name;
+    int                arg;
+} TraceEvent;
+
+typedef struct
+{
+    _Alignas(64) atomic_ullong head; // events ever written to this track
+    _Atomic(TraceEvent*)   events;   // allocated by the writer on its first event
+    _Atomic(const char*)   name;
+    unsigned long long     base;     // head at trace_start
+} TraceTrack;
+
+atomic_int trace_enabled;
+
+static TraceTrack tracks[TRACE_MAX_TRACKS];
+static _Thread_local TraceTrack* current;
+static unsigned long long origin_ns;
+
+unsigned long long trace_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+void trace_bind(int track, const char* name)
+{
+    if (track < 0 || track >= TRACE_MAX_TRACKS)
+    {
+        current = NULL;
+        return;
+    }
+    current = &tracks[track];
+    atomic_store_explicit(&current->name, name, memory_order_relaxed);
+}
+
+void trace_record(unsigned long long start_ns, const char* name, int arg)
+{
+    TraceTrack* t = current;
+    if (!t)
+        return;
+    unsigned long long end = trace_now_ns();
+    TraceEvent* events = atomic_load_explicit(&t->events, memory_order_relaxed);
+    if (!events)
+    {
+        events = calloc(TRACE_TRACK_EVENTS, sizeof(TraceEvent));
+        if (!events)
+            return;
+        atomic_store_explicit(&t->events, events, memory_order_release);
+    }
+    // single writer per track: plain slot write, then publish
+    unsigned long long pos = atomic_load_explicit(&t->head, memory_order_relaxed);
+    TraceEvent* ev = &events[pos & (TRACE_TRACK_EVENTS - 1)];
+    ev->start = start_ns;
+    ev->dur = end - start_ns;
+    ev->name = name;
+    ev->arg = arg;
+    atomic_store_explicit(&t->head, pos + 1, memory_order_release);
+}
+
+void trace_start(void)
+{
+    for (int i = 0; i < TRACE_MAX_TRACKS; ++i)
+        tracks[i].base = atomic_load_explicit(&tracks[i].head, memory_order_acquire);
+    origin_ns = trace_now_ns();
+    atomic_store(&trace_enabled, 1);
+}
+
+void trace_stop(void)
+{
+    atomic_store(&trace_enabled, 0);
+}
+
+long trace_write(const char* path)
+{
+    FILE* f = fopen(path, "w");
+    if (!f)
+        return -1;
+    long count = 0;
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"pendule\"}}");
+    for (int i = 0; i < TRACE_MAX_TRACKS; ++i)
+    {
+        TraceTrack* t = &tracks[i];
+        unsigned long long head = atomic_load_explicit(&t->head, memory_order_acquire);
+        TraceEvent* events = atomic_load_explicit(&t->events, memory_order_acquire);
+        const char* name = atomic_load_explicit(&t->name, memory_order_relaxed);
+        if (!events || head <= t->base)
+            continue;
+        if (i >= TRACE_TRACK_WORKER)
+            fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}",
+                    i, name ? name : "worker", i - TRACE_TRACK_WORKER);
+        else
+            fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                    i, name ? name : "thread");
+        // sort rows: main loop first, then control/recorder, then workers in order
+        fprintf(f, ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"sort_index\":%d}}",
+                i, i);
+
+        unsigned long long from = t->base;
+        if (head - from > TRACE_TRACK_EVENTS)
+            from = head - TRACE_TRACK_EVENTS;
+        for (unsigned long long p = from; p < head; ++p)
+        {
+            const TraceEvent* ev = &events[p & (TRACE_TRACK_EVENTS - 1)];
+            if (ev->start < origin_ns)
+                continue;
+            double ts = (double)(ev->start - origin_ns) * 1e-3;
+            double dur = (double)ev->dur * 1e-3;
+            if (ev->arg >= 0)
+                fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+                           "\"args\":{\"n\":%d}}",
+                        ev->name, i, ts, dur, ev->arg);
+            else
+                fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                        ev->name, i, ts, dur);
+            count++;
+        }
+    }
+    fprintf(f, "\n]}\n");
+    if (fclose(f) != 0)
+        return -1;
+    return count;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdatomic.h>
+
+// Timeline tracer, dumped as Chrome trace-event JSON (chrome://tracing, Perfetto).
+// Spans are "complete" events (start + duration) appended to one buffer per
+// track without locks: a track has a single writer at a time (the main loop,
+// the control thread, GA worker #i of the current pass...), which publishes
+// each event with a release store of its counter. Threads that never called
+// trace_bind record nothing. Buffers are rings, so a long session keeps the
+// most recent TRACE_TRACK_EVENTS spans of each track.
+//
+//   unsigned long long t0 = trace_begin();
+//   ... work ...
+//   trace_end(t0, "mutate", -1);
+
+#define TRACE_TRACK_EVENTS (1 << 16)
+#define TRACE_MAX_TRACKS   32
+
+// tracks; GA workers (eval passes and steady-state) use TRACE_TRACK_WORKER + index
+#define TRACE_TRACK_MAIN     0
+#define TRACE_TRACK_CONTROL  1
+#define TRACE_TRACK_RECORDER 2
+#define TRACE_TRACK_WORKER   8
+
+extern atomic_int trace_enabled;
+
+void trace_bind(int track, const char* name); // the calling thread now writes `track`
+void trace_start(void);
+void trace_stop(void);
+// writes the spans recorded since trace_start; returns the event count, -1 on error
+long trace_write(const char* path);
+
+unsigned long long trace_now_ns(void);
+void trace_record(unsigned long long start_ns, const char* name, int arg);
+
+// `name` must be a string literal (only the pointer is stored); arg < 0 is omitted
+static inline unsigned long long trace_begin(void)
+{
+    return atomic_load_explicit(&trace_enabled, memory_order_relaxed) ? trace_now_ns() : 0;
+}
+
+static inline void trace_end(unsigned long long start_ns, const char* name, int arg)
+{
+    if (start_ns)
+        trace_record(start_ns, name, arg);
+}
@@ -0,0 +1,636 @@
+#include "traj.h"
+#include "trace.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRAJ_MAGIC      "PTRJ"
+#define TRAJ_DIR_MAGIC  "PTRX"
+#define TRAJ_VERSION    1u
+
+// encoded sizes: file header, track header, directory entry, footer
+#define TRAJ_FILE_HEADER  (16 + 4 * TRAJ_FIELDS + 16)
+#define TRAJ_TRACK_HEADER 24
+#define TRAJ_DIR_ENTRY    24
+#define TRAJ_FOOTER       12
+
+static const float traj_scales[TRAJ_FIELDS] = {
+    16.f,    // pivot_x: 1/16 px
+    10000.f, // theta: 1e-4 rad
+    1000.f,  // omega: 1e-3 rad/s
+    20.f,    // control: 0.05 px/s
+    1000.f   // fitness
+};
+
+typedef struct
+{
+    uint8_t* data;
+    size_t   size;
+    size_t   cap;
+} TrajBuf;
+
+static int buf_reserve(TrajBuf* b, size_t extra)
+{
+    if (b->size + extra <= b->cap)
+        return 1;
+    size_t cap = b->cap ? b->cap : 4096;
+    while (cap < b->size + extra)
+        cap *= 2;
+    uint8_t* d = realloc(b->data, cap);
+    if (!d)
+        return 0;
+    b->data = d;
+    b->cap = cap;
+    return 1;
+}
+
+// explicit little-endian encoding, independent of the host
+static uint8_t* put_u32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+    return p + 4;
+}
+
+static uint8_t* put_u64(uint8_t* p, uint64_t v)
+{
+    p = put_u32(p, (uint32_t)v);
+    return put_u32(p, (uint32_t)(v >> 32));
+}
+
+static uint8_t* put_f32(uint8_t* p, float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, sizeof(v));
+    return put_u32(p, v);
+}
+
+static uint32_t get_u32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t get_u64(const uint8_t* p)
+{
+    return (uint64_t)get_u32(p) | ((uint64_t)get_u32(p + 4) << 32);
+}
+
+static float get_f32(const uint8_t* p)
+{
+    uint32_t v = get_u32(p);
+    float f;
+    memcpy(&f, &v, sizeof(f));
+    return f;
+}
+
+static void put_i32(TrajBuf* b, int32_t v)
+{
+    put_u32(b->data + b->size, (uint32_t)v);
+    b->size += 4;
+}
+
+static void put_varint(TrajBuf* b, int32_t v)
+{
+    uint32_t z = ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); // zigzag
+    while (z >= 0x80)
+    {
+        b->data[b->size++] = (uint8_t)(z | 0x80);
+        z >>= 7;
+    }
+    b->data[b->size++] = (uint8_t)z;
+}
+
+static int32_t get_varint(const uint8_t* p, uint32_t end, uint32_t* pos)
+{
+    uint32_t z = 0;
+    int shift = 0;
+    while (*pos < end && shift < 35)
+    {
+        uint8_t byte = p[(*pos)++];
+        z |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            break;
+        shift += 7;
+    }
+    return (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+}
+
+static void frame_quantize(const TrajFrame* f, int32_t q[TRAJ_FIELDS])
+{
+    const float v[TRAJ_FIELDS] = {f->pivot_x, f->theta, f->omega, f->control, f->fitness};
+    for (int k = 0; k < TRAJ_FIELDS; ++k)
+        q[k] = (int32_t)lrintf(v[k] * traj_scales[k]);
+}
+
+static void frame_from_agent(const GAAgent* a, TrajFrame* f)
+{
+    f->pivot_x = a->pivot_x;
+    f->theta = a->theta;
+    f->omega = a->omega;
+    f->control = a->last_control;
+    f->fitness = a->fitness;
+}
+
+// ---- writer ----
+
+// The block is the track header followed by the keyframe offsets; payload
+// the encoded frames. After a short write the recorder is marked failed and
+// writes nothing more, the reader drops the truncated last block.
+static void write_track(TrajRecorder* r, TrajBuf* block, TrajBuf* payload, const TrajFrame* frames, int n,
+                        uint32_t generation, int32_t agent, float fitness)
+{
+    if (n < 1 || r->failed)
+        return;
+    block->size = 0;
+    payload->size = 0;
+    uint32_t key_count = 0;
+    if (!buf_reserve(block, TRAJ_TRACK_HEADER))
+        return;
+    block->size = TRAJ_TRACK_HEADER;
+    int32_t prev[TRAJ_FIELDS] = {0};
+    for (int s = 0; s < n; ++s)
+    {
+        int32_t q[TRAJ_FIELDS];
+        frame_quantize(&frames[s], q);
+        if (!buf_reserve(payload, TRAJ_FIELDS * 5))
+            return;
+        if (s % TRAJ_KEYFRAME_INTERVAL == 0)
+        {
+            if (!buf_reserve(block, 4))
+                return;
+            put_u32(block->data + block->size, (uint32_t)payload->size);
+            block->size += 4;
+            key_count++;
+            for (int k = 0; k < TRAJ_FIELDS; ++k)
+                put_i32(payload, q[k]);
+        }
+        else
+        {
+            for (int k = 0; k < TRAJ_FIELDS; ++k)
+                put_varint(payload, q[k] - prev[k]);
+        }
+        memcpy(prev, q, sizeof(prev));
+    }
+
+    TrajTrackInfo info;
+    info.generation = generation;
+    info.agent = agent;
+    info.frames = (uint32_t)n;
+    info.fitness = fitness;
+    info.offset = r->bytes_written;
+
+    uint8_t* p = block->data;
+    p = put_u32(p, info.generation);
+    p = put_u32(p, (uint32_t)info.agent);
+    p = put_u32(p, info.frames);
+    p = put_f32(p, info.fitness);
+    p = put_u32(p, key_count);
+    put_u32(p, (uint32_t)payload->size);
+    if (fwrite(block->data, 1, block->size, r->f) != block->size
+        || fwrite(payload->data, 1, payload->size, r->f) != payload->size)
+    {
+        r->failed = 1;
+        return;
+    }
+    r->bytes_written += block->size + payload->size;
+
+    if (r->dir_count == r->dir_cap)
+    {
+        uint32_t cap = r->dir_cap ? r->dir_cap * 2 : 256;
+        TrajTrackInfo* d = realloc(r->dir, cap * sizeof(TrajTrackInfo));
+        if (!d)
+            return;
+        r->dir = d;
+        r->dir_cap = cap;
+    }
+    r->dir[r->dir_count++] = info;
+}
+
+static void* writer_thread(void* arg)
+{
+    TrajRecorder* r = (TrajRecorder*)arg;
+    trace_bind(TRACE_TRACK_RECORDER, "recorder");
+    TrajBuf block = {0};
+    TrajBuf payload = {0};
+    TrajFrame* champ = malloc((size_t)r->capacity * sizeof(TrajFrame));
+    GAAgent* states = malloc((size_t)r->capacity * sizeof(GAAgent));
+
+    pthread_mutex_lock(&r->lock);
+    for (;;)
+    {
+        while (!r->pending && !r->quit)
+            pthread_cond_wait(&r->cond, &r->lock);
+        if (!r->pending && r->quit)
+            break;
+        pthread_mutex_unlock(&r->lock);
+
+        // back buffer is owned by this thread until pending is cleared
+        unsigned long long tr = trace_begin();
+        for (int slot = 0; slot < r->slots; ++slot)
+            write_track(r, &block, &payload, &r->back[(size_t)slot * r->capacity], r->back_count[slot],
+                        (uint32_t)r->back_generation, slot * r->stride, r->back_fitness[slot]);
+        if (r->back_has_champion && champ && states)
+        {
+            // replayed with the weights it was trained with (int8 / half copies in those modes)
+            int steps = (int)ceilf(r->back_env.eval_duration / r->dt);
+            if (steps > r->capacity)
+                steps = r->capacity;
+            float fit = ga_rollout_from(&r->back_env, &r->back_champion, NULL, r->back_env.eval_mode, r->dt, steps,
+                                        states);
+            for (int s = 0; s < steps; ++s)
+                frame_from_agent(&states[s], &champ[s]);
+            write_track(r, &block, &payload, champ, steps, (uint32_t)r->back_generation, TRAJ_CHAMPION, fit);
+        }
+        unsigned long long tf = trace_begin();
+        if (fflush(r->f) != 0)
+            r->failed = 1;
+        trace_end(tf, "flush", -1);
+        trace_end(tr, "write generation", r->back_generation);
+
+        pthread_mutex_lock(&r->lock);
+        r->generations_written++;
+        r->pending = 0;
+    }
+    pthread_mutex_unlock(&r->lock);
+
+    free(block.data);
+    free(payload.data);
+    free(champ);
+    free(states);
+    return NULL;
+}
+
+TrajRecorder* traj_recorder_open(const char* path, const GAContext* ga, float dt, int stride)
+{
+    if (!path || !ga || ga->population_size < 1 || dt <= 0.f)
+        return NULL;
+    TrajRecorder* r = calloc(1, sizeof(TrajRecorder));
+    if (!r)
+        return NULL;
+    r->dt = dt;
+    r->stride = stride > 0 ? stride : 1;
+    r->slots = (ga->population_size + r->stride - 1) / r->stride;
+    r->capacity = (int)ceilf(ga->eval_duration / dt) + 2;
+    r->front = malloc((size_t)r->slots * r->capacity * sizeof(TrajFrame));
+    r->back = malloc((size_t)r->slots * r->capacity * sizeof(TrajFrame));
+    r->front_count = calloc((size_t)r->slots, sizeof(int));
+    r->back_count = calloc((size_t)r->slots, sizeof(int));
+    r->back_fitness = calloc((size_t)r->slots, sizeof(float));
+    r->f = fopen(path, "wb");
+    if (!r->front || !r->back || !r->front_count || !r->back_count || !r->back_fitness || !r->f)
+    {
+        if (r->f)
+            fclose(r->f);
+        free(r->front);
+        free(r->back);
+        free(r->front_count);
+        free(r->back_count);
+        free(r->back_fitness);
+        free(r);
+        return NULL;
+    }
+
+    uint8_t header[TRAJ_FILE_HEADER];
+    const float geom[4] = {ga->length, ga->pivot_y, ga->track_left, ga->track_width};
+    memcpy(header, TRAJ_MAGIC, 4);
+    uint8_t* p = put_u32(header + 4, TRAJ_VERSION);
+    p = put_f32(p, dt);
+    p = put_u32(p, TRAJ_KEYFRAME_INTERVAL);
+    for (int k = 0; k < TRAJ_FIELDS; ++k)
+        p = put_f32(p, traj_scales[k]);
+    for (int k = 0; k < 4; ++k)
+        p = put_f32(p, geom[k]);
+    r->bytes_written = sizeof(header);
+
+    pthread_mutex_init(&r->lock, NULL);
+    pthread_cond_init(&r->cond, NULL);
+    if (fwrite(header, 1, sizeof(header), r->f) != sizeof(header)
+        || pthread_create(&r->thread, NULL, writer_thread, r) != 0)
+    {
+        fclose(r->f);
+        r->f = NULL;
+        pthread_mutex_destroy(&r->lock);
+        pthread_cond_destroy(&r->cond);
+        free(r->front);
+        free(r->back);
+        free(r->front_count);
+        free(r->back_count);
+        free(r->back_fitness);
+        free(r);
+        return NULL;
+    }
+    return r;
+}
+
+void traj_capture(TrajRecorder* r, int agent, const GAAgent* a)
+{
+    if (agent % r->stride)
+        return;
+    int slot = agent / r->stride;
+    if (slot >= r->slots) // population grew after the recorder was opened
+        return;
+    int n = r->front_count[slot];
+    if (n >= r->capacity)
+        return;
+    frame_from_agent(a, &r->front[(size_t)slot * r->capacity + n]);
+    r->front_count[slot] = n + 1;
+}
+
+void traj_reset_generation(TrajRecorder* r)
+{
+    if (!r)
+        return;
+    memset(r->front_count, 0, (size_t)r->slots * sizeof(int));
+}
+
+// The writer re-simulates the champion with the environment of its generation.
+// Only those fields are copied: the arena, workers and other pointers of the
+// live context stay with the training threads.
+static void copy_env(GAContext* env, const GAContext* ga)
+{
+    memset(env, 0, sizeof(*env));
+    env->track_left = ga->track_left;
+    env->track_width = ga->track_width;
+    env->pivot_y = ga->pivot_y;
+    env->length = ga->length;
+    env->base_k = ga->base_k;
+    env->base_d = ga->base_d;
+    env->gravity = ga->gravity;
+    env->damping = ga->damping;
+    env->max_speed_factor = ga->max_speed_factor;
+    env->max_base_speed = ga->max_base_speed;
+    env->upright_threshold = ga->upright_threshold;
+    env->eval_duration = ga->eval_duration;
+    env->reward = ga->reward;
+    env->reward_bonus = ga->reward_bonus;
+    env->reward_drop = ga->reward_drop;
+    env->reward_effort = ga->reward_effort;
+    env->control_period = ga->control_period;
+    env->eval_mode = ga->eval_mode;
+}
+
+void traj_end_generation(TrajRecorder* r, const GAContext* ga, int champion_improved)
+{
+    if (!r || !ga)
+        return;
+    pthread_mutex_lock(&r->lock);
+    if (r->pending)
+    {
+        // writer still busy with the previous generation: drop, never stall training
+        r->generations_dropped++;
+        pthread_mutex_unlock(&r->lock);
+        traj_reset_generation(r);
+        return;
+    }
+    TrajFrame* tmp = r->front;
+    r->front = r->back;
+    r->back = tmp;
+    int* tmp_count = r->front_count;
+    r->front_count = r->back_count;
+    r->back_count = tmp_count;
+    for (int slot = 0; slot < r->slots; ++slot)
+    {
+        int agent = slot * r->stride;
+        r->back_fitness[slot] = agent < ga->population_size ? ga->agents[agent].fitness : 0.f;
+    }
+    r->back_generation = ga->generation;
+    r->back_has_champion = champion_improved && ga->has_champion;
+    r->back_champion = ga->champion;
+    copy_env(&r->back_env, ga);
+    r->pending = 1;
+    pthread_cond_signal(&r->cond);
+    pthread_mutex_unlock(&r->lock);
+    traj_reset_generation(r);
+}
+
+void traj_recorder_close(TrajRecorder* r)
+{
+    if (!r)
+        return;
+    pthread_mutex_lock(&r->lock);
+    r->quit = 1;
+    pthread_cond_signal(&r->cond);
+    pthread_mutex_unlock(&r->lock);
+    pthread_join(r->thread, NULL);
+
+    // no directory after a failed write: its offsets would not match the file,
+    // the reader walks the track blocks instead
+    if (!r->failed)
+    {
+        uint8_t buf[TRAJ_DIR_ENTRY];
+        put_u32(buf, r->dir_count);
+        int ok = fwrite(buf, 1, 4, r->f) == 4;
+        for (uint32_t i = 0; ok && i < r->dir_count; ++i)
+        {
+            const TrajTrackInfo* t = &r->dir[i];
+            uint8_t* p = put_u64(buf, t->offset);
+            p = put_u32(p, t->generation);
+            p = put_u32(p, (uint32_t)t->agent);
+            p = put_u32(p, t->frames);
+            put_f32(p, t->fitness);
+            ok = fwrite(buf, 1, sizeof(buf), r->f) == sizeof(buf);
+        }
+        put_u64(buf, r->bytes_written);
+        memcpy(buf + 8, TRAJ_DIR_MAGIC, 4);
+        if (ok)
+            fwrite(buf, 1, TRAJ_FOOTER, r->f);
+    }
+    fclose(r->f);
+
+    pthread_mutex_destroy(&r->lock);
+    pthread_cond_destroy(&r->cond);
+    free(r->front);
+    free(r->back);
+    free(r->front_count);
+    free(r->back_count);
+    free(r->back_fitness);
+    free(r->dir);
+    free(r);
+}
+
+// ---- reader ----
+
+static int read_track_header(FILE* f, TrajTrackInfo* info, uint32_t* keys, uint32_t* payload_bytes)
+{
+    uint8_t h[TRAJ_TRACK_HEADER];
+    if (fread(h, 1, sizeof(h), f) != sizeof(h))
+        return 0;
+    info->generation = get_u32(h);
+    info->agent = (int32_t)get_u32(h + 4);
+    info->frames = get_u32(h + 8);
+    info->fitness = get_f32(h + 12);
+    *keys = get_u32(h + 16);
+    *payload_bytes = get_u32(h + 20);
+    return 1;
+}
+
+static int append_info(TrajFile* tf, uint32_t* cap, const TrajTrackInfo* info)
+{
+    if (tf->track_count == *cap)
+    {
+        uint32_t c = *cap ? *cap * 2 : 256;
+        TrajTrackInfo* d = realloc(tf->tracks, c * sizeof(TrajTrackInfo));
+        if (!d)
+            return 0;
+        tf->tracks = d;
+        *cap = c;
+    }
+    tf->tracks[tf->track_count++] = *info;
+    return 1;
+}
+
+TrajFile* traj_open(const char* path)
+{
+    FILE* f = path ? fopen(path, "rb") : NULL;
+    if (!f)
+        return NULL;
+    TrajFile* tf = calloc(1, sizeof(TrajFile));
+    if (!tf)
+    {
+        fclose(f);
+        return NULL;
+    }
+    tf->f = f;
+
+    uint8_t header[TRAJ_FILE_HEADER];
+    if (fread(header, 1, sizeof(header), f) != sizeof(header) || memcmp(header, TRAJ_MAGIC, 4) != 0
+        || get_u32(header + 4) != TRAJ_VERSION || get_u32(header + 12) != TRAJ_KEYFRAME_INTERVAL)
+    {
+        traj_close(tf);
+        return NULL;
+    }
+    tf->dt = get_f32(header + 8);
+    for (int k = 0; k < TRAJ_FIELDS; ++k)
+        tf->scale[k] = get_f32(header + 16 + 4 * k);
+    const uint8_t* geom = header + 16 + 4 * TRAJ_FIELDS;
+    tf->length = get_f32(geom);
+    tf->pivot_y = get_f32(geom + 4);
+    tf->track_left = get_f32(geom + 8);
+    tf->track_width = get_f32(geom + 12);
+    long data_start = ftell(f);
+
+    // directory from the footer when the recorder was closed cleanly
+    uint32_t cap = 0;
+    uint8_t buf[TRAJ_DIR_ENTRY];
+    if (fseek(f, -TRAJ_FOOTER, SEEK_END) == 0 && fread(buf, 1, TRAJ_FOOTER, f) == TRAJ_FOOTER
+        && memcmp(buf + 8, TRAJ_DIR_MAGIC, 4) == 0 && fseek(f, (long)get_u64(buf), SEEK_SET) == 0)
+    {
+        if (fread(buf, 1, 4, f) == 4)
+        {
+            uint32_t count = get_u32(buf);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                TrajTrackInfo t;
+                if (fread(buf, 1, sizeof(buf), f) != sizeof(buf))
+                    break;
+                t.offset = get_u64(buf);
+                t.generation = get_u32(buf + 8);
+                t.agent = (int32_t)get_u32(buf + 12);
+                t.frames = get_u32(buf + 16);
+                t.fitness = get_f32(buf + 20);
+                if (!append_info(tf, &cap, &t))
+                    break;
+            }
+        }
+        return tf;
+    }
+
+    // no footer (recording interrupted): walk the track blocks
+    fseek(f, data_start, SEEK_SET);
+    for (;;)
+    {
+        TrajTrackInfo t;
+        uint32_t keys = 0, payload_bytes = 0;
+        long at = ftell(f);
+        if (!read_track_header(f, &t, &keys, &payload_bytes))
+            break;
+        t.offset = (uint64_t)at;
+        if (fseek(f, (long)keys * 4 + (long)payload_bytes, SEEK_CUR) != 0)
+            break;
+        // a truncated last block is ignored
+        long end = ftell(f);
+        fseek(f, 0, SEEK_END);
+        if (ftell(f) < end)
+            break;
+        fseek(f, end, SEEK_SET);
+        if (!append_info(tf, &cap, &t))
+            break;
+    }
+    return tf;
+}
+
+int traj_load_track(TrajFile* tf, uint32_t index, TrajTrack* out)
+{
+    if (!tf || !out || index >= tf->track_count)
+        return 0;
+    memset(out, 0, sizeof(*out));
+    if (fseek(tf->f, (long)tf->tracks[index].offset, SEEK_SET) != 0)
+        return 0;
+    if (!read_track_header(tf->f, &out->info, &out->keyframes, &out->payload_bytes))
+        return 0;
+    out->info.offset = tf->tracks[index].offset;
+    out->key_offsets = malloc(((size_t)out->keyframes + 1) * sizeof(uint32_t));
+    out->payload = malloc((size_t)out->payload_bytes + 1);
+    if (!out->key_offsets || !out->payload
+        || fread(out->key_offsets, sizeof(uint32_t), out->keyframes, tf->f) != out->keyframes
+        || fread(out->payload, 1, out->payload_bytes, tf->f) != out->payload_bytes)
+    {
+        traj_free_track(out);
+        return 0;
+    }
+    for (uint32_t k = 0; k < out->keyframes; ++k)
+        out->key_offsets[k] = get_u32((const uint8_t*)&out->key_offsets[k]);
+    return 1;
+}
+
+int traj_seek(const TrajFile* tf, const TrajTrack* t, uint32_t step, TrajFrame* out)
+{
+    if (!tf || !t || !out || t->info.frames == 0 || t->keyframes == 0)
+        return 0;
+    if (step >= t->info.frames)
+        step = t->info.frames - 1;
+    uint32_t key = step / TRAJ_KEYFRAME_INTERVAL;
+    if (key >= t->keyframes)
+        key = t->keyframes - 1;
+    uint32_t pos = t->key_offsets[key];
+    if (pos + TRAJ_FIELDS * 4 > t->payload_bytes)
+        return 0;
+
+    int32_t q[TRAJ_FIELDS];
+    for (int k = 0; k < TRAJ_FIELDS; ++k)
+        q[k] = (int32_t)get_u32(t->payload + pos + 4 * k);
+    pos += TRAJ_FIELDS * 4;
+    for (uint32_t s = key * TRAJ_KEYFRAME_INTERVAL + 1; s <= step; ++s)
+        for (int k = 0; k < TRAJ_FIELDS; ++k)
+            q[k] += get_varint(t->payload, t->payload_bytes, &pos);
+
+    out->pivot_x = (float)q[0] / tf->scale[0];
+    out->theta = (float)q[1] / tf->scale[1];
+    out->omega = (float)q[2] / tf->scale[2];
+    out->control = (float)q[3] / tf->scale[3];
+    out->fitness = (float)q[4] / tf->scale[4];
+    return 1;
+}
+
+void traj_free_track(TrajTrack* t)
+{
+    if (!t)
+        return;
+    free(t->key_offsets);
+    free(t->payload);
+    t->key_offsets = NULL;
+    t->payload = NULL;
+}
+
+void traj_close(TrajFile* tf)
+{
+    if (!tf)
+        return;
+    if (tf->f)
+        fclose(tf->f);
+    free(tf->tracks);
+    free(tf);
+}
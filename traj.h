@@ -0,0 +1,111 @@
+#pragma once
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "ga.h"
+
+// Trajectory files (.ptrj)
+//
+// header | track blocks ... | directory | footer
+//
+// All integers and floats are stored little-endian, whatever the host.
+//
+// A track is one agent over one generation (agent -1 is the champion, re-simulated
+// off the training threads). Frames are quantized to ints and stored as zigzag
+// varint deltas, with a raw keyframe every TRAJ_KEYFRAME_INTERVAL steps; each
+// track carries the byte offsets of its keyframes so any step is at most one
+// interval of decoding away.
+
+#define TRAJ_FIELDS             5
+#define TRAJ_KEYFRAME_INTERVAL  128
+#define TRAJ_CHAMPION           -1
+
+typedef struct
+{
+    float pivot_x;
+    float theta;
+    float omega;
+    float control;
+    float fitness;
+} TrajFrame;
+
+typedef struct
+{
+    uint32_t generation;
+    int32_t  agent;
+    uint32_t frames;
+    float    fitness;
+    uint64_t offset;
+} TrajTrackInfo;
+
+typedef struct
+{
+    TrajTrackInfo info;
+    uint32_t      keyframes;
+    uint32_t*     key_offsets;
+    uint8_t*      payload;
+    uint32_t      payload_bytes;
+} TrajTrack;
+
+typedef struct
+{
+    FILE*          f;
+    float          dt;
+    float          length;
+    float          pivot_y;
+    float          track_left;
+    float          track_width;
+    float          scale[TRAJ_FIELDS];
+    uint32_t       track_count;
+    TrajTrackInfo* tracks;
+} TrajFile;
+
+// Recorder: workers write raw frames of every stride-th agent into the front
+// buffer (one slot per agent, no locks). At the end of a generation the buffers
+// are swapped and a writer thread encodes the back buffer; if it is still busy
+// the generation is dropped instead of blocking training.
+typedef struct TrajRecorder
+{
+    FILE*           f;
+    float           dt;
+    int             stride;
+    int             slots;
+    int             capacity;
+    TrajFrame*      front;
+    TrajFrame*      back;
+    int*            front_count;
+    int*            back_count;
+    float*          back_fitness;
+    int             back_generation;
+    int             back_has_champion;
+    Genome          back_champion;
+    GAContext       back_env;
+
+    pthread_t       thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    int             pending;
+    int             quit;
+
+    TrajTrackInfo*  dir;
+    uint32_t        dir_count;
+    uint32_t        dir_cap;
+    uint64_t        bytes_written;
+    int             failed; // a write failed: nothing more is written, no directory
+    int             generations_written;
+    int             generations_dropped;
+} TrajRecorder;
+
+TrajRecorder* traj_recorder_open(const char* path, const GAContext* ga, float dt, int stride);
+void  traj_capture(TrajRecorder* r, int agent, const GAAgent* a);
+void  traj_reset_generation(TrajRecorder* r);
+void  traj_end_generation(TrajRecorder* r, const GAContext* ga, int champion_improved);
+void  traj_recorder_close(TrajRecorder* r);
+
+TrajFile* traj_open(const char* path);
+int   traj_load_track(TrajFile* tf, uint32_t index, TrajTrack* out);
+int   traj_seek(const TrajFile* tf, const TrajTrack* t, uint32_t step, TrajFrame* out);
+void  traj_free_track(TrajTrack* t);
+void  traj_close(TrajFile* tf);
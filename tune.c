@@ -0,0 +1,443 @@
+#include "tune.h"
+#include "trace.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TUNE_BLOCK 32 // agents per unit of work
+
+typedef struct
+{
+    GAContext ga;
+    TuneRow*  row;
+    int       blocks;
+    int       next_block; // everything below is guarded by the job lock
+    int       finished;   // blocks evaluated in the current generation
+    int       active;     // 0 once the target or the generation cap is reached
+    unsigned long long busy_ns;
+} TuneSlot;
+
+typedef struct
+{
+    const TuneConfig* cfg;
+    TuneSlot*         slots;
+    int               count;
+    int               cursor; // round-robin start for the next pick
+    int               live;
+    int               next_worker;
+    unsigned long long start_ns;
+    pthread_mutex_t   lock;
+    pthread_cond_t    wake;
+} TuneJob;
+
+static const char* const param_names[TUNE_PARAM_COUNT] = {
+    "elite", "sigma", "prob", "bonus", "drop", "effort", "duration", "period"
+};
+
+static unsigned long long now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+// worker time is CPU time: with more threads than cores, wall time would also
+// count the slices other configurations got
+static unsigned long long thread_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ull + (unsigned long long)ts.tv_nsec;
+}
+
+const char* tune_param_name(int param)
+{
+    if (param < 0 || param >= TUNE_PARAM_COUNT)
+        return "?";
+    return param_names[param];
+}
+
+static float ga_param(const GAContext* ga, int param)
+{
+    switch (param)
+    {
+        case TUNE_PARAM_ELITE:
+            return ga->elite_fraction;
+        case TUNE_PARAM_SIGMA:
+            return ga->mutation_sigma;
+        case TUNE_PARAM_PROB:
+            return ga->mutation_prob;
+        case TUNE_PARAM_BONUS:
+            return ga->reward_bonus;
+        case TUNE_PARAM_DROP:
+            return ga->reward_drop;
+        case TUNE_PARAM_EFFORT:
+            return ga->reward_effort;
+        case TUNE_PARAM_PERIOD:
+            return (float)ga->control_period;
+        case TUNE_PARAM_DURATION:
+        default:
+            return ga->eval_duration;
+    }
+}
+
+static void set_ga_param(GAContext* ga, int param, float v)
+{
+    switch (param)
+    {
+        case TUNE_PARAM_ELITE:
+            ga->elite_fraction = v;
+            break;
+        case TUNE_PARAM_SIGMA:
+            ga->mutation_sigma = v;
+            break;
+        case TUNE_PARAM_PROB:
+            ga->mutation_prob = v;
+            break;
+        case TUNE_PARAM_BONUS:
+            ga->reward_bonus = v;
+            break;
+        case TUNE_PARAM_DROP:
+            ga->reward_drop = v;
+            break;
+        case TUNE_PARAM_EFFORT:
+            ga->reward_effort = v;
+            break;
+        case TUNE_PARAM_PERIOD:
+            ga_set_control_period(ga, (int)(v + 0.5f));
+            break;
+        case TUNE_PARAM_DURATION:
+        default:
+            ga->eval_duration = v;
+            break;
+    }
+}
+
+void tune_default_config(const GAContext* ga, TuneConfig* cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    for (int p = 0; p < TUNE_PARAM_COUNT; ++p)
+    {
+        cfg->count[p] = 1;
+        cfg->values[p][0] = ga_param(ga, p);
+    }
+    cfg->population = 200;
+    cfg->max_generations = 50;
+    cfg->target = ga->eval_duration * 0.5f; // upright half of the episode
+    cfg->dt = 1.f / 120.f;
+    cfg->threads = GA_THREAD_COUNT;
+}
+
+int tune_parse_grid(TuneConfig* cfg, const char* spec)
+{
+    if (!cfg || !spec)
+        return 0;
+    const char* s = spec;
+    while (*s)
+    {
+        while (*s == ';' || *s == ' ')
+            s++;
+        if (!*s)
+            break;
+        const char* eq = strchr(s, '=');
+        if (!eq)
+            return 0;
+        int param = -1;
+        for (int p = 0; p < TUNE_PARAM_COUNT; ++p)
+        {
+            size_t n = strlen(param_names[p]);
+            if ((size_t)(eq - s) == n && strncmp(s, param_names[p], n) == 0)
+                param = p;
+        }
+        if (param < 0)
+            return 0;
+        int count = 0;
+        s = eq + 1;
+        for (;;)
+        {
+            char* end;
+            float v = strtof(s, &end);
+            if (end == s || count >= TUNE_MAX_VALUES)
+                return 0;
+            cfg->values[param][count++] = v;
+            s = end;
+            if (*s != ',')
+                break;
+            s++;
+        }
+        cfg->count[param] = count;
+        if (*s && *s != ';')
+            return 0;
+    }
+    return 1;
+}
+
+static void close_slot(TuneJob* job, TuneSlot* s, unsigned long long now)
+{
+    s->active = 0;
+    job->live--;
+    if (s->row->reached < 0)
+    {
+        s->row->wall_seconds = (double)(now - job->start_ns) * 1e-9;
+        s->row->cpu_seconds = (double)s->busy_ns * 1e-9;
+    }
+}
+
+// next block round-robin over the configurations that have one; called locked
+static TuneSlot* pick_slot(TuneJob* job)
+{
+    for (int k = 0; k < job->count; ++k)
+    {
+        int i = (job->cursor + k) % job->count;
+        TuneSlot* s = &job->slots[i];
+        if (s->active && s->next_block < s->blocks)
+        {
+            job->cursor = i + 1;
+            return s;
+        }
+    }
+    return NULL;
+}
+
+static void* tune_worker(void* arg)
+{
+    TuneJob* job = (TuneJob*)arg;
+    const TuneConfig* cfg = job->cfg;
+    pthread_mutex_lock(&job->lock);
+    trace_bind(TRACE_TRACK_WORKER + job->next_worker++, "tune");
+    for (;;)
+    {
+        TuneSlot* s = pick_slot(job);
+        if (!s)
+        {
+            if (!job->live)
+                break;
+            // every remaining configuration is closing a generation on another worker
+            pthread_cond_wait(&job->wake, &job->lock);
+            continue;
+        }
+        int block = s->next_block++;
+        pthread_mutex_unlock(&job->lock);
+
+        int start = block * TUNE_BLOCK;
+        int end = start + TUNE_BLOCK;
+        if (end > s->ga.population_size)
+            end = s->ga.population_size;
+        unsigned long long tr = trace_begin();
+        unsigned long long c0 = thread_ns();
+        ga_eval_range(&s->ga, start, end, cfg->dt, (int)(s->ga.eval_duration / cfg->dt + 0.999f));
+        unsigned long long c1 = thread_ns();
+        trace_end(tr, "block", (int)(s - job->slots));
+
+        pthread_mutex_lock(&job->lock);
+        s->busy_ns += c1 - c0;
+        if (++s->finished < s->blocks)
+            continue;
+
+        // last block of the generation: nobody else touches this configuration now
+        pthread_mutex_unlock(&job->lock);
+        ga_end_generation(&s->ga);
+        unsigned long long c2 = thread_ns();
+        unsigned long long t2 = now_ns();
+        pthread_mutex_lock(&job->lock);
+        s->busy_ns += c2 - c1;
+        TuneRow* row = s->row;
+        row->generations = s->ga.generation;
+        row->best = s->ga.best_fitness;
+        if (row->reached < 0 && row->best >= cfg->target)
+        {
+            row->reached = s->ga.generation;
+            row->wall_seconds = (double)(t2 - job->start_ns) * 1e-9;
+            row->cpu_seconds = (double)s->busy_ns * 1e-9;
+        }
+        if (row->reached >= 0 || s->ga.generation >= cfg->max_generations)
+        {
+            close_slot(job, s, t2);
+        }
+        else
+        {
+            s->next_block = 0;
+            s->finished = 0;
+        }
+        pthread_cond_broadcast(&job->wake);
+    }
+    pthread_mutex_unlock(&job->lock);
+    return NULL;
+}
+
+int tune_run(const GAContext* ga, const TuneConfig* cfg, TuneResult* out)
+{
+    if (!out)
+        return 0;
+    memset(out, 0, sizeof(*out));
+    if (!ga || !cfg || cfg->population < 2 || cfg->max_generations < 1 || cfg->dt <= 0.f)
+        return 0;
+    int rows = 1;
+    for (int p = 0; p < TUNE_PARAM_COUNT; ++p)
+    {
+        if (cfg->count[p] < 1 || cfg->count[p] > TUNE_MAX_VALUES)
+            return 0;
+        rows *= cfg->count[p];
+    }
+    out->row = calloc((size_t)rows, sizeof(TuneRow));
+    TuneSlot* slots = calloc((size_t)rows, sizeof(TuneSlot));
+    if (!out->row || !slots)
+    {
+        free(slots);
+        tune_free(out);
+        return 0;
+    }
+    out->rows = rows;
+
+    int ready = 0;
+    for (int r = 0; r < rows; ++r)
+    {
+        TuneSlot* s = &slots[r];
+        TuneRow* row = &out->row[r];
+        ga_init(&s->ga, cfg->population);
+        if (!s->ga.population)
+            break;
+        ready++;
+        ga_set_env(&s->ga, ga->track_left, ga->track_width, ga->pivot_y, ga->length, ga->base_k, ga->base_d,
+                   ga->gravity, ga->damping, ga->max_speed_factor, ga->max_base_speed, ga->upright_threshold);
+        s->ga.reward = ga->reward;
+        s->ga.allow_remove_nodes = ga->allow_remove_nodes;
+        // row-major over the axes, the last axis varies fastest
+        int idx = r;
+        for (int p = TUNE_PARAM_COUNT - 1; p >= 0; --p)
+        {
+            row->params[p] = cfg->values[p][idx % cfg->count[p]];
+            idx /= cfg->count[p];
+            set_ga_param(&s->ga, p, row->params[p]);
+        }
+        row->reached = -1;
+        row->best = -1e9f;
+        ga_start(&s->ga);
+        s->row = row;
+        s->blocks = (s->ga.population_size + TUNE_BLOCK - 1) / TUNE_BLOCK;
+        s->active = 1;
+    }
+    if (ready < rows)
+    {
+        for (int r = 0; r < ready; ++r)
+            ga_free(&slots[r].ga);
+        free(slots);
+        tune_free(out);
+        return 0;
+    }
+
+    TuneJob job;
+    job.cfg = cfg;
+    job.slots = slots;
+    job.count = rows;
+    job.cursor = 0;
+    job.live = rows;
+    job.next_worker = 0;
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.wake, NULL);
+
+    int threads = cfg->threads > 0 ? cfg->threads : 1;
+    if (threads > GA_THREAD_COUNT)
+        threads = GA_THREAD_COUNT;
+    pthread_t tids[GA_THREAD_COUNT];
+    job.start_ns = now_ns();
+    // this thread is worker 0, so the grid runs even when no thread starts
+    int started = 0;
+    for (int t = 1; t < threads; ++t)
+    {
+        if (pthread_create(&tids[started], NULL, tune_worker, &job) != 0)
+            break;
+        started++;
+    }
+    tune_worker(&job);
+    trace_bind(TRACE_TRACK_MAIN, "main");
+    for (int t = 0; t < started; ++t)
+        pthread_join(tids[t], NULL);
+    out->seconds = (double)(now_ns() - job.start_ns) * 1e-9;
+    out->threads = started + 1;
+
+    pthread_cond_destroy(&job.wake);
+    pthread_mutex_destroy(&job.lock);
+    for (int r = 0; r < rows; ++r)
+        ga_free(&slots[r].ga);
+    free(slots);
+    return 1;
+}
+
+static int cmp_time_to_target(const void* a, const void* b)
+{
+    const TuneRow* ra = *(const TuneRow* const*)a;
+    const TuneRow* rb = *(const TuneRow* const*)b;
+    if ((ra->reached >= 0) != (rb->reached >= 0))
+        return ra->reached >= 0 ? -1 : 1;
+    if (ra->reached >= 0)
+        return (ra->cpu_seconds > rb->cpu_seconds) - (ra->cpu_seconds < rb->cpu_seconds);
+    return (ra->best < rb->best) - (ra->best > rb->best);
+}
+
+// sorted by time to target (worker seconds), then by best fitness for the others
+void tune_print(const TuneConfig* cfg, const TuneResult* r)
+{
+    printf("[TUNE] %d configurations x %d genomes, target %.2f within %d generations: %.2fs on %d threads\n", r->rows,
+           cfg->population, cfg->target, cfg->max_generations, r->seconds, r->threads);
+    const TuneRow** order = malloc((size_t)r->rows * sizeof(TuneRow*));
+    if (!order)
+        return;
+    for (int i = 0; i < r->rows; ++i)
+        order[i] = &r->row[i];
+    qsort(order, (size_t)r->rows, sizeof(TuneRow*), cmp_time_to_target);
+
+    printf("[TUNE]");
+    for (int p = 0; p < TUNE_PARAM_COUNT; ++p)
+        printf(" %8s", param_names[p]);
+    printf(" | %7s %5s %8s %8s %8s\n", "reached", "gens", "best", "wall_s", "cpu_s");
+    for (int i = 0; i < r->rows; ++i)
+    {
+        const TuneRow* row = order[i];
+        char reached[16] = "-";
+        if (row->reached >= 0)
+            snprintf(reached, sizeof(reached), "%d", row->reached);
+        printf("[TUNE]");
+        for (int p = 0; p < TUNE_PARAM_COUNT; ++p)
+            printf(" %8.3g", row->params[p]);
+        printf(" | %7s %5d %8.2f %8.2f %8.2f\n", reached, row->generations, row->best, row->wall_seconds,
+               row->cpu_seconds);
+    }
+    free(order);
+    fflush(stdout);
+}
+
+int tune_write_csv(const TuneResult* r, const TuneConfig* cfg, const char* path)
+{
+    if (!r || !cfg || !path || !r->row)
+        return 0;
+    FILE* f = fopen(path, "w");
+    if (!f)
+        return 0;
+    fprintf(f, "# hyperparameter sweep population=%d target=%g max_generations=%d threads=%d seconds=%.3f\n",
+            cfg->population, cfg->target, cfg->max_generations, r->threads, r->seconds);
+    for (int p = 0; p < TUNE_PARAM_COUNT; ++p)
+        fprintf(f, "%s,", param_names[p]);
+    fprintf(f, "reached,generations,best,wall_seconds,cpu_seconds\n");
+    for (int i = 0; i < r->rows; ++i)
+    {
+        const TuneRow* row = &r->row[i];
+        for (int p = 0; p < TUNE_PARAM_COUNT; ++p)
+            fprintf(f, "%g,", row->params[p]);
+        fprintf(f, "%d,%d,%.4f,%.4f,%.4f\n", row->reached, row->generations, row->best, row->wall_seconds,
+                row->cpu_seconds);
+    }
+    fclose(f);
+    return 1;
+}
+
+void tune_free(TuneResult* r)
+{
+    if (!r)
+        return;
+    free(r->row);
+    memset(r, 0, sizeof(*r));
+}
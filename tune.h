@@ -0,0 +1,62 @@
+#pragma once
+
+#include "ga.h"
+
+// Hyperparameter sweep: every point of a grid is an independent GA
+// (its own GAContext), all of them trained at once on one shared worker pool.
+// The unit of work is a block of agents of one configuration's current
+// generation; workers take blocks round-robin across the configurations that
+// have work, so every configuration advances at the same rate whatever its
+// population size. The worker that finishes the last block of a generation
+// runs its SELECT/MUTATE, the others move on to the other configurations.
+// A configuration stops at `target` fitness or after `max_generations`.
+
+#define TUNE_PARAM_ELITE    0
+#define TUNE_PARAM_SIGMA    1
+#define TUNE_PARAM_PROB     2
+#define TUNE_PARAM_BONUS    3
+#define TUNE_PARAM_DROP     4
+#define TUNE_PARAM_EFFORT   5
+#define TUNE_PARAM_DURATION 6
+#define TUNE_PARAM_PERIOD   7
+#define TUNE_PARAM_COUNT    8
+
+#define TUNE_MAX_VALUES 16
+
+typedef struct
+{
+    int      count[TUNE_PARAM_COUNT];  // values on each axis, 1 = the default of ga_init
+    float    values[TUNE_PARAM_COUNT][TUNE_MAX_VALUES];
+    int      population;
+    int      max_generations;
+    float    target;
+    float    dt;
+    int      threads;
+} TuneConfig;
+
+typedef struct
+{
+    float  params[TUNE_PARAM_COUNT];
+    int    generations;
+    int    reached;       // generation that first reached the target, -1: never
+    float  best;
+    double wall_seconds;  // from the start of the sweep to the target (or the end)
+    double cpu_seconds;   // worker CPU time spent on this configuration until then
+} TuneRow;
+
+typedef struct
+{
+    int      rows;
+    TuneRow* row;
+    int      threads;
+    double   seconds;
+} TuneResult;
+
+const char* tune_param_name(int param);
+void  tune_default_config(const GAContext* ga, TuneConfig* cfg);
+// "elite=0.2,0.3;sigma=0.1,0.25;duration=10,15": replaces the listed axes
+int   tune_parse_grid(TuneConfig* cfg, const char* spec);
+int   tune_run(const GAContext* ga, const TuneConfig* cfg, TuneResult* out);
+void  tune_print(const TuneConfig* cfg, const TuneResult* r);
+int   tune_write_csv(const TuneResult* r, const TuneConfig* cfg, const char* path);
+void  tune_free(TuneResult* r);
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// Branchless float sin/cos/tanh for the SoA lane kernels (sweep.c, env.c).
+// libm's sinf/cosf/tanhf are calls, so a lane loop that uses them never
+// vectorizes (libmvec would need -ffast-math). These are straight-line
+// polynomials and selects instead. They are not libm: a lane rollout drifts
+// from the reference rollout (libm) like any chaotic trajectory, and --check
+// bounds that drift. Error: sin/cos <= 2 ulp for |x| < 1e4, tanh within 1e-7.
+
+#ifndef GA_ALWAYS_INLINE
+#if defined(__GNUC__)
+#define GA_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define GA_ALWAYS_INLINE inline
+#endif
+#endif
+
+static GA_ALWAYS_INLINE void vmath_sincosf(float x, float* s, float* c)
+{
+    // nearest quadrant by the 1.5 * 2^23 rounding trick, then x - k * pi/2 in
+    // three parts (Cody-Waite) so the reduction stays exact for large k
+    float k = (x * 0.636619772f + 12582912.f) - 12582912.f;
+    int q = (int)k;
+    float r = x - k * 1.5703125f;
+    r = r - k * 4.837512969970703125e-4f;
+    r = r - k * 7.549789948768648e-8f;
+
+    // minimax polynomials on [-pi/4, pi/4] (Cephes)
+    float z = r * r;
+    float sp = r + r * z * (-1.6666654611e-1f + z * (8.3321608736e-3f + z * -1.9515295891e-4f));
+    float cp = 1.f - 0.5f * z + z * z * (4.166664568298827e-2f + z * (-1.388731625493765e-3f + z * 2.443315711809948e-5f));
+
+    float sv = (q & 1) ? cp : sp;
+    float cv = (q & 1) ? sp : cp;
+    *s = (q & 2) ? -sv : sv;
+    *c = ((q + 1) & 2) ? -cv : cv;
+}
+
+static GA_ALWAYS_INLINE float vmath_sinf(float x)
+{
+    float s, c;
+    vmath_sincosf(x, &s, &c);
+    return s;
+}
+
+static GA_ALWAYS_INLINE float vmath_cosf(float x)
+{
+    float s, c;
+    vmath_sincosf(x, &s, &c);
+    return c;
+}
+
+static GA_ALWAYS_INLINE float vmath_tanhf(float x)
+{
+    float a = x < 0.f ? -x : x;
+    a = a > 9.f ? 9.f : a; // tanh(9) rounds to 1
+
+    // exp(-2a) = 2^n * p(r), n in [-26, 0]
+    float t = -2.f * a;
+    float n = (t * 1.44269504f + 12582912.f) - 12582912.f;
+    float r = t - n * 0.693359375f;
+    r = r + n * 2.12194440e-4f;
+    float p = 1.f + r + r * r * (5.0000001201e-1f + r * (1.6666665459e-1f + r * (4.1665795894e-2f
+              + r * (8.3334519073e-3f + r * (1.3981999507e-3f + r * 1.9875691500e-4f)))));
+    int32_t bits = ((int32_t)n + 127) << 23;
+    float scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    float e = p * scale;
+    float big = (1.f - e) / (1.f + e);
+
+    // below 0.625 the quotient cancels; odd polynomial instead (Cephes)
+    float z = x * x;
+    float small = x + x * z * (-3.33332819422e-1f + z * (1.33314422036e-1f + z * (-5.37397155531e-2f
+                  + z * (2.06390887954e-2f + z * -5.70498872745e-3f))));
+
+    big = x < 0.f ? -big : big;
+    return a < 0.625f ? small : big;
+}